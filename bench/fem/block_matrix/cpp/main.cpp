@@ -0,0 +1,82 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Description: Benchmark of matrix assembly and matrix-vector
+// products with scalar, block (global parameter
+// "matrix_block_storage") and symmetric block (PETSc matrix type
+// "sbaij") matrix storage for P2 elasticity.
+
+#include <dolfin.h>
+#include "Elasticity.h"
+
+using namespace dolfin;
+
+#define SIZE 12
+#define NUM_REPS 20
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+
+  auto mesh = std::make_shared<UnitCubeMesh>(SIZE, SIZE, SIZE);
+  auto V = std::make_shared<Elasticity::FunctionSpace>(mesh);
+  Elasticity::BilinearForm a(V, V);
+  info("Assembling P2 elasticity operator on unit cube of size %d x %d x %d (%ld dofs)",
+       SIZE, SIZE, SIZE, (long) V->dim());
+
+  for (std::string storage : {"scalar", "block", "symmetric_block"})
+  {
+    // Symmetric block storage is requested for the matrix through
+    // the options database, since it is only valid for symmetric
+    // forms
+    parameters["matrix_block_storage"]
+      = storage == "scalar" ? "scalar" : "block";
+    PETScMatrix A;
+    if (storage == "symmetric_block")
+    {
+      A.set_options_prefix("symmetric_");
+      PETScOptions::set("symmetric_mat_type", "sbaij");
+    }
+
+    // Assemble matrix (twice, the second time reusing the matrix)
+    Timer t0;
+    assemble(A, a);
+    const double t_assemble = t0.stop();
+    Timer t1;
+    assemble(A, a);
+    const double t_reassemble = t1.stop();
+
+    PETScVector x, y;
+    A.init_vector(x, 1);
+    A.init_vector(y, 0);
+    x = 1.0;
+
+    // Matrix-vector products
+    A.mult(x, y);
+    Timer t2;
+    for (int i = 0; i < NUM_REPS; i++)
+      A.mult(x, y);
+    const double t_spmv = t2.stop()/NUM_REPS;
+
+    info("BENCH block_matrix %s assemble=%g reassemble=%g nnz=%ld",
+         storage.c_str(), t_assemble, t_reassemble, (long) A.nnz());
+    info("BENCH block_matrix %s spmv=%g norm=%g", storage.c_str(), t_spmv,
+         y.norm("l2"));
+  }
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Description: Weak scaling benchmark for construction of
+// distributed dofmaps. The number of cells per process is fixed.
+// The dofmap communication pattern can be set on the command line,
+// e.g. --dofmap_communication global (default: neighbourhood).
+
+#include <cmath>
+#include <sys/resource.h>
+#include <dolfin.h>
+#include "P2.h"
+
+using namespace dolfin;
+
+// Number of cells per process is approximately 6*SIZE^3
+#define SIZE 32
+#define NUM_REPS 3
+
+// Peak resident set size of this process (MB)
+double peak_rss()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss/1024.0;
+}
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+
+  const std::size_t num_processes = dolfin::MPI::size(MPI_COMM_WORLD);
+  const std::size_t n = std::round(SIZE*std::cbrt((double) num_processes));
+  const std::string comm = parameters["dofmap_communication"];
+  info("Building P2 dofmap on unit cube of size %ld x %ld x %ld (%s communication)",
+       (long) n, (long) n, (long) n, comm.c_str());
+
+  auto mesh = std::make_shared<UnitCubeMesh>(n, n, n);
+  const double rss_mesh = peak_rss();
+
+  // Build dofmap (topology is computed once, in the first build)
+  std::size_t num_dofs = 0;
+  double time = 0.0;
+  for (int i = 0; i < NUM_REPS + 1; i++)
+  {
+    dolfin::MPI::barrier(MPI_COMM_WORLD);
+    Timer t;
+    P2::FunctionSpace V(mesh);
+    const double t_build = t.stop();
+    if (i > 0)
+      time += t_build;
+    num_dofs = V.dim();
+  }
+  time = dolfin::MPI::max(MPI_COMM_WORLD, time/NUM_REPS);
+
+  const double rss = peak_rss();
+  const double rss_max = dolfin::MPI::max(MPI_COMM_WORLD, rss);
+  const double rss_avg = dolfin::MPI::sum(MPI_COMM_WORLD, rss)/num_processes;
+  const double rss_dofmap = dolfin::MPI::max(MPI_COMM_WORLD, rss - rss_mesh);
+
+  info("BENCH dofmap_build processes=%ld dofs=%ld time=%g",
+       (long) num_processes, (long) num_dofs, time);
+  info("BENCH dofmap_build peak_rss_max=%g peak_rss_avg=%g dofmap_rss_max=%g (MB)",
+       rss_max, rss_avg, rss_dofmap);
+
+  return 0;
+}
@@ -0,0 +1,84 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Description: Benchmark of matrix-free operator application
+// (MatrixFreeOperator) against assembled sparse matrix-vector
+// products for the P3 Poisson operator.
+
+#include <dolfin.h>
+#include "Poisson.h"
+
+using namespace dolfin;
+
+#define SIZE 16
+#define NUM_REPS 20
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+
+  auto mesh = std::make_shared<UnitCubeMesh>(SIZE, SIZE, SIZE);
+  auto V = std::make_shared<Poisson::FunctionSpace>(mesh);
+  auto a = std::make_shared<Poisson::BilinearForm>(V, V);
+  auto L = std::make_shared<Poisson::LinearForm>(V);
+  auto w = std::make_shared<Function>(V);
+  L->w = w;
+  info("Applying P3 Poisson operator on unit cube of size %d x %d x %d (%d dofs)",
+       SIZE, SIZE, SIZE, V->dim());
+
+  // Assemble matrix
+  Timer t0;
+  Matrix A;
+  assemble(A, *a);
+  const double t_assemble = t0.stop();
+
+  // Create matrix-free operator
+  MatrixFreeOperator O(L, w, a);
+
+  Vector x, y, z;
+  A.init_vector(x, 1);
+  A.init_vector(y, 0);
+  x = 1.0;
+
+  // Assembled matrix-vector products
+  Timer t1;
+  for (int i = 0; i < NUM_REPS; i++)
+    A.mult(x, y);
+  const double t_spmv = t1.stop()/NUM_REPS;
+
+  // Matrix-free products (the first product initialises z and packs
+  // the mesh geometry)
+  O.mult(x, z);
+  Timer t2;
+  for (int i = 0; i < NUM_REPS; i++)
+    O.mult(x, z);
+  const double t_mf = t2.stop()/NUM_REPS;
+
+  // Diagonal for Jacobi preconditioning
+  Timer t3;
+  O.get_diagonal(z);
+  const double t_diagonal = t3.stop();
+
+  const double dofs = V->dim();
+  info("BENCH matrix_free assemble=%g nnz=%d", t_assemble, A.nnz());
+  info("BENCH matrix_free spmv=%g (%g Mdofs/s)", t_spmv, dofs/t_spmv/1.0e6);
+  info("BENCH matrix_free matrix_free=%g (%g Mdofs/s)", t_mf,
+       dofs/t_mf/1.0e6);
+  info("BENCH matrix_free diagonal=%g", t_diagonal);
+
+  return 0;
+}
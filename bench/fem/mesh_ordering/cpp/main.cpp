@@ -0,0 +1,111 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+// Description: Benchmark for assembly on meshes with cells and
+// vertices in random order and after renumbering along a Hilbert
+// curve (with dofs numbered in cell order).
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <dolfin.h>
+#include "Poisson3D.h"
+
+using namespace dolfin;
+
+#define SIZE 48
+#define NUM_REPS 5
+
+// Renumber cells and vertices of mesh randomly, as a model of a mesh
+// with poor locality (e.g. as read from file or partitioned)
+std::shared_ptr<Mesh> shuffle(const Mesh& mesh)
+{
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  std::mt19937 engine(1);
+
+  std::vector<std::size_t> vertex_order(mesh.num_vertices());
+  std::iota(vertex_order.begin(), vertex_order.end(), 0);
+  std::shuffle(vertex_order.begin(), vertex_order.end(), engine);
+  std::vector<std::size_t> new_vertex_indices(mesh.num_vertices());
+  for (std::size_t i = 0; i < vertex_order.size(); ++i)
+    new_vertex_indices[vertex_order[i]] = i;
+
+  std::vector<std::size_t> cell_order(mesh.num_cells());
+  std::iota(cell_order.begin(), cell_order.end(), 0);
+  std::shuffle(cell_order.begin(), cell_order.end(), engine);
+
+  auto new_mesh = std::make_shared<Mesh>();
+  MeshEditor editor;
+  editor.open(*new_mesh, mesh.type().cell_type(), tdim, gdim);
+  editor.init_vertices(mesh.num_vertices());
+  for (std::size_t i = 0; i < vertex_order.size(); ++i)
+    editor.add_vertex(i, Vertex(mesh, vertex_order[i]).point());
+  editor.init_cells(mesh.num_cells());
+  std::vector<std::size_t> vertices(mesh.type().num_vertices());
+  for (std::size_t i = 0; i < cell_order.size(); ++i)
+  {
+    const Cell cell(mesh, cell_order[i]);
+    for (std::size_t j = 0; j < vertices.size(); ++j)
+      vertices[j] = new_vertex_indices[cell.entities(0)[j]];
+    editor.add_cell(i, vertices);
+  }
+  editor.close();
+
+  return new_mesh;
+}
+
+// Time reassembly of Poisson matrix
+double bench_assembly(std::shared_ptr<const Mesh> mesh)
+{
+  auto V = std::make_shared<Poisson3D::FunctionSpace>(mesh);
+  Poisson3D::BilinearForm a(V, V);
+  Matrix A;
+  assemble(A, a);
+
+  Timer t;
+  for (int i = 0; i < NUM_REPS; i++)
+    assemble(A, a);
+  return t.stop()/NUM_REPS;
+}
+
+int main(int argc, char* argv[])
+{
+  not_working_in_parallel("Mesh ordering benchmark");
+  parameters.parse(argc, argv);
+
+  info("Assembly of Poisson matrix on unit cube of size %d x %d x %d",
+       SIZE, SIZE, SIZE);
+
+  const UnitCubeMesh unit_cube(SIZE, SIZE, SIZE);
+  auto mesh = shuffle(unit_cube);
+  const double t0 = bench_assembly(mesh);
+  info("BENCH random %g", t0);
+
+  Timer t;
+  auto hilbert_mesh
+    = std::make_shared<Mesh>(mesh->renumber_by_hilbert_curve());
+  info("Renumbering time: %g", t.stop());
+
+  const double t1 = bench_assembly(hilbert_mesh);
+  info("BENCH hilbert %g", t1);
+
+  parameters["dof_ordering_library"] = "cell_order";
+  const double t2 = bench_assembly(hilbert_mesh);
+  info("BENCH hilbert-cell_order %g", t2);
+
+  return 0;
+}
@@ -0,0 +1,119 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// Description: Benchmark of Krylov solves in double precision and in
+// mixed precision (Krylov solver parameter "precision", Eigen
+// backend) for Poisson and elasticity. For each relative tolerance,
+// the solve time and the error against a reference (LU) solution are
+// printed, giving error-versus-time data for both precisions.
+
+#include <dolfin.h>
+#include "Poisson.h"
+#include "Elasticity.h"
+
+using namespace dolfin;
+
+#define SIZE_POISSON 24
+#define SIZE_ELASTICITY 12
+
+namespace
+{
+  // Boundary x = 0
+  class Left : public SubDomain
+  {
+    bool inside(const Array<double>& x, bool on_boundary) const
+    { return on_boundary && x[0] < DOLFIN_EPS; }
+  };
+
+  // Solve with CG in double and mixed precision for a range of
+  // tolerances and report time and error
+  void bench_solve(std::string problem, const Matrix& A, const Vector& b)
+  {
+    // Reference solution
+    Vector x_ref;
+    LUSolver lu;
+    lu.solve(A, x_ref, b);
+    const double x_ref_norm = x_ref.norm("l2");
+
+    for (std::string precision : {"double", "mixed"})
+    {
+      for (double rtol : {1.0e-4, 1.0e-6, 1.0e-8, 1.0e-10, 1.0e-12})
+      {
+        KrylovSolver solver("cg", "jacobi");
+        solver.parameters["precision"] = precision;
+        solver.parameters["relative_tolerance"] = rtol;
+
+        Vector x;
+        Timer t;
+        const std::size_t num_iterations = solver.solve(A, x, b);
+        const double time = t.stop();
+
+        x.axpy(-1.0, x_ref);
+        info("BENCH mixed_precision %s %s rtol=%g time=%g iterations=%ld error=%g",
+             problem.c_str(), precision.c_str(), rtol, time,
+             (long) num_iterations, x.norm("l2")/x_ref_norm);
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  parameters.parse(argc, argv);
+  parameters["linear_algebra_backend"] = "Eigen";
+
+  auto left = std::make_shared<Left>();
+
+  // Poisson
+  {
+    auto mesh = std::make_shared<UnitCubeMesh>(SIZE_POISSON, SIZE_POISSON,
+                                               SIZE_POISSON);
+    auto V = std::make_shared<Poisson::FunctionSpace>(mesh);
+    Poisson::BilinearForm a(V, V);
+    Poisson::LinearForm L(V);
+    auto bc = std::make_shared<DirichletBC>(V, std::make_shared<Constant>(0.0),
+                                            left);
+    info("Solving P1 Poisson on unit cube of size %d x %d x %d (%ld dofs)",
+         SIZE_POISSON, SIZE_POISSON, SIZE_POISSON, (long) V->dim());
+
+    Matrix A;
+    Vector b;
+    assemble_system(A, b, a, L, {bc});
+    bench_solve("poisson", A, b);
+  }
+
+  // Elasticity
+  {
+    auto mesh = std::make_shared<UnitCubeMesh>(SIZE_ELASTICITY,
+                                               SIZE_ELASTICITY,
+                                               SIZE_ELASTICITY);
+    auto V = std::make_shared<Elasticity::FunctionSpace>(mesh);
+    Elasticity::BilinearForm a(V, V);
+    Elasticity::LinearForm L(V);
+    auto zero = std::make_shared<Constant>(0.0, 0.0, 0.0);
+    auto bc = std::make_shared<DirichletBC>(V, zero, left);
+    info("Solving P1 elasticity on unit cube of size %d x %d x %d (%ld dofs)",
+         SIZE_ELASTICITY, SIZE_ELASTICITY, SIZE_ELASTICITY, (long) V->dim());
+
+    Matrix A;
+    Vector b;
+    assemble_system(A, b, a, L, {bc});
+    bench_solve("elasticity", A, b);
+  }
+
+  return 0;
+}
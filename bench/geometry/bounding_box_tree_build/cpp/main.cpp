@@ -16,10 +16,11 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // This benchmark measures the performance of building a BoundingBoxTree (and
-// one call to compute_entities, which is dominated by building).
+// one call to compute_entities, which is dominated by building), and of
+// building a WideBoundingBoxTree.
 //
 // First added:  2013-04-18
-// Last changed: 2013-06-25
+// Last changed: 2018-10-16
 
 #include <vector>
 #include <dolfin.h>
@@ -42,5 +43,11 @@ int main(int argc, char* argv[])
   tree.build(mesh);
   info("BENCH %g", toc());
 
+  // Create and build wide tree
+  tic();
+  WideBoundingBoxTree wide_tree;
+  wide_tree.build(mesh);
+  info("BENCH WideBoundingBoxTree %g", toc());
+
   return 0;
 }
@@ -15,10 +15,11 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
-// This benchmark measures the performance of compute_entity_collisions.
+// This benchmark measures the performance of compute_entity_collisions
+// for BoundingBoxTree and WideBoundingBoxTree.
 //
 // First added:  2013-05-23
-// Last changed: 2013-09-04
+// Last changed: 2018-10-16
 
 #include <vector>
 #include <dolfin.h>
@@ -28,16 +29,11 @@ using namespace dolfin;
 #define NUM_REPS 5000000
 #define SIZE 64
 
-int main(int argc, char* argv[])
+template<typename Tree>
+double bench(const Mesh& mesh)
 {
-  info("Compute entity collisions on UnitCubeMesh(%d, %d, %d)",
-       SIZE, SIZE, SIZE);
-
-  // Create mesh
-  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
-
   // First call
-  BoundingBoxTree tree;
+  Tree tree;
   tree.build(mesh);
   Point point(0.0, 0.0, 0.0);
   tree.compute_entity_collisions(point);
@@ -51,10 +47,23 @@ int main(int argc, char* argv[])
     point.coordinates()[2] += 1.0 / static_cast<double>(NUM_REPS);
     std::vector<unsigned int> entities = tree.compute_entity_collisions(point);
   }
-  const double t = toc();
+  return toc();
+}
+
+int main(int argc, char* argv[])
+{
+  info("Compute entity collisions on UnitCubeMesh(%d, %d, %d)",
+       SIZE, SIZE, SIZE);
+
+  // Create mesh
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+
+  const double t = bench<BoundingBoxTree>(mesh);
+  const double t_wide = bench<WideBoundingBoxTree>(mesh);
 
   // Report result
   info("BENCH %g", t);
+  info("BENCH WideBoundingBoxTree %g", t_wide);
 
   return 0;
 }
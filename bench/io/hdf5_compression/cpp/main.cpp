@@ -0,0 +1,79 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+//
+// This benchmark measures write bandwidth and file size of HDF5File
+// for the supported compression filters.
+
+#include <cmath>
+#include <boost/filesystem.hpp>
+#include <dolfin.h>
+
+using namespace dolfin;
+
+#define SIZE 64
+
+int main(int argc, char* argv[])
+{
+  info("Write UnitCubeMesh(%d, %d, %d) and vector to HDF5", SIZE, SIZE, SIZE);
+
+  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+
+  // Smooth data, one value per vertex
+  const std::size_t num_values = mesh.num_entities_global(0);
+  Vector x(mesh.mpi_comm(), num_values);
+  const std::pair<std::int64_t, std::int64_t> range = x.local_range();
+  std::vector<double> values(range.second - range.first);
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    const double s = (double) (range.first + i)/num_values;
+    values[i] = std::sin(2.0*DOLFIN_PI*s);
+  }
+  x.set_local(values);
+  x.apply("insert");
+
+  // Approximate amount of data written (bytes)
+  const std::size_t tdim = mesh.topology().dim();
+  const double num_bytes
+    = 8.0*(mesh.num_entities_global(0)*(3 + 1)
+           + mesh.num_entities_global(tdim)*(tdim + 2));
+
+  const std::vector<std::string> filters = {"none", "deflate",
+                                            "shuffle_deflate"};
+  for (auto filter : filters)
+  {
+    const std::string filename = "mesh_" + filter + ".h5";
+    dolfin::MPI::barrier(mesh.mpi_comm());
+    tic();
+    {
+      HDF5File file(mesh.mpi_comm(), filename, "w");
+      file.parameters["compression"] = filter;
+      file.write(mesh, "/mesh");
+      file.write(x, "/x");
+    }
+    const double t = dolfin::MPI::max(mesh.mpi_comm(), toc());
+
+    if (dolfin::MPI::rank(mesh.mpi_comm()) == 0)
+    {
+      const double size = boost::filesystem::file_size(filename);
+      info("%s: %g s, %g MB/s, file size %g MB", filter.c_str(), t,
+           num_bytes/t/1.0e6, size/1.0e6);
+      info("BENCH %s %g", filter.c_str(), t);
+    }
+  }
+
+  return 0;
+}
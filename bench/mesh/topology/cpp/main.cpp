@@ -16,7 +16,7 @@
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 //
 // First added:  2010-11-25
-// Last changed: 2012-12-12
+// Last changed: 2018-10-16
 
 #include <dolfin.h>
 #include <dolfin/log/LogLevel.h>
@@ -39,27 +39,51 @@ int main(int argc, char* argv[])
 
   parameters.parse(argc, argv);
 
-  UnitCubeMesh mesh(SIZE, SIZE, SIZE);
-  const int D = mesh.topology().dim();
+  // Maximum number of threads for entity computation (default: 1)
+  const int max_threads = std::max(1, (int) parameters["num_threads"]);
 
-  // Clear timing (if there is some)
-  { Timer t("Compute connectivity 3-3"); }
-  timing("Compute connectivity 3-3", TimingClear::clear);
-
-  for (int i = 0; i < NUM_REPS; i++)
   {
-    mesh.clean();
-    mesh.init(D, D);
-    dolfin::cout << "Created unit cube: " << mesh << dolfin::endl;
-  }
+    parameters["num_threads"] = 0;
+    UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+    const int D = mesh.topology().dim();
+
+    // Clear timing (if there is some)
+    { Timer t("Compute connectivity 3-3"); }
+    timing("Compute connectivity 3-3", TimingClear::clear);
+
+    for (int i = 0; i < NUM_REPS; i++)
+    {
+      mesh.clean();
+      mesh.init(D, D);
+      dolfin::cout << "Created unit cube: " << mesh << dolfin::endl;
+    }
 
-  // Report timings
-  list_timings(TimingClear::keep,
-               { TimingType::wall, TimingType::user, TimingType::system });
+    // Report timings
+    list_timings(TimingClear::keep,
+                 { TimingType::wall, TimingType::user, TimingType::system });
 
-  // Report timing
-  const auto t = timing("Compute connectivity 3-3", TimingClear::clear);
-  info("BENCH %g", std::get<1>(t));
+    // Report timing
+    const auto t = timing("Compute connectivity 3-3", TimingClear::clear);
+    info("BENCH %g", std::get<1>(t));
+  }
+
+  // Thread scaling of edge and facet computation. A new mesh is
+  // created for each repetition since entity numbers are kept by
+  // Mesh::clean.
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+  {
+    parameters["num_threads"] = (num_threads > 1) ? num_threads : 0;
+    double time = 0.0;
+    for (int i = 0; i < NUM_REPS; i++)
+    {
+      UnitCubeMesh mesh(SIZE, SIZE, SIZE);
+      Timer t;
+      mesh.init(1);
+      mesh.init(2);
+      time += t.stop();
+    }
+    info("BENCH compute_entities threads=%d %g", num_threads, time/NUM_REPS);
+  }
 
   return 0;
 }
@@ -370,3 +370,16 @@ MPI_Op dolfin::MPI::MPI_AVG()
 }
 #endif
 //-----------------------------------------------------------------------------
+#ifdef HAS_MPI
+MPI_Comm dolfin::MPI::create_neighbour_comm(const MPI_Comm comm,
+                                            const std::vector<int>& neighbours)
+{
+  MPI_Comm neighbour_comm;
+  MPI_Dist_graph_create_adjacent(comm, neighbours.size(), neighbours.data(),
+                                 MPI_UNWEIGHTED, neighbours.size(),
+                                 neighbours.data(), MPI_UNWEIGHTED,
+                                 MPI_INFO_NULL, false, &neighbour_comm);
+  return neighbour_comm;
+}
+#endif
+//-----------------------------------------------------------------------------
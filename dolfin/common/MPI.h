@@ -270,6 +270,34 @@ namespace dolfin
     /// Return average reduction operation; recognized by
     /// all_reduce(MPI_Comm, Table&, MPI_Op)
     static MPI_Op MPI_AVG();
+
+    /// Create a distributed graph communicator in which each process
+    /// is connected to the processes in neighbours only, for use with
+    /// the neighbourhood collectives. The neighbour relation must be
+    /// symmetric. The caller is responsible for freeing the returned
+    /// communicator (MPI_Comm_free).
+    static MPI_Comm create_neighbour_comm(MPI_Comm comm,
+                                          const std::vector<int>& neighbours);
+
+    /// Send in_values[in_offsets[i]:in_offsets[i + 1]] to neighbour i
+    /// of a neighbourhood communicator (see create_neighbour_comm) and
+    /// receive values from neighbour i in
+    /// out_values[out_offsets[i]:out_offsets[i + 1]]
+    template<typename T>
+      static void neighbour_all_to_all(MPI_Comm neighbour_comm,
+                                       const std::vector<T>& in_values,
+                                       const std::vector<int>& in_offsets,
+                                       std::vector<T>& out_values,
+                                       std::vector<int>& out_offsets);
+
+    /// Send in_values to all neighbours of a neighbourhood
+    /// communicator and receive values from neighbour i in
+    /// out_values[out_offsets[i]:out_offsets[i + 1]]
+    template<typename T>
+      static void neighbour_all_to_all(MPI_Comm neighbour_comm,
+                                       const std::vector<T>& in_values,
+                                       std::vector<T>& out_values,
+                                       std::vector<int>& out_offsets);
     #endif
 
   private:
@@ -493,6 +521,79 @@ namespace dolfin
     #endif
   }
 
+#endif
+  //---------------------------------------------------------------------------
+#ifdef HAS_MPI
+  template<typename T>
+    void dolfin::MPI::neighbour_all_to_all(MPI_Comm neighbour_comm,
+                                           const std::vector<T>& in_values,
+                                           const std::vector<int>& in_offsets,
+                                           std::vector<T>& out_values,
+                                           std::vector<int>& out_offsets)
+  {
+    int indegree(-1), outdegree(-2), weighted(-1);
+    MPI_Dist_graph_neighbors_count(neighbour_comm, &indegree, &outdegree,
+                                   &weighted);
+    dolfin_assert((int) in_offsets.size() == outdegree + 1);
+
+    // Data size per neighbour
+    std::vector<int> data_size_send(outdegree);
+    for (int i = 0; i < outdegree; ++i)
+      data_size_send[i] = in_offsets[i + 1] - in_offsets[i];
+
+    // Get received data sizes
+    std::vector<int> data_size_recv(indegree);
+    MPI_Neighbor_alltoall(data_size_send.data(), 1, mpi_type<int>(),
+                          data_size_recv.data(), 1, mpi_type<int>(),
+                          neighbour_comm);
+
+    // Build receive offsets
+    out_offsets.assign(indegree + 1, 0);
+    std::partial_sum(data_size_recv.begin(), data_size_recv.end(),
+                     out_offsets.begin() + 1);
+
+    // Send/receive data
+    out_values.resize(out_offsets[indegree]);
+    MPI_Neighbor_alltoallv(in_values.data(), data_size_send.data(),
+                           in_offsets.data(), mpi_type<T>(),
+                           out_values.data(), data_size_recv.data(),
+                           out_offsets.data(), mpi_type<T>(),
+                           neighbour_comm);
+  }
+  //---------------------------------------------------------------------------
+  template<typename T>
+    void dolfin::MPI::neighbour_all_to_all(MPI_Comm neighbour_comm,
+                                           const std::vector<T>& in_values,
+                                           std::vector<T>& out_values,
+                                           std::vector<int>& out_offsets)
+  {
+    int indegree(-1), outdegree(-2), weighted(-1);
+    MPI_Dist_graph_neighbors_count(neighbour_comm, &indegree, &outdegree,
+                                   &weighted);
+
+    // Same data (no copies) for each neighbour
+    std::vector<int> data_size_send(outdegree, in_values.size());
+    std::vector<int> data_offset_send(outdegree, 0);
+
+    // Get received data sizes
+    std::vector<int> data_size_recv(indegree);
+    MPI_Neighbor_alltoall(data_size_send.data(), 1, mpi_type<int>(),
+                          data_size_recv.data(), 1, mpi_type<int>(),
+                          neighbour_comm);
+
+    // Build receive offsets
+    out_offsets.assign(indegree + 1, 0);
+    std::partial_sum(data_size_recv.begin(), data_size_recv.end(),
+                     out_offsets.begin() + 1);
+
+    // Send/receive data
+    out_values.resize(out_offsets[indegree]);
+    MPI_Neighbor_alltoallv(in_values.data(), data_size_send.data(),
+                           data_offset_send.data(), mpi_type<T>(),
+                           out_values.data(), data_size_recv.data(),
+                           out_offsets.data(), mpi_type<T>(),
+                           neighbour_comm);
+  }
 #endif
   //---------------------------------------------------------------------------
   template<typename T>
@@ -22,12 +22,19 @@
 // Modified by Martin Alnaes 2013-2015
 
 #include <algorithm>
+#include <numeric>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/log/log.h>
 #include <dolfin/log/Progress.h>
 #include <dolfin/common/ArrayView.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/la/GenericTensor.h>
+#include <dolfin/la/GhostScatter.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
@@ -48,6 +55,75 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Tabulate the cell tensor of the given cell into ufc.A and
+  // extract the cell dofs. Returns false if the cell should be
+  // skipped.
+  bool tabulate_cell(UFC& ufc, const Cell& cell,
+                     const std::vector<const GenericDofMap*>& dofmaps,
+                     const MeshFunction<std::size_t>* domains,
+                     ufc::cell& ufc_cell,
+                     std::vector<double>& coordinate_dofs,
+                     std::vector<ArrayView<const dolfin::la_index>>& dofs)
+  {
+    // Get integral for sub domain (if any)
+    const ufc::cell_integral* integral = domains
+      ? ufc.get_cell_integral((*domains)[cell])
+      : ufc.default_cell_integral.get();
+
+    // Skip if no integral on current domain
+    if (!integral)
+      return false;
+
+    // Update to current cell
+    cell.get_cell_data(ufc_cell);
+    const ArrayView<const double> cell_coordinate_dofs
+      = cell.coordinate_dofs(coordinate_dofs);
+    ufc.update(cell, cell_coordinate_dofs.data(), ufc_cell,
+               integral->enabled_coefficients());
+
+    // Get local-to-global dof maps for cell
+    bool empty_dofmap = false;
+    for (std::size_t i = 0; i < dofmaps.size(); ++i)
+    {
+      auto dmap = dofmaps[i]->cell_dofs(cell.index());
+      dofs[i].set(dmap.size(), dmap.data());
+      empty_dofmap = empty_dofmap || dofs[i].size() == 0;
+    }
+
+    // Skip if at least one dofmap is empty
+    if (empty_dofmap)
+      return false;
+
+    // Tabulate cell tensor
+    integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                              cell_coordinate_dofs.data(),
+                              ufc_cell.orientation);
+    return true;
+  }
+
+#ifdef HAS_MPI
+  // Position of the owner of each unowned node of the index map in
+  // its neighbourhood (the neighbours are sorted, and include the
+  // owners of all unowned nodes)
+  std::vector<int> compute_owner_to_neighbour(const IndexMap& index_map)
+  {
+    const std::vector<int>& neighbours = index_map.neighbours();
+    const std::vector<int>& off_process_owner = index_map.off_process_owner();
+    std::vector<int> owner_to_neighbour(off_process_owner.size());
+    for (std::size_t i = 0; i < off_process_owner.size(); ++i)
+    {
+      auto it = std::lower_bound(neighbours.begin(), neighbours.end(),
+                                 off_process_owner[i]);
+      dolfin_assert(it != neighbours.end() && *it == off_process_owner[i]);
+      owner_to_neighbour[i] = it - neighbours.begin();
+    }
+    return owner_to_neighbour;
+  }
+#endif
+}
+
 //----------------------------------------------------------------------------
 void Assembler::assemble(GenericTensor& A, const Form& a)
 {
@@ -85,7 +161,14 @@ void Assembler::assemble(GenericTensor& A, const Form& a)
   init_global_tensor(A, a);
 
   // Assemble over cells
-  assemble_cells(A, a, ufc, cell_domains, NULL);
+  const int num_threads = parameters["num_threads"];
+  const bool overlap = parameters["overlap_assembly_communication"];
+  if (num_threads > 0)
+    assemble_cells_threaded(A, a, ufc, cell_domains, NULL);
+  else if (overlap)
+    assemble_cells_overlapped(A, a, ufc, cell_domains, NULL);
+  else
+    assemble_cells(A, a, ufc, cell_domains, NULL);
 
   // Assemble over exterior facets
   assemble_exterior_facets(A, a, ufc, exterior_facet_domains, NULL);
@@ -160,8 +243,9 @@ void Assembler::assemble_cells(
 
     // Update to current cell
     cell->get_cell_data(ufc_cell);
-    cell->get_coordinate_dofs(coordinate_dofs);
-    ufc.update(*cell, coordinate_dofs, ufc_cell,
+    const ArrayView<const double> cell_coordinate_dofs
+      = cell->coordinate_dofs(coordinate_dofs);
+    ufc.update(*cell, cell_coordinate_dofs.data(), ufc_cell,
                integral->enabled_coefficients());
 
     // Get local-to-global dof maps for cell
@@ -179,7 +263,7 @@ void Assembler::assemble_cells(
 
     // Tabulate cell tensor
     integral->tabulate_tensor(ufc.A.data(), ufc.w(),
-                              coordinate_dofs.data(),
+                              cell_coordinate_dofs.data(),
                               ufc_cell.orientation);
 
     // Add entries to global tensor. Either store values cell-by-cell
@@ -193,6 +277,372 @@ void Assembler::assemble_cells(
   }
 }
 //-----------------------------------------------------------------------------
+void Assembler::assemble_cells_threaded(
+  GenericTensor& A,
+  const Form& a,
+  UFC& ufc,
+  std::shared_ptr<const MeshFunction<std::size_t>> domains,
+  std::vector<double>* values)
+{
+#ifndef HAS_OPENMP
+  dolfin_error("Assembler.cpp",
+               "perform threaded assembly over cells",
+               "DOLFIN has not been configured with OpenMP");
+#else
+  // Skip assembly if there are no cell integrals
+  if (!ufc.form.has_cell_integrals())
+    return;
+
+  // Set timer
+  Timer timer("Assemble cells (threaded)");
+
+  // Extract mesh
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *(a.mesh());
+  const std::size_t D = mesh.topology().dim();
+
+  // Form rank
+  const std::size_t form_rank = ufc.form.rank();
+
+  // Check if form is a functional
+  const bool is_cell_functional = (values && form_rank == 0) ? true : false;
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Check whether integral is domain-dependent
+  const MeshFunction<std::size_t>* cell_domains
+    = (domains && !domains->empty()) ? domains.get() : NULL;
+
+  // Create one copy of the assembly data per thread
+  const int num_threads = parameters["num_threads"];
+  std::vector<UFC> thread_ufc(num_threads, ufc);
+
+  // Cells are processed in blocks. The element tensors of a block
+  // are tabulated in parallel into one buffer slot per cell and then
+  // added to the global tensor serially, in cell order, so that the
+  // backend need not support concurrent insertion and the result is
+  // identical to serial assembly.
+  const std::size_t block_size = 256*num_threads;
+  const std::size_t tensor_size = ufc.A.size();
+  std::vector<double> block_tensors(block_size*tensor_size);
+  std::vector<ArrayView<const dolfin::la_index>>
+    block_dofs(block_size*form_rank);
+  std::vector<char> block_tabulated(block_size);
+
+  // Number of non-ghost cells
+  const std::int64_t num_cells = mesh.topology().ghost_offset(D);
+
+  double scalar = 0.0;
+  for (std::int64_t block_begin = 0; block_begin < num_cells;
+       block_begin += block_size)
+  {
+    const std::int64_t block_end
+      = std::min(block_begin + (std::int64_t) block_size, num_cells);
+
+    // Tabulate element tensors of block
+    #pragma omp parallel num_threads(num_threads)
+    {
+      // Thread-local data
+      UFC& _ufc = thread_ufc[omp_get_thread_num()];
+      ufc::cell ufc_cell;
+      std::vector<double> coordinate_dofs;
+      std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+
+      #pragma omp for schedule(guided, 20)
+      for (std::int64_t c = block_begin; c < block_end; ++c)
+      {
+        const std::size_t k = c - block_begin;
+        const Cell cell(mesh, c);
+        block_tabulated[k] = tabulate_cell(_ufc, cell, dofmaps, cell_domains,
+                                           ufc_cell, coordinate_dofs, dofs);
+        if (!block_tabulated[k])
+          continue;
+
+        std::copy(_ufc.A.begin(), _ufc.A.end(),
+                  block_tensors.begin() + k*tensor_size);
+        std::copy(dofs.begin(), dofs.end(),
+                  block_dofs.begin() + k*form_rank);
+      }
+    }
+
+    // Add entries to global tensor
+    std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+    for (std::int64_t c = block_begin; c < block_end; ++c)
+    {
+      const std::size_t k = c - block_begin;
+      if (!block_tabulated[k])
+        continue;
+
+      const double* Ae = block_tensors.data() + k*tensor_size;
+      if (is_cell_functional)
+        (*values)[c] = Ae[0];
+      else if (form_rank == 0)
+        scalar += Ae[0];
+      else
+      {
+        std::copy(block_dofs.begin() + k*form_rank,
+                  block_dofs.begin() + (k + 1)*form_rank, dofs.begin());
+        A.add_local(Ae, dofs);
+      }
+    }
+  }
+
+  // Add sum of cell contributions to scalar
+  if (form_rank == 0 && !is_cell_functional)
+  {
+    std::vector<ArrayView<const dolfin::la_index>> dofs;
+    A.add_local(&scalar, dofs);
+  }
+#endif
+}
+//-----------------------------------------------------------------------------
+void Assembler::assemble_cells_overlapped(
+  GenericTensor& A,
+  const Form& a,
+  UFC& ufc,
+  std::shared_ptr<const MeshFunction<std::size_t>> domains,
+  std::vector<double>* values)
+{
+  // Skip assembly if there are no cell integrals
+  if (!ufc.form.has_cell_integrals())
+    return;
+
+#ifdef HAS_MPI
+  // Extract mesh
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *(a.mesh());
+
+  // Form rank
+  const std::size_t form_rank = ufc.form.rank();
+
+  // Scalars, functionals and serial tensors have no off-process rows
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  if (form_rank == 0 || values || MPI::size(mpi_comm) == 1)
+  {
+    assemble_cells(A, a, ufc, domains, values);
+    return;
+  }
+
+  // Set timer
+  Timer timer("Assemble cells (overlapped)");
+
+  // Collect pointers to dof maps
+  std::vector<const GenericDofMap*> dofmaps;
+  for (std::size_t i = 0; i < form_rank; ++i)
+    dofmaps.push_back(a.function_space(i)->dofmap().get());
+
+  // Number of locally owned rows of the test space
+  const GenericDofMap& row_dofmap = *dofmaps[0];
+  const std::pair<std::size_t, std::size_t> range
+    = row_dofmap.ownership_range();
+  const std::size_t num_owned_rows = range.second - range.first;
+  const std::size_t bs = row_dofmap.block_size();
+
+  // Cells with off-process rows (stored with the dofmap) and
+  // neighbourhood of the test space index map
+  const std::vector<std::size_t>& shared_cells
+    = row_dofmap.cells_with_unowned_dofs();
+  dolfin_assert(row_dofmap.index_map());
+  const IndexMap& index_map = *row_dofmap.index_map();
+  const std::vector<int> owner_to_neighbour
+    = compute_owner_to_neighbour(index_map);
+  const std::size_t num_neighbours = index_map.neighbours().size();
+  MPI_Comm neighbour_comm = index_map.ghost_scatter().neighbour_comm();
+
+  // Check whether integral is domain-dependent
+  const MeshFunction<std::size_t>* cell_domains
+    = (domains && !domains->empty()) ? domains.get() : NULL;
+
+  // Count the number of entries that will be sent to each neighbour
+  std::vector<int> send_sizes(num_neighbours, 0);
+  for (auto cell_index : shared_cells)
+  {
+    // Skip cells without integral
+    const ufc::cell_integral* integral = cell_domains
+      ? ufc.get_cell_integral((*cell_domains)[cell_index])
+      : ufc.default_cell_integral.get();
+    if (!integral)
+      continue;
+
+    // Number of entries per row
+    const std::size_t num_cols = (form_rank == 2)
+      ? dofmaps[1]->num_element_dofs(cell_index) : 1;
+
+    auto row_dofs = row_dofmap.cell_dofs(cell_index);
+    for (Eigen::Index i = 0; i < row_dofs.size(); ++i)
+    {
+      const std::size_t dof = row_dofs[i];
+      if (dof >= num_owned_rows)
+        send_sizes[owner_to_neighbour[(dof - num_owned_rows)/bs]] += num_cols;
+    }
+  }
+
+  // Start exchange of number of entries to receive from each
+  // neighbour
+  std::vector<int> recv_sizes(num_neighbours);
+  MPI_Request requests[3];
+  MPI_Ineighbor_alltoall(send_sizes.data(), 1, MPI_INT,
+                         recv_sizes.data(), 1, MPI_INT, neighbour_comm,
+                         &requests[0]);
+
+  // Entries for off-process rows, ordered by neighbour (form_rank
+  // global indices and one value per entry)
+  std::vector<int> send_offsets(num_neighbours + 1, 0);
+  std::partial_sum(send_sizes.begin(), send_sizes.end(),
+                   send_offsets.begin() + 1);
+  std::vector<std::int64_t> send_indices(form_rank*send_offsets.back());
+  std::vector<double> send_values(send_offsets.back());
+  std::vector<int> pos(send_offsets.begin(), send_offsets.end() - 1);
+
+  // Assemble cells with off-process rows. Owned rows are added to
+  // the tensor, and off-process rows are packed for the owners.
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  std::vector<ArrayView<const dolfin::la_index>> dofs(form_rank);
+  std::vector<ArrayView<const dolfin::la_index>> owned_dofs(form_rank);
+  std::vector<dolfin::la_index> owned_rows, global_cols;
+  std::vector<double> owned_block;
+  for (auto cell_index : shared_cells)
+  {
+    const Cell cell(mesh, cell_index);
+    if (!tabulate_cell(ufc, cell, dofmaps, cell_domains, ufc_cell,
+                       coordinate_dofs, dofs))
+    {
+      continue;
+    }
+
+    // Global column indices
+    const std::size_t num_cols = (form_rank == 2) ? dofs[1].size() : 1;
+    global_cols.resize(num_cols);
+    if (form_rank == 2)
+    {
+      for (std::size_t j = 0; j < num_cols; ++j)
+        global_cols[j] = dofmaps[1]->local_to_global_index(dofs[1][j]);
+    }
+
+    owned_rows.clear();
+    owned_block.clear();
+    for (std::size_t i = 0; i < dofs[0].size(); ++i)
+    {
+      const dolfin::la_index row = dofs[0][i];
+      const double* A_row = ufc.A.data() + i*num_cols;
+      if ((std::size_t) row < num_owned_rows)
+      {
+        owned_rows.push_back(row);
+        owned_block.insert(owned_block.end(), A_row, A_row + num_cols);
+      }
+      else
+      {
+        const int n = owner_to_neighbour[(row - num_owned_rows)/bs];
+        const dolfin::la_index global_row
+          = row_dofmap.local_to_global_index(row);
+        for (std::size_t j = 0; j < num_cols; ++j)
+        {
+          const int k = pos[n]++;
+          send_indices[form_rank*k] = global_row;
+          if (form_rank == 2)
+            send_indices[2*k + 1] = global_cols[j];
+          send_values[k] = A_row[j];
+        }
+      }
+    }
+
+    // Add owned rows to global tensor
+    if (!owned_rows.empty())
+    {
+      owned_dofs = dofs;
+      owned_dofs[0].set(owned_rows.size(), owned_rows.data());
+      A.add_local(owned_block.data(), owned_dofs);
+    }
+  }
+
+  // Start exchange of entries for off-process rows
+  MPI_Wait(&requests[0], MPI_STATUS_IGNORE);
+  std::vector<int> recv_offsets(num_neighbours + 1, 0);
+  std::partial_sum(recv_sizes.begin(), recv_sizes.end(),
+                   recv_offsets.begin() + 1);
+  std::vector<int> send_index_sizes(num_neighbours),
+    send_index_offsets(num_neighbours), recv_index_sizes(num_neighbours),
+    recv_index_offsets(num_neighbours);
+  for (std::size_t n = 0; n < num_neighbours; ++n)
+  {
+    send_index_sizes[n] = form_rank*send_sizes[n];
+    send_index_offsets[n] = form_rank*send_offsets[n];
+    recv_index_sizes[n] = form_rank*recv_sizes[n];
+    recv_index_offsets[n] = form_rank*recv_offsets[n];
+  }
+  std::vector<std::int64_t> recv_indices(form_rank*recv_offsets.back());
+  std::vector<double> recv_values(recv_offsets.back());
+  MPI_Ineighbor_alltoallv(send_indices.data(), send_index_sizes.data(),
+                          send_index_offsets.data(), MPI_INT64_T,
+                          recv_indices.data(), recv_index_sizes.data(),
+                          recv_index_offsets.data(), MPI_INT64_T,
+                          neighbour_comm, &requests[1]);
+  MPI_Ineighbor_alltoallv(send_values.data(), send_sizes.data(),
+                          send_offsets.data(), MPI_DOUBLE,
+                          recv_values.data(), recv_sizes.data(),
+                          recv_offsets.data(), MPI_DOUBLE,
+                          neighbour_comm, &requests[2]);
+
+  // Assemble cells with owned rows only while data is exchanged
+  auto next_shared = shared_cells.begin();
+  for (std::size_t cell_index = 0; cell_index < mesh.num_cells();
+       ++cell_index)
+  {
+    // Skip cells with off-process rows (assembled above)
+    if (next_shared != shared_cells.end() && *next_shared == cell_index)
+    {
+      ++next_shared;
+      continue;
+    }
+
+    const Cell cell(mesh, cell_index);
+    if (tabulate_cell(ufc, cell, dofmaps, cell_domains, ufc_cell,
+                      coordinate_dofs, dofs))
+    {
+      A.add_local(ufc.A.data(), dofs);
+    }
+  }
+
+  // Add received entries (owned rows, global indices) to global
+  // tensor, one row at a time
+  MPI_Waitall(2, &requests[1], MPI_STATUSES_IGNORE);
+  const std::size_t num_recv = recv_values.size();
+  if (form_rank == 1 && num_recv > 0)
+  {
+    const std::vector<dolfin::la_index> global_rows(recv_indices.begin(),
+                                                    recv_indices.end());
+    std::vector<ArrayView<const dolfin::la_index>>
+      rows = {ArrayView<const dolfin::la_index>(num_recv,
+                                                global_rows.data())};
+    A.add(recv_values.data(), rows);
+  }
+  else if (form_rank == 2)
+  {
+    std::vector<ArrayView<const dolfin::la_index>> rows(2);
+    std::size_t k = 0;
+    while (k < num_recv)
+    {
+      const dolfin::la_index row = recv_indices[2*k];
+      std::size_t k1 = k;
+      global_cols.clear();
+      for (; k1 < num_recv && recv_indices[2*k1] == row; ++k1)
+        global_cols.push_back(recv_indices[2*k1 + 1]);
+      rows[0].set(1, &row);
+      rows[1].set(global_cols.size(), global_cols.data());
+      A.add(&recv_values[k], rows);
+      k = k1;
+    }
+  }
+#else
+  // No off-process rows without MPI
+  assemble_cells(A, a, ufc, domains, values);
+#endif
+}
+//-----------------------------------------------------------------------------
 void Assembler::assemble_exterior_facets(
   GenericTensor& A,
   const Form& a,
@@ -79,6 +79,57 @@ namespace dolfin
                         std::shared_ptr<const MeshFunction<std::size_t>> domains,
                         std::vector<double>* values);
 
+    /// Assemble tensor from given form over cells using multiple
+    /// threads. The cells are processed in blocks: the element
+    /// tensors of a block are tabulated in parallel, each thread
+    /// working on its own copy of the UFC data, and are then added to
+    /// the global tensor serially in cell order. Insertion into the
+    /// tensor is therefore never concurrent, and the result is
+    /// identical to that of serial assembly. The number of threads is
+    /// set by the global parameter "num_threads". This
+    /// function requires DOLFIN to be built with OpenMP, and that
+    /// the evaluation of the form coefficients is thread-safe.
+    ///
+    /// @param[out] A (GenericTensor&)
+    ///         The tensor to assemble.
+    /// @param[in] a (Form&)
+    ///         The form to assemble the tensor from.
+    /// @param[in] ufc (UFC&)
+    /// @param[in] domains (MeshFunction<std::size_t>)
+    /// @param[in] values (std::vector<double>*)
+    void assemble_cells_threaded(GenericTensor& A, const Form& a, UFC& ufc,
+                   std::shared_ptr<const MeshFunction<std::size_t>> domains,
+                   std::vector<double>* values);
+
+    /// Assemble tensor from given form over cells, overlapping the
+    /// communication of off-process entries with computation. Cells
+    /// with test space rows owned by other processes are assembled
+    /// first, and their off-process entries are sent to the owning
+    /// processes using non-blocking neighbourhood collectives over
+    /// the neighbourhood of the test space index map (see
+    /// IndexMap::ghost_scatter). The remaining cells are assembled
+    /// while the data is exchanged. Received entries are added to
+    /// the tensor using global indices, so that off-process entries
+    /// from cells are not stashed for apply(). The final call to
+    /// apply() still finalises the tensor, which for PETSc tensors
+    /// involves a global reduction. The cells with off-process rows
+    /// are computed once per test space dofmap (see
+    /// GenericDofMap::cells_with_unowned_dofs) and the neighbourhood
+    /// once per index map, so they are reused by all assemblers.
+    /// Scalars, functionals and serial tensors are assembled with
+    /// assemble_cells().
+    ///
+    /// @param[out] A (GenericTensor&)
+    ///         The tensor to assemble.
+    /// @param[in] a (Form&)
+    ///         The form to assemble the tensor from.
+    /// @param[in] ufc (UFC&)
+    /// @param[in] domains (MeshFunction<std::size_t>)
+    /// @param[in] values (std::vector<double>*)
+    void assemble_cells_overlapped(GenericTensor& A, const Form& a, UFC& ufc,
+                   std::shared_ptr<const MeshFunction<std::size_t>> domains,
+                   std::vector<double>* values);
+
     /// Assemble tensor from given form over exterior facets. This
     /// function is provided for users who wish to build a customized
     /// assembler.
@@ -0,0 +1,443 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/function/GenericFunction.h>
+#include <dolfin/la/EigenMatrix.h>
+#include <dolfin/la/GenericMatrix.h>
+#include <dolfin/la/PETScMatrix.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Facet.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshFunction.h>
+#include "Assembler.h"
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "UFC.h"
+#include "AssemblyPlan.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Copy compressed row storage index arrays
+  template<typename T>
+  void copy_csr(std::size_t num_rows, const T* row_ptr, const T* cols,
+                std::vector<std::size_t>& _row_ptr,
+                std::vector<std::size_t>& _cols)
+  {
+    _row_ptr.assign(row_ptr, row_ptr + num_rows + 1);
+    _cols.assign(cols, cols + row_ptr[num_rows]);
+  }
+
+  // Get compressed row storage of matrix. The storage is identified
+  // by the address of its column index array, which is returned
+  // (null if the matrix does not provide direct access to its
+  // storage). If row_ptr and cols are non-null, the index arrays
+  // are copied.
+  const void* get_storage(const GenericMatrix& A, std::size_t& nnz,
+                          std::vector<std::size_t>* row_ptr=nullptr,
+                          std::vector<std::size_t>* cols=nullptr)
+  {
+    if (has_type<EigenMatrix>(A))
+    {
+      const EigenMatrix::eigen_matrix_type& _A
+        = as_type<const EigenMatrix>(A).mat();
+      if (!_A.isCompressed())
+        return nullptr;
+
+      nnz = _A.nonZeros();
+      if (row_ptr && cols)
+      {
+        copy_csr(_A.rows(), _A.outerIndexPtr(), _A.innerIndexPtr(),
+                 *row_ptr, *cols);
+      }
+      return _A.innerIndexPtr();
+    }
+
+    #ifdef HAS_PETSC
+    if (has_type<PETScMatrix>(A))
+    {
+      Mat _A = as_type<const PETScMatrix>(A).mat();
+
+      // Only sequential AIJ matrices expose their storage
+      PetscBool is_seqaij = PETSC_FALSE;
+      PetscErrorCode ierr
+        = PetscObjectTypeCompare((PetscObject)_A, MATSEQAIJ, &is_seqaij);
+      if (ierr != 0)
+        PETScObject::petsc_error(ierr, __FILE__, "PetscObjectTypeCompare");
+      if (!is_seqaij)
+        return nullptr;
+
+      PetscInt n = 0;
+      const PetscInt* ia = nullptr;
+      const PetscInt* ja = nullptr;
+      PetscBool done = PETSC_FALSE;
+      ierr = MatGetRowIJ(_A, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done);
+      if (ierr != 0)
+        PETScObject::petsc_error(ierr, __FILE__, "MatGetRowIJ");
+      if (!done)
+        return nullptr;
+
+      nnz = ia[n];
+      if (row_ptr && cols)
+        copy_csr(n, ia, ja, *row_ptr, *cols);
+      const void* storage = ja;
+
+      ierr = MatRestoreRowIJ(_A, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja,
+                             &done);
+      if (ierr != 0)
+        PETScObject::petsc_error(ierr, __FILE__, "MatRestoreRowIJ");
+      return storage;
+    }
+    #endif
+
+    return nullptr;
+  }
+
+  // Get pointer to values of compressed row storage of matrix
+  double* get_values(GenericMatrix& A)
+  {
+    if (has_type<EigenMatrix>(A))
+      return as_type<EigenMatrix>(A).mat().valuePtr();
+
+    #ifdef HAS_PETSC
+    PetscScalar* values = nullptr;
+    PetscErrorCode ierr
+      = MatSeqAIJGetArray(as_type<PETScMatrix>(A).mat(), &values);
+    if (ierr != 0)
+      PETScObject::petsc_error(ierr, __FILE__, "MatSeqAIJGetArray");
+    return values;
+    #else
+    dolfin_assert(false);
+    return nullptr;
+    #endif
+  }
+
+  // Restore values obtained with get_values
+  void restore_values(GenericMatrix& A, double* values)
+  {
+    #ifdef HAS_PETSC
+    if (has_type<PETScMatrix>(A))
+    {
+      PetscErrorCode ierr
+        = MatSeqAIJRestoreArray(as_type<PETScMatrix>(A).mat(), &values);
+      if (ierr != 0)
+        PETScObject::petsc_error(ierr, __FILE__, "MatSeqAIJRestoreArray");
+    }
+    #endif
+  }
+
+  // Add element tensor to matrix values at given positions
+  inline void add_entries(double* values, const double* A,
+                          const std::size_t* positions, std::size_t n)
+  {
+    for (std::size_t k = 0; k < n; ++k)
+      values[positions[k]] += A[k];
+  }
+}
+
+//-----------------------------------------------------------------------------
+AssemblyPlan::AssemblyPlan(std::shared_ptr<const Form> a)
+  : _a(a), _built(false), _direct(false), _mesh_id(0), _num_cells(0),
+    _topology_modification_count(0), _matrix(nullptr), _storage(nullptr),
+    _nnz(0)
+{
+  dolfin_assert(_a);
+  if (_a->rank() != 2)
+  {
+    dolfin_error("AssemblyPlan.cpp",
+                 "create assembly plan",
+                 "Form must be bilinear (rank 2), but has rank %d",
+                 _a->rank());
+  }
+}
+//-----------------------------------------------------------------------------
+AssemblyPlan::~AssemblyPlan()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void AssemblyPlan::assemble(GenericMatrix& A)
+{
+  // Assemble with standard assembler and (re)build plan if the
+  // plan is out of date
+  if (!valid(A))
+  {
+    _assembler.add_values = add_values;
+    _assembler.finalize_tensor = true;
+    _assembler.keep_diagonal = keep_diagonal;
+    _assembler.assemble(A, *_a);
+    build(A);
+    return;
+  }
+
+  if (_direct)
+    assemble_direct(A);
+  else
+  {
+    _assembler.add_values = add_values;
+    _assembler.finalize_tensor = finalize_tensor;
+    _assembler.keep_diagonal = keep_diagonal;
+    _assembler.assemble(A, *_a);
+  }
+}
+//-----------------------------------------------------------------------------
+bool AssemblyPlan::valid(const GenericMatrix& A) const
+{
+  if (!_built)
+    return false;
+
+  // Check mesh
+  dolfin_assert(_a->mesh());
+  const Mesh& mesh = *_a->mesh();
+  if (mesh.id() != _mesh_id || mesh.num_cells() != _num_cells
+      || mesh.topology().modification_count()
+          != _topology_modification_count)
+  {
+    return false;
+  }
+
+  // Check dofmaps and coefficients
+  for (std::size_t i = 0; i < _dofmaps.size(); ++i)
+  {
+    if (_a->function_space(i)->dofmap() != _dofmaps[i])
+      return false;
+  }
+  if (_a->coefficients() != _coefficients)
+    return false;
+
+  // Check matrix
+  if (A.instance() != _matrix)
+    return false;
+  if (_direct)
+  {
+    std::size_t nnz = 0;
+    if (get_storage(A, nnz) != _storage || nnz != _nnz)
+      return false;
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------------------
+void AssemblyPlan::clear()
+{
+  _built = false;
+  _direct = false;
+  _ufc.reset();
+  _dofmaps.clear();
+  _coefficients.clear();
+  _matrix = nullptr;
+  _storage = nullptr;
+  _offsets.clear();
+  _positions.clear();
+}
+//-----------------------------------------------------------------------------
+void AssemblyPlan::build(const GenericMatrix& A)
+{
+  Timer timer("Build assembly plan");
+
+  clear();
+
+  const Form& a = *_a;
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+
+  // Store data identifying the mesh, dofmaps, coefficients and
+  // matrix
+  _mesh_id = mesh.id();
+  _num_cells = mesh.num_cells();
+  _topology_modification_count = mesh.topology().modification_count();
+  for (std::size_t i = 0; i < 2; ++i)
+    _dofmaps.push_back(a.function_space(i)->dofmap());
+  _coefficients = a.coefficients();
+  _matrix = A.instance();
+  _built = true;
+
+  // Create UFC data
+  _ufc.reset(new UFC(a));
+
+  // Direct insertion is only supported for cell and exterior facet
+  // integrals
+  const ufc::form& form = *a.ufc_form();
+  if (form.has_interior_facet_integrals() || form.has_vertex_integrals()
+      || form.has_custom_integrals() || form.has_cutcell_integrals()
+      || form.has_interface_integrals() || form.has_overlap_integrals())
+  {
+    log(PROGRESS, "Form has integrals not supported by assembly plan, using standard assembler.");
+    return;
+  }
+
+  // Get matrix storage
+  std::vector<std::size_t> row_ptr, cols;
+  _storage = get_storage(A, _nnz, &row_ptr, &cols);
+  if (!_storage)
+  {
+    log(PROGRESS, "Matrix storage not accessible for assembly plan, using standard assembler.");
+    return;
+  }
+
+  // Compute positions of element tensor entries in matrix storage
+  // for each cell
+  const GenericDofMap& dofmap0 = *_dofmaps[0];
+  const GenericDofMap& dofmap1 = *_dofmaps[1];
+  _offsets.assign(mesh.num_cells() + 1, 0);
+  _positions.reserve(mesh.num_cells()*dofmap0.max_element_dofs()
+                     *dofmap1.max_element_dofs());
+  for (std::size_t c = 0; c < mesh.num_cells(); ++c)
+  {
+    auto dofs0 = dofmap0.cell_dofs(c);
+    auto dofs1 = dofmap1.cell_dofs(c);
+    for (Eigen::Index i = 0; i < dofs0.size(); ++i)
+    {
+      const auto row_begin = cols.begin() + row_ptr[dofs0[i]];
+      const auto row_end = cols.begin() + row_ptr[dofs0[i] + 1];
+      for (Eigen::Index j = 0; j < dofs1.size(); ++j)
+      {
+        const auto entry = std::lower_bound(row_begin, row_end, dofs1[j]);
+        if (entry == row_end || *entry != (std::size_t) dofs1[j])
+        {
+          // Entry is not in sparsity pattern (cell is not covered by
+          // the integrals of the form)
+          log(PROGRESS, "Sparsity pattern does not cover all cells, using standard assembler.");
+          _storage = nullptr;
+          _offsets.clear();
+          _positions.clear();
+          return;
+        }
+        _positions.push_back(entry - cols.begin());
+      }
+    }
+    _offsets[c + 1] = _positions.size();
+  }
+
+  _direct = true;
+}
+//-----------------------------------------------------------------------------
+void AssemblyPlan::assemble_direct(GenericMatrix& A)
+{
+  Timer timer("Assemble using assembly plan");
+
+  const Form& a = *_a;
+  dolfin_assert(a.mesh());
+  const Mesh& mesh = *a.mesh();
+  dolfin_assert(_ufc);
+  UFC& ufc = *_ufc;
+
+  // Get matrix values, and zero them unless adding to matrix
+  double* values = get_values(A);
+  if (!add_values)
+    std::fill(values, values + _nnz, 0.0);
+
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+
+  // Assemble over cells
+  if (ufc.form.has_cell_integrals())
+  {
+    std::shared_ptr<const MeshFunction<std::size_t>> domains
+      = a.cell_domains();
+    const bool use_domains = domains && !domains->empty();
+    const ufc::cell_integral* integral = ufc.default_cell_integral.get();
+    for (CellIterator cell(mesh); !cell.end(); ++cell)
+    {
+      // Get integral for sub domain (if any)
+      if (use_domains)
+        integral = ufc.get_cell_integral((*domains)[*cell]);
+
+      // Skip if no integral on current domain
+      if (!integral)
+        continue;
+
+      // Skip if cell has no dofs
+      const std::size_t c = cell->index();
+      const std::size_t n = _offsets[c + 1] - _offsets[c];
+      if (n == 0)
+        continue;
+
+      // Update to current cell
+      cell->get_cell_data(ufc_cell);
+      const ArrayView<const double> cell_coordinate_dofs
+        = cell->coordinate_dofs(coordinate_dofs);
+      ufc.update(*cell, cell_coordinate_dofs.data(), ufc_cell,
+                 integral->enabled_coefficients());
+
+      // Tabulate cell tensor and add to matrix
+      integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                                cell_coordinate_dofs.data(),
+                                ufc_cell.orientation);
+      add_entries(values, ufc.A.data(), _positions.data() + _offsets[c], n);
+    }
+  }
+
+  // Assemble over exterior facets
+  if (ufc.form.has_exterior_facet_integrals())
+  {
+    std::shared_ptr<const MeshFunction<std::size_t>> domains
+      = a.exterior_facet_domains();
+    const bool use_domains = domains && !domains->empty();
+    const ufc::exterior_facet_integral* integral
+      = ufc.default_exterior_facet_integral.get();
+    const std::size_t D = mesh.topology().dim();
+    for (FacetIterator facet(mesh); !facet.end(); ++facet)
+    {
+      // Only consider exterior facets
+      if (!facet->exterior())
+        continue;
+
+      // Get integral for sub domain (if any)
+      if (use_domains)
+        integral = ufc.get_exterior_facet_integral((*domains)[*facet]);
+
+      // Skip integral if zero
+      if (!integral)
+        continue;
+
+      // Get mesh cell to which mesh facet belongs
+      dolfin_assert(facet->num_entities(D) == 1);
+      const Cell cell(mesh, facet->entities(D)[0]);
+      const std::size_t c = cell.index();
+      const std::size_t n = _offsets[c + 1] - _offsets[c];
+      if (n == 0)
+        continue;
+
+      // Update to current cell
+      const std::size_t local_facet = cell.index(*facet);
+      cell.get_cell_data(ufc_cell, local_facet);
+      cell.get_coordinate_dofs(coordinate_dofs);
+      ufc.update(cell, coordinate_dofs, ufc_cell,
+                 integral->enabled_coefficients());
+
+      // Tabulate exterior facet tensor and add to matrix
+      integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                                coordinate_dofs.data(), local_facet,
+                                ufc_cell.orientation);
+      add_entries(values, ufc.A.data(), _positions.data() + _offsets[c], n);
+    }
+  }
+
+  // Restore matrix values and finalize
+  restore_values(A, values);
+  if (finalize_tensor)
+    A.apply("add");
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,142 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __ASSEMBLY_PLAN_H
+#define __ASSEMBLY_PLAN_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Assembler.h"
+#include "AssemblerBase.h"
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Form;
+  class GenericDofMap;
+  class GenericFunction;
+  class GenericMatrix;
+  class LinearAlgebraObject;
+  class UFC;
+
+  /// This class assembles a bilinear form repeatedly into a matrix
+  /// with a fixed sparsity pattern, as is typical in time-stepping
+  /// loops. On first assembly the matrix is assembled by the
+  /// standard Assembler and, for each cell, the positions in the
+  /// compressed row storage of the matrix where the entries of the
+  /// element tensor are added are computed. Subsequent assemblies
+  /// add the element tensors directly into the matrix storage,
+  /// without searching for the matrix entries.
+  ///
+  /// The plan is rebuilt automatically if the mesh topology, the
+  /// dofmaps, the form coefficients or the matrix storage
+  /// change. Subdomain markers and coefficient values may change
+  /// between assemblies.
+  ///
+  /// Direct insertion is supported for EigenMatrix and serial
+  /// (sequential AIJ) PETScMatrix objects, and for forms with cell
+  /// and exterior facet integrals. In other cases, the standard
+  /// Assembler is used for every assembly.
+
+  class AssemblyPlan : public AssemblerBase
+  {
+  public:
+
+    /// Create assembly plan for bilinear form
+    ///
+    /// @param[in] a (Form)
+    ///         The bilinear form.
+    explicit AssemblyPlan(std::shared_ptr<const Form> a);
+
+    /// Destructor
+    ~AssemblyPlan();
+
+    /// Assemble matrix, building the plan if necessary
+    ///
+    /// @param[out] A (GenericMatrix&)
+    ///         The matrix to assemble.
+    void assemble(GenericMatrix& A);
+
+    /// Return true if the plan has been built for the current mesh,
+    /// dofmaps and coefficients of the form and the storage of the
+    /// given matrix
+    ///
+    /// @param[in] A (GenericMatrix&)
+    ///         The matrix.
+    bool valid(const GenericMatrix& A) const;
+
+    /// Return true if the plan inserts values directly into the
+    /// matrix storage (false if the plan has not been built or the
+    /// standard assembler is used)
+    bool direct() const
+    { return _built && _direct; }
+
+    /// Clear plan, forcing it to be rebuilt on next assembly
+    void clear();
+
+  private:
+
+    // Build plan for the given (assembled) matrix
+    void build(const GenericMatrix& A);
+
+    // Add element tensors directly into matrix storage
+    void assemble_direct(GenericMatrix& A);
+
+    // The bilinear form
+    std::shared_ptr<const Form> _a;
+
+    // UFC data for the form
+    std::unique_ptr<UFC> _ufc;
+
+    // Standard assembler, used when the plan is (re)built or direct
+    // insertion is not possible. It is kept so that data computed
+    // for the form's dofmaps (e.g. for overlapped assembly) is reused.
+    Assembler _assembler;
+
+    // True if plan has been built
+    bool _built;
+
+    // True if values can be inserted directly into matrix storage
+    bool _direct;
+
+    // Mesh data that the plan was built for
+    std::size_t _mesh_id;
+    std::size_t _num_cells;
+    std::size_t _topology_modification_count;
+
+    // Dofmaps and coefficients that the plan was built for
+    std::vector<std::shared_ptr<const GenericDofMap>> _dofmaps;
+    std::vector<std::shared_ptr<const GenericFunction>> _coefficients;
+
+    // Matrix and matrix storage that the plan was built for
+    const LinearAlgebraObject* _matrix;
+    const void* _storage;
+    std::size_t _nnz;
+
+    // Positions in matrix storage of the element tensor entries for
+    // each cell. The positions for cell c are stored in
+    // _positions[_offsets[c]] to _positions[_offsets[c + 1]]
+    std::vector<std::size_t> _offsets;
+    std::vector<std::size_t> _positions;
+
+  };
+
+}
+
+#endif
@@ -24,6 +24,7 @@
 // First added:  2007-04-10
 // Last changed: 2014-01-23
 
+#include <algorithm>
 #include <cinttypes>
 #include <cmath>
 #include <cstdlib>
@@ -72,7 +73,7 @@ DirichletBC::DirichletBC(std::shared_ptr<const FunctionSpace> V,
                          bool check_midpoint)
   : Hierarchical<DirichletBC>(*this), _function_space(V), _g(g),
     _method(method), _user_sub_domain(sub_domain),
-    _num_dofs(0), _check_midpoint(check_midpoint)
+    _num_dofs(0), _check_midpoint(check_midpoint), _cache_valid(false)
 {
   check();
   parameters = default_parameters();
@@ -85,7 +86,8 @@ DirichletBC::DirichletBC(std::shared_ptr<const FunctionSpace> V,
                          std::string method)
   : Hierarchical<DirichletBC>(*this), _function_space(V), _g(g),
     _method(method), _num_dofs(0), _user_mesh_function(sub_domains),
-    _user_sub_domain_marker(sub_domain), _check_midpoint(true)
+    _user_sub_domain_marker(sub_domain), _check_midpoint(true),
+    _cache_valid(false)
 {
   check();
   parameters = default_parameters();
@@ -96,7 +98,7 @@ DirichletBC::DirichletBC(std::shared_ptr<const FunctionSpace> V,
                          std::size_t sub_domain, std::string method)
   : Hierarchical<DirichletBC>(*this), _function_space(V), _g(g),
     _method(method), _num_dofs(0), _user_sub_domain_marker(sub_domain),
-    _check_midpoint(true)
+    _check_midpoint(true), _cache_valid(false)
 {
   check();
   parameters = default_parameters();
@@ -108,7 +110,7 @@ DirichletBC::DirichletBC(std::shared_ptr<const FunctionSpace> V,
                          std::string method)
   : Hierarchical<DirichletBC>(*this), _function_space(V), _g(g),
     _method(method), _num_dofs(0), _facets(markers),
-    _user_sub_domain_marker(0), _check_midpoint(true)
+    _user_sub_domain_marker(0), _check_midpoint(true), _cache_valid(false)
 {
   check();
   parameters = default_parameters();
@@ -137,6 +139,7 @@ const DirichletBC& DirichletBC::operator= (const DirichletBC& bc)
   _user_mesh_function = bc._user_mesh_function;
   _user_sub_domain_marker = bc._user_sub_domain_marker;
   _check_midpoint = bc._check_midpoint;
+  _cache_valid = false;
 
   // Call assignment operator for base class
   Variable::operator=(bc);
@@ -271,6 +274,19 @@ void DirichletBC::gather(Map& boundary_values) const
 //-----------------------------------------------------------------------------
 void DirichletBC::get_boundary_values(Map& boundary_values) const
 {
+  // Use cached dofs if requested
+  const bool cache_dofs = parameters["cache_dofs"];
+  if (cache_dofs)
+  {
+    init_cache();
+    std::vector<double> values;
+    compute_cached_values(values);
+    boundary_values.reserve(boundary_values.size() + _cached_dofs.size());
+    for (std::size_t i = 0; i < _cached_dofs.size(); ++i)
+      boundary_values[_cached_dofs[i]] = values[i];
+    return;
+  }
+
   // Create local data
   dolfin_assert(_function_space);
   LocalData data(*_function_space);
@@ -284,6 +300,16 @@ void DirichletBC::zero(GenericMatrix& A) const
   // Check arguments
   check_arguments(&A, NULL, NULL, 0);
 
+  // Use cached dofs if requested
+  const bool cache_dofs = parameters["cache_dofs"];
+  if (cache_dofs)
+  {
+    init_cache();
+    A.zero_local(_cached_dofs.size(), _cached_dofs.data());
+    A.apply("insert");
+    return;
+  }
+
   // A map to hold the mapping from boundary dofs to boundary values
   Map boundary_values;
 
@@ -449,27 +475,45 @@ void DirichletBC::apply(GenericMatrix* A,
   // Check arguments
   check_arguments(A, b, x, 0);
 
-  // A map to hold the mapping from boundary dofs to boundary values
-  Map boundary_values;
-
-  // Create local data for application of boundary conditions
-  dolfin_assert(_function_space);
-  LocalData data(*_function_space);
+  // Boundary dofs and values
+  std::vector<dolfin::la_index> dofs_uncached;
+  std::vector<double> values;
 
-  // Compute dofs and values
-  compute_bc(boundary_values, data, _method);
-
-  // Copy boundary value data to arrays
-  const std::size_t size = boundary_values.size();
-  std::vector<dolfin::la_index> dofs(size);
-  std::vector<double> values(size);
-  Map::const_iterator bv;
-  std::size_t counter = 0;
-  for (bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
+  const bool cache_dofs = parameters["cache_dofs"];
+  if (cache_dofs)
   {
-    dofs[counter]     = bv->first;
-    values[counter++] = bv->second;
+    // Use cached dofs, and compute values only if the vector is
+    // modified
+    init_cache();
+    if (b)
+      compute_cached_values(values);
   }
+  else
+  {
+    // A map to hold the mapping from boundary dofs to boundary values
+    Map boundary_values;
+
+    // Create local data for application of boundary conditions
+    dolfin_assert(_function_space);
+    LocalData data(*_function_space);
+
+    // Compute dofs and values
+    compute_bc(boundary_values, data, _method);
+
+    // Copy boundary value data to arrays
+    dofs_uncached.resize(boundary_values.size());
+    values.resize(boundary_values.size());
+    Map::const_iterator bv;
+    std::size_t counter = 0;
+    for (bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
+    {
+      dofs_uncached[counter] = bv->first;
+      values[counter++] = bv->second;
+    }
+  }
+  const std::vector<dolfin::la_index>& dofs
+    = cache_dofs ? _cached_dofs : dofs_uncached;
+  const std::size_t size = dofs.size();
 
   // Modify boundary values for nonlinear problems
   if (x)
@@ -518,6 +562,113 @@ void DirichletBC::apply(GenericMatrix* A,
   }
 }
 //-----------------------------------------------------------------------------
+void DirichletBC::init_cache() const
+{
+  dolfin_assert(_function_space);
+  dolfin_assert(_function_space->mesh());
+  dolfin_assert(_function_space->dofmap());
+  const Mesh& mesh = *_function_space->mesh();
+  const GenericDofMap& dofmap = *_function_space->dofmap();
+
+  // Check if cache is up to date
+  if (_cache_valid && _cached_function_space == _function_space.get()
+      && _cached_dofmap == &dofmap
+      && _cached_num_cells == mesh.num_cells()
+      && _cached_geometry_count == mesh.geometry().modification_count())
+  {
+    return;
+  }
+
+  Timer timer("DirichletBC init cache");
+
+  // Compute dofs using the given method
+  Map boundary_values;
+  LocalData data(*_function_space);
+  compute_bc(boundary_values, data, _method);
+
+  // Store dofs as sorted array
+  _cached_dofs.clear();
+  _cached_dofs.reserve(boundary_values.size());
+  for (auto bv = boundary_values.begin(); bv != boundary_values.end(); ++bv)
+    _cached_dofs.push_back(bv->first);
+  std::sort(_cached_dofs.begin(), _cached_dofs.end());
+
+  // Position of each dof in the array of cached dofs (-1 if not a
+  // cached dof, or if a cell has already been found for the dof)
+  const std::size_t num_local_dofs
+    = _cached_dofs.empty() ? 0 : _cached_dofs.back() + 1;
+  std::vector<int> position(num_local_dofs, -1);
+  for (std::size_t i = 0; i < _cached_dofs.size(); ++i)
+    position[_cached_dofs[i]] = i;
+
+  // Find a cell for each dof (including ghost cells, since ghost
+  // dofs may be constrained)
+  _cached_cells.clear();
+  _cached_cell_offsets.assign(1, 0);
+  _cached_cell_dofs.clear();
+  _cached_cell_dofs.reserve(_cached_dofs.size());
+  std::size_t num_found = 0;
+  for (CellIterator cell(mesh, "all");
+       !cell.end() && num_found < _cached_dofs.size(); ++cell)
+  {
+    auto cell_dofs = dofmap.cell_dofs(cell->index());
+    for (Eigen::Index i = 0; i < cell_dofs.size(); ++i)
+    {
+      const std::size_t dof = cell_dofs[i];
+      if (dof < num_local_dofs && position[dof] >= 0)
+      {
+        _cached_cell_dofs.push_back(std::make_pair(i, position[dof]));
+        position[dof] = -1;
+        ++num_found;
+      }
+    }
+
+    if (_cached_cell_dofs.size() > _cached_cell_offsets.back())
+    {
+      _cached_cells.push_back(cell->index());
+      _cached_cell_offsets.push_back(_cached_cell_dofs.size());
+    }
+  }
+  dolfin_assert(num_found == _cached_dofs.size());
+
+  _cached_function_space = _function_space.get();
+  _cached_dofmap = &dofmap;
+  _cached_num_cells = mesh.num_cells();
+  _cached_geometry_count = mesh.geometry().modification_count();
+  _cache_valid = true;
+}
+//-----------------------------------------------------------------------------
+void DirichletBC::compute_cached_values(std::vector<double>& values) const
+{
+  dolfin_assert(_cache_valid);
+  dolfin_assert(_g);
+  dolfin_assert(_function_space->element());
+  const FiniteElement& element = *_function_space->element();
+  const Mesh& mesh = *_function_space->mesh();
+
+  Timer timer("DirichletBC compute cached values");
+
+  // Restrict boundary value function to each cached cell and pick
+  // the values of the cached dofs
+  values.resize(_cached_dofs.size());
+  std::vector<double> w(element.space_dimension());
+  std::vector<double> coordinate_dofs;
+  ufc::cell ufc_cell;
+  for (std::size_t i = 0; i < _cached_cells.size(); ++i)
+  {
+    const Cell cell(mesh, _cached_cells[i]);
+    cell.get_coordinate_dofs(coordinate_dofs);
+    cell.get_cell_data(ufc_cell);
+    _g->restrict(w.data(), element, cell, coordinate_dofs.data(), ufc_cell);
+
+    for (std::size_t j = _cached_cell_offsets[i];
+         j < _cached_cell_offsets[i + 1]; ++j)
+    {
+      values[_cached_cell_dofs[j].second] = w[_cached_cell_dofs[j].first];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void DirichletBC::check() const
 {
   dolfin_assert(_g);
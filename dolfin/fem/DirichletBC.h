@@ -38,6 +38,7 @@
 #include <boost/multi_array.hpp>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include <dolfin/common/types.h>
 #include <dolfin/common/Hierarchical.h>
@@ -50,6 +51,7 @@ namespace dolfin
   class GenericFunction;
   class FunctionSpace;
   class Facet;
+  class GenericDofMap;
   class GenericMatrix;
   class GenericVector;
   class SubDomain;
@@ -120,6 +122,16 @@ namespace dolfin
   /// by some methods on a first apply(). This means that changing a
   /// supplied object (defining boundary subdomain) after first use may
   /// have no effect. But this is implementation and method specific.
+  ///
+  /// When the parameter "cache_dofs" is set, the constrained dofs
+  /// are computed once, stored as a sorted array, and reused for
+  /// subsequent applications, e.g. in time-stepping loops. For each
+  /// constrained dof, a cell containing the dof is stored, and the
+  /// boundary values are recomputed on each application by
+  /// restricting the boundary value function to these cells only.
+  /// The cache is rebuilt if the function space, its dofmap or the
+  /// number of mesh cells change, or if the mesh coordinates are
+  /// modified (see MeshGeometry::modification_count).
 
   class DirichletBC : public Hierarchical<DirichletBC>, public Variable
   {
@@ -341,6 +353,7 @@ namespace dolfin
       Parameters p("dirichlet_bc");
       p.add("use_ident", true);
       p.add("check_dofmap_range", true);
+      p.add("cache_dofs", false);
       return p;
     }
 
@@ -355,6 +368,12 @@ namespace dolfin
     // Check input data to constructor
     void check() const;
 
+    // Build cached dofs and cells, unless the cache is up to date
+    void init_cache() const;
+
+    // Compute boundary values of cached dofs
+    void compute_cached_values(std::vector<double>& values) const;
+
     // Initialize facets (from sub domain, mesh, etc)
     void init_facets(const MPI_Comm mpi_comm) const;
 
@@ -434,6 +453,26 @@ namespace dolfin
     // Flag for whether midpoints should be checked
     bool _check_midpoint;
 
+    // Cached constrained dofs (local to process, sorted), see
+    // parameter "cache_dofs"
+    mutable bool _cache_valid;
+    mutable std::vector<dolfin::la_index> _cached_dofs;
+
+    // Cells used to compute the values of the cached dofs. For cell
+    // _cached_cells[i], the pairs (index of dof in cell, position in
+    // _cached_dofs) are stored in _cached_cell_dofs[j] for
+    // _cached_cell_offsets[i] <= j < _cached_cell_offsets[i + 1]
+    mutable std::vector<std::size_t> _cached_cells;
+    mutable std::vector<std::size_t> _cached_cell_offsets;
+    mutable std::vector<std::pair<std::size_t, std::size_t>>
+      _cached_cell_dofs;
+
+    // Function space, dofmap and mesh data the cache was built for
+    mutable const FunctionSpace* _cached_function_space;
+    mutable const GenericDofMap* _cached_dofmap;
+    mutable std::size_t _cached_num_cells;
+    mutable std::size_t _cached_geometry_count;
+
     // Local data for application of boundary conditions
     class LocalData
     {
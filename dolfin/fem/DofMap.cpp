@@ -23,6 +23,7 @@
 // Modified by Mikael Mortensen 2012
 // Modified by Jan Blechta 2013
 
+#include <limits>
 #include <unordered_map>
 
 #include <dolfin/common/MPI.h>
@@ -43,7 +44,7 @@ DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
                const Mesh& mesh)
   : _cell_dimension(0), _ufc_dofmap(ufc_dofmap), _is_view(false),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
-    _index_map(new IndexMap(mesh.mpi_comm()))
+    _index_map(new IndexMap(mesh.mpi_comm())), _dof_ordering("default")
 {
   dolfin_assert(_ufc_dofmap);
 
@@ -53,10 +54,11 @@ DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
 //-----------------------------------------------------------------------------
 DofMap::DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
                const Mesh& mesh,
-               std::shared_ptr<const SubDomain> constrained_domain)
+               std::shared_ptr<const SubDomain> constrained_domain,
+               std::string dof_ordering)
   : _cell_dimension(0), _ufc_dofmap(ufc_dofmap), _is_view(false),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
-    _index_map(new IndexMap(mesh.mpi_comm()))
+    _index_map(new IndexMap(mesh.mpi_comm())), _dof_ordering(dof_ordering)
 {
   dolfin_assert(_ufc_dofmap);
 
@@ -71,7 +73,8 @@ DofMap::DofMap(const DofMap& parent_dofmap,
                const std::vector<std::size_t>& component, const Mesh& mesh)
   : _cell_dimension(0), _ufc_dofmap(0), _is_view(true),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
-    _index_map(parent_dofmap._index_map)
+    _index_map(parent_dofmap._index_map),
+    _dof_ordering(parent_dofmap._dof_ordering)
 {
   // Build sub-dofmap
   DofMapBuilder::build_sub_map_view(*this, parent_dofmap, component, mesh);
@@ -81,7 +84,8 @@ DofMap::DofMap(std::unordered_map<std::size_t, std::size_t>& collapsed_map,
                const DofMap& dofmap_view, const Mesh& mesh)
   : _cell_dimension(0), _ufc_dofmap(dofmap_view._ufc_dofmap), _is_view(false),
     _global_dimension(0), _ufc_offset(0), _multimesh_offset(0),
-    _index_map(new IndexMap(mesh.mpi_comm()))
+    _index_map(new IndexMap(mesh.mpi_comm())),
+    _dof_ordering(dofmap_view._dof_ordering)
 {
   dolfin_assert(_ufc_dofmap);
 
@@ -139,6 +143,8 @@ DofMap::DofMap(const DofMap& dofmap) : _index_map(dofmap._index_map)
   _multimesh_offset = dofmap._multimesh_offset;
   _shared_nodes = dofmap._shared_nodes;
   _neighbours = dofmap._neighbours;
+  _cells_with_unowned_dofs = dofmap._cells_with_unowned_dofs;
+  _dof_ordering = dofmap._dof_ordering;
   constrained_domain = dofmap.constrained_domain;
 }
 //-----------------------------------------------------------------------------
@@ -196,6 +202,33 @@ const std::set<int>& DofMap::neighbours() const
   return _neighbours;
 }
 //-----------------------------------------------------------------------------
+const std::vector<std::size_t>& DofMap::cells_with_unowned_dofs() const
+{
+  if (!_cells_with_unowned_dofs)
+  {
+    const std::size_t num_owned = _index_map->size(IndexMap::MapSize::OWNED);
+    const std::size_t num_cells
+      = _cell_dimension > 0 ? _dofmap.size()/_cell_dimension : 0;
+    std::shared_ptr<std::vector<std::size_t>>
+      cells(new std::vector<std::size_t>);
+    for (std::size_t c = 0; c < num_cells; ++c)
+    {
+      auto dofs = cell_dofs(c);
+      for (Eigen::Index i = 0; i < dofs.size(); ++i)
+      {
+        if ((std::size_t) dofs[i] >= num_owned)
+        {
+          cells->push_back(c);
+          break;
+        }
+      }
+    }
+    _cells_with_unowned_dofs = cells;
+  }
+
+  return *_cells_with_unowned_dofs;
+}
+//-----------------------------------------------------------------------------
 std::vector<dolfin::la_index> DofMap::entity_closure_dofs(
     const Mesh& mesh,
     std::size_t entity_dim,
@@ -459,7 +492,8 @@ std::shared_ptr<GenericDofMap> DofMap::create(const Mesh& new_mesh) const
 {
   // Get underlying UFC dof map
   std::shared_ptr<const ufc::dofmap> ufc_dof_map(_ufc_dofmap);
-  return std::shared_ptr<GenericDofMap>(new DofMap(ufc_dof_map, new_mesh));
+  return std::shared_ptr<GenericDofMap>(new DofMap(ufc_dof_map, new_mesh,
+                                                   nullptr, _dof_ordering));
 }
 //-----------------------------------------------------------------------------
 std::shared_ptr<GenericDofMap>
@@ -628,6 +662,50 @@ void DofMap::check_provided_entities(const ufc::dofmap& dofmap,
   }
 }
 //-----------------------------------------------------------------------------
+std::pair<std::size_t, std::size_t>
+DofMap::compute_bandwidth_and_profile() const
+{
+  dolfin_assert(_index_map);
+  const la_index num_owned = _index_map->size(IndexMap::MapSize::OWNED);
+
+  // Compute first coupled column of each owned row, and bandwidth
+  std::vector<la_index> first_column(num_owned);
+  for (la_index i = 0; i < num_owned; ++i)
+    first_column[i] = i;
+  std::size_t bandwidth = 0;
+  const std::size_t num_cells
+    = (_cell_dimension > 0) ? _dofmap.size()/_cell_dimension : 0;
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    const la_index* dofs = _dofmap.data() + c*_cell_dimension;
+    la_index min_dof = std::numeric_limits<la_index>::max();
+    la_index max_dof = -1;
+    for (std::size_t i = 0; i < _cell_dimension; ++i)
+    {
+      if (dofs[i] < num_owned)
+      {
+        min_dof = std::min(min_dof, dofs[i]);
+        max_dof = std::max(max_dof, dofs[i]);
+      }
+    }
+    if (max_dof < 0)
+      continue;
+
+    bandwidth = std::max(bandwidth, (std::size_t) (max_dof - min_dof));
+    for (std::size_t i = 0; i < _cell_dimension; ++i)
+    {
+      if (dofs[i] < num_owned)
+        first_column[dofs[i]] = std::min(first_column[dofs[i]], min_dof);
+    }
+  }
+
+  std::size_t profile = 0;
+  for (la_index i = 0; i < num_owned; ++i)
+    profile += i - first_column[i];
+
+  return {bandwidth, profile};
+}
+//-----------------------------------------------------------------------------
 std::string DofMap::str(bool verbose) const
 {
   std::stringstream s;
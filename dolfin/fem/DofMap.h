@@ -71,9 +71,18 @@ namespace dolfin
     /// @param[in] mesh (Mesh)
     ///         The mesh.
     /// @param[in] constrained_domain (SubDomain)
-    ///         The subdomain marking the constrained (tied) boundaries.
+    ///         The subdomain marking the constrained (tied) boundaries
+    ///         (may be a null pointer).
+    /// @param[in] dof_ordering (std::string)
+    ///         Ordering of the dofs owned by this process: "default"
+    ///         (use the global parameters "reorder_dofs_serial" and
+    ///         "dof_ordering_library"), "none", "rcm" (reverse
+    ///         Cuthill-McKee), "gps" (Gibbs-Poole-Stockmeyer),
+    ///         "nested_dissection", "hilbert" (cells along a Hilbert
+    ///         curve), "cell_order" or "random".
     DofMap(std::shared_ptr<const ufc::dofmap> ufc_dofmap,
-           const Mesh& mesh, std::shared_ptr<const SubDomain> constrained_domain);
+           const Mesh& mesh, std::shared_ptr<const SubDomain> constrained_domain,
+           std::string dof_ordering="default");
 
   private:
 
@@ -183,6 +192,15 @@ namespace dolfin
     ///         The set of processes
     const std::set<int>& neighbours() const;
 
+    /// Return local indices (sorted) of the cells with at least one
+    /// dof that is not owned by this process. The list is computed on
+    /// first call and stored with the dofmap, so that it is shared by
+    /// all assemblers using the dofmap.
+    ///
+    /// @return     std::vector<std::size_t>
+    ///         The cell indices
+    const std::vector<std::size_t>& cells_with_unowned_dofs() const;
+
     /// Clear any data required to build sub-dofmaps (this is to
     /// reduce memory use)
     void clear_sub_map_data()
@@ -391,6 +409,24 @@ namespace dolfin
     const std::vector<std::size_t>& local_to_global_unowned() const
     { return _index_map->local_to_global_unowned(); }
 
+    /// Return the dof ordering used to build the dofmap
+    ///
+    /// @return    std::string
+    ///         The dof ordering (see constructor).
+    std::string dof_ordering() const
+    { return _dof_ordering; }
+
+    /// Compute the bandwidth and profile of the matrix block coupling
+    /// the dofs owned by this process, with dofs coupled if they
+    /// share a cell. The bandwidth is the largest difference between
+    /// coupled (local) dof indices, and the profile is the sum over
+    /// rows of the distance from the diagonal to the first coupled
+    /// column.
+    ///
+    /// @return    std::pair<std::size_t, std::size_t>
+    ///         Bandwidth and profile.
+    std::pair<std::size_t, std::size_t> compute_bandwidth_and_profile() const;
+
     /// Return informal string representation (pretty-print)
     ///
     /// @param     verbose (bool)
@@ -462,6 +498,13 @@ namespace dolfin
     // Neighbours (processes that we share dofs with)
     std::set<int> _neighbours;
 
+    // Cells with dofs owned by other processes (computed on demand)
+    mutable std::shared_ptr<const std::vector<std::size_t>>
+      _cells_with_unowned_dofs;
+
+    // Dof ordering
+    std::string _dof_ordering;
+
   };
 }
 
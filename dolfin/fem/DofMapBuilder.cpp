@@ -22,7 +22,11 @@
 // Modified by Martin Alnaes, 2013-2015
 // Modified by Chris Richardson, 2014
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <numeric>
 #include <random>
 #include <utility>
 #include <memory>
@@ -37,6 +41,7 @@
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/MeshEntityIterator.h>
+#include <dolfin/mesh/MeshRenumbering.h>
 #include <dolfin/mesh/PeriodicBoundaryComputation.h>
 #include <dolfin/mesh/SubDomain.h>
 #include <dolfin/mesh/Vertex.h>
@@ -70,10 +75,24 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
   // Check if dofmap is distributed (based on mesh MPI communicator)
   const bool distributed = dolfin::MPI::size(mesh.mpi_comm()) > 1;
 
-  // Check if UFC dofmap should not be re-ordered (only applicable in
-  // serial)
-  const bool reorder_ufc = dolfin::parameters["reorder_dofs_serial"];
-  const bool reorder = (distributed or reorder_ufc) ? true : false;
+  // Determine dof ordering. The UFC dofmap is not re-ordered if the
+  // ordering is "none" (only applicable in serial).
+  std::string dof_ordering = dofmap._dof_ordering;
+  if (dof_ordering == "default")
+  {
+    const bool reorder_ufc = dolfin::parameters["reorder_dofs_serial"];
+    const std::string ordering_library
+      = dolfin::parameters["dof_ordering_library"];
+    if (!distributed and !reorder_ufc)
+      dof_ordering = "none";
+    else if (ordering_library == "Boost")
+      dof_ordering = "rcm";
+    else if (ordering_library == "SCOTCH")
+      dof_ordering = "gps";
+    else
+      dof_ordering = ordering_library;
+  }
+  const bool reorder = (distributed or dof_ordering != "none") ? true : false;
 
   // Sanity checks on UFC dofmap
   const std::size_t D = mesh.topology().dim();
@@ -176,6 +195,17 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
                            node_local_to_global0.size(),
                            *ufc_node_dofmap, mesh);
 
+    // Exchange data on shared nodes with neighbouring processes only
+    // (processes that share mesh vertices), unless the dofmap is
+    // constrained, in which case nodes may be shared by processes
+    // that are not neighbours in the mesh
+    bool neighbourhood_comm = false;
+    #ifdef HAS_MPI
+    const std::string dofmap_comm = dolfin::parameters["dofmap_communication"];
+    neighbourhood_comm = (dofmap_comm == "neighbourhood")
+      and !constrained_domain;
+    #endif
+
     // Compute:
     // (a) owned and shared nodes (and owned and un-owned):
     //    -1: unowned, 0: owned and shared, 1: owned and not shared;
@@ -190,7 +220,8 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
                                node_graph0,
                                shared_nodes, global_nodes0,
                                node_local_to_global0, mesh,
-                               dofmap._global_dimension/bs);
+                               dofmap._global_dimension/bs,
+                               neighbourhood_comm);
 
     dofmap._index_map->init(num_owned_nodes, bs);
 
@@ -212,7 +243,7 @@ void DofMapBuilder::build(DofMap& dofmap, const Mesh& mesh,
                             shared_node_to_processes0,
                             node_local_to_global0,
                             node_graph0, node_ownership0, global_nodes0,
-                            mesh.mpi_comm());
+                            dof_ordering, mesh);
 
     // Update UFC-local-to-local map to account for re-ordering
     if (constrained_domain)
@@ -644,20 +675,93 @@ DofMapBuilder::compute_node_ownership(
   const std::set<std::size_t>& global_nodes,
   const std::vector<std::size_t>& local_to_global,
   const Mesh& mesh,
-  const std::size_t global_dim)
+  const std::size_t global_dim,
+  const bool neighbourhood_comm)
 {
   log(TRACE, "Determining node ownership for parallel dof map");
 
+  // Initialise node ownership array, provisionally all owned
+  node_ownership.assign(local_to_global.size(), 1);
+
+  // Determine ownership of nodes on process boundaries and the
+  // processes that share them
+  if (neighbourhood_comm)
+  {
+    compute_shared_node_ownership_neighbourhood(node_ownership,
+                                                shared_node_to_processes,
+                                                shared_nodes,
+                                                local_to_global, mesh);
+  }
+  else
+  {
+    compute_shared_node_ownership_global(node_ownership,
+                                         shared_node_to_processes,
+                                         shared_nodes, local_to_global,
+                                         mesh, global_dim);
+  }
+
+  // Get number of processes and process rank
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const std::size_t num_processes = MPI::size(mpi_comm);
+  const std::size_t process_number = MPI::rank(mpi_comm);
+
+  // Build set of neighbouring processes
+  neighbours.clear();
+  for (auto it = shared_node_to_processes.begin();
+       it != shared_node_to_processes.end(); ++it)
+  {
+    neighbours.insert(it->second.begin(), it->second.end());
+  }
+
+  // Count number of owned nodes
+  int num_owned_nodes = 0;
+  for (std::size_t i = 0; i < node_ownership.size(); ++i)
+  {
+    if (node_ownership[i] >= 0)
+      ++num_owned_nodes;
+  }
+
+  // Shared ownership for global dofs (after neighbour calculation)
+  std::vector<int> all_procs;
+  for (unsigned int i=0; i != num_processes; ++i)
+    if (i != process_number)
+      all_procs.push_back((int)i);
+
+  // Add/remove global dofs to/from relevant sets (last process owns
+  // global nodes)
+  for (auto node = global_nodes.begin(); node != global_nodes.end(); ++node)
+  {
+    dolfin_assert(*node < node_ownership.size());
+    if (process_number == num_processes - 1)
+    {
+      node_ownership[*node] = 0;
+    }
+    else
+    {
+      node_ownership[*node] = -1;
+      --num_owned_nodes;
+    }
+    shared_node_to_processes.insert(std::make_pair(*node, all_procs));
+  }
+
+  log(TRACE, "Finished determining dof ownership for parallel dof map");
+  return num_owned_nodes;
+}
+//-----------------------------------------------------------------------------
+void DofMapBuilder::compute_shared_node_ownership_global(
+  std::vector<short int>& node_ownership,
+  std::unordered_map<int, std::vector<int>>& shared_node_to_processes,
+  const std::vector<int>& shared_nodes,
+  const std::vector<std::size_t>& local_to_global,
+  const Mesh& mesh,
+  const std::size_t global_dim)
+{
   // Get number of nodes
   const std::size_t num_nodes_local = local_to_global.size();
 
   // Global-to-local node map for nodes on boundary
   std::map<std::size_t, int> global_to_local;
 
-  // Initialise node ownership array, provisionally all owned
-  node_ownership.resize(num_nodes_local);
-  std::fill(node_ownership.begin(), node_ownership.end(), 1);
-
   // Communication buffers
   const MPI_Comm mpi_comm = mesh.mpi_comm();
   const std::size_t num_processes = MPI::size(mpi_comm);
@@ -807,48 +911,143 @@ DofMapBuilder::compute_node_ownership(
       q += num_sharing + 1;
     }
   }
+}
+//-----------------------------------------------------------------------------
+void DofMapBuilder::compute_shared_node_ownership_neighbourhood(
+  std::vector<short int>& node_ownership,
+  std::unordered_map<int, std::vector<int>>& shared_node_to_processes,
+  const std::vector<int>& shared_nodes,
+  const std::vector<std::size_t>& local_to_global,
+  const Mesh& mesh)
+{
+  #ifdef HAS_MPI
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+  const int process_number = MPI::rank(mpi_comm);
 
-  // Build set of neighbouring processes
-  neighbours.clear();
-  for (auto it = shared_node_to_processes.begin();
-       it != shared_node_to_processes.end(); ++it)
+  // Get number of nodes
+  const std::size_t num_nodes_local = local_to_global.size();
+
+  // Build list of neighbouring processes (processes that share mesh
+  // vertices with this process). A process that holds a node on the
+  // process boundary also holds the vertices of the mesh entity that
+  // the node is associated with, so all processes sharing a node are
+  // neighbours of each other.
+  std::vector<int> neighbours;
+  for (auto& v : mesh.topology().shared_entities(0))
+    neighbours.insert(neighbours.end(), v.second.begin(), v.second.end());
+  std::sort(neighbours.begin(), neighbours.end());
+  neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                   neighbours.end());
+
+  // Buffer global indices of boundary nodes (candidates for
+  // ownership), preceded by their number, followed by ghost and
+  // ghost-shared nodes (shared, but not candidates for ownership),
+  // and build sorted global-to-local map for these nodes
+  std::vector<std::size_t> send_buffer(1, 0);
+  std::vector<std::pair<std::size_t, int>> global_to_local;
+  for (std::size_t i = 0; i < num_nodes_local; ++i)
   {
-    neighbours.insert(it->second.begin(), it->second.end());
+    if (shared_nodes[i] == 0)
+    {
+      send_buffer.push_back(local_to_global[i]);
+      global_to_local.push_back({local_to_global[i], i});
+    }
   }
-
-  // Count number of owned nodes
-  int num_owned_nodes = 0;
-  for (std::size_t i = 0; i < node_ownership.size(); ++i)
+  send_buffer[0] = send_buffer.size() - 1;
+  for (std::size_t i = 0; i < num_nodes_local; ++i)
   {
-    if (node_ownership[i] >= 0)
-      ++num_owned_nodes;
+    if (shared_nodes[i] == -3 or shared_nodes[i] == -2)
+    {
+      send_buffer.push_back(local_to_global[i]);
+      global_to_local.push_back({local_to_global[i], i});
+    }
   }
+  std::sort(global_to_local.begin(), global_to_local.end());
+
+  // Send the same data to all neighbours
+  MPI_Comm neighbour_comm = MPI::create_neighbour_comm(mpi_comm, neighbours);
+  std::vector<std::size_t> recv_buffer;
+  std::vector<int> recv_offsets;
+  MPI::neighbour_all_to_all(neighbour_comm, send_buffer, recv_buffer,
+                            recv_offsets);
+  MPI_Comm_free(&neighbour_comm);
+  std::vector<std::size_t>().swap(send_buffer);
+
+  // Find received nodes that are also on this process, and store
+  // [local node index, sending process, 1 if the sending process is a
+  // candidate owner (0 otherwise)]
+  std::vector<std::array<int, 3>> matches;
+  for (std::size_t n = 0; n < neighbours.size(); ++n)
+  {
+    dolfin_assert(recv_offsets[n + 1] > recv_offsets[n]);
+    const std::size_t* data = recv_buffer.data() + recv_offsets[n];
+    const std::size_t size = recv_offsets[n + 1] - recv_offsets[n];
+    const std::size_t num_boundary_nodes = data[0];
+    for (std::size_t j = 1; j < size; ++j)
+    {
+      auto it = std::lower_bound(global_to_local.begin(),
+                                 global_to_local.end(),
+                                 std::make_pair(data[j], 0));
+      if (it != global_to_local.end() and it->first == data[j])
+      {
+        const int is_candidate = (j <= num_boundary_nodes) ? 1 : 0;
+        matches.push_back({{it->second, neighbours[n], is_candidate}});
+      }
+    }
+  }
+  std::vector<std::size_t>().swap(recv_buffer);
+  std::vector<std::pair<std::size_t, int>>().swap(global_to_local);
 
-  // Shared ownership for global dofs (after neighbour calculation)
-  std::vector<int> all_procs;
-  for (unsigned int i=0; i != num_processes; ++i)
-    if (i != process_number)
-      all_procs.push_back((int)i);
+  // Sort by local node index (and process)
+  std::sort(matches.begin(), matches.end());
 
-  // Add/remove global dofs to/from relevant sets (last process owns
-  // global nodes)
-  for (auto node = global_nodes.begin(); node != global_nodes.end(); ++node)
+  // Determine ownership and sharing processes for each shared node
+  std::vector<int> candidates;
+  auto m = matches.begin();
+  while (m != matches.end())
   {
-    dolfin_assert(*node < node_ownership.size());
-    if (process_number == num_processes - 1)
+    const int node = (*m)[0];
+    const int node_status = shared_nodes[node];
+    dolfin_assert(node_status != -1);
+
+    candidates.clear();
+    if (node_status == 0)
+      candidates.push_back(process_number);
+
+    std::vector<int> sharing_procs;
+    for (; m != matches.end() and (*m)[0] == node; ++m)
     {
-      node_ownership[*node] = 0;
+      sharing_procs.push_back((*m)[1]);
+      if ((*m)[2] == 1)
+        candidates.push_back((*m)[1]);
     }
+
+    // First check to see if this is a ghost/ghost-shared node, and
+    // set ownership accordingly. Otherwise pick the owner from the
+    // candidates using a hash of the global index, which all sharing
+    // processes agree on
+    if (node_status == -2)
+      node_ownership[node] = 0;
+    else if (node_status == -3)
+      node_ownership[node] = -1;
     else
     {
-      node_ownership[*node] = -1;
-      --num_owned_nodes;
+      std::sort(candidates.begin(), candidates.end());
+      std::uint64_t h = local_to_global[node];
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      const int owner = candidates[h % candidates.size()];
+      node_ownership[node] = (owner == process_number) ? 0 : -1;
     }
-    shared_node_to_processes.insert(std::make_pair(*node, all_procs));
-  }
 
-  log(TRACE, "Finished determining dof ownership for parallel dof map");
-  return num_owned_nodes;
+    shared_node_to_processes[node] = sharing_procs;
+  }
+  #else
+  dolfin_error("DofMapBuilder.cpp",
+               "compute node ownership",
+               "Neighbourhood communication requires DOLFIN with MPI");
+  #endif
 }
 //-----------------------------------------------------------------------------
 std::set<std::size_t> DofMapBuilder::compute_global_dofs(
@@ -1478,8 +1677,11 @@ void DofMapBuilder::compute_node_reordering(
   const std::vector<std::vector<la_index>>& node_dofmap,
   const std::vector<short int>& node_ownership,
   const std::set<std::size_t>& global_nodes,
-  MPI_Comm mpi_comm)
+  const std::string& dof_ordering,
+  const Mesh& mesh)
 {
+  const MPI_Comm mpi_comm = mesh.mpi_comm();
+
   // Count number of locally owned nodes
   std::size_t owned_local_size = 0;
   std::size_t unowned_local_size = 0;
@@ -1498,21 +1700,20 @@ void DofMapBuilder::compute_node_reordering(
   dolfin_assert((unowned_local_size+owned_local_size)
                 == old_local_to_global.size());
 
-  // Create global-to-local index map for local un-owned nodes
-  std::vector<std::pair<std::size_t, int>> node_pairs;
-  node_pairs.reserve(unowned_local_size);
+  // Create (sorted) global-to-local index map for local un-owned
+  // nodes
+  std::vector<std::pair<std::size_t, int>> global_to_local_nodes_unowned;
+  global_to_local_nodes_unowned.reserve(unowned_local_size);
   for (std::size_t i = 0; i < node_ownership.size(); ++i)
   {
     if (node_ownership[i] == -1)
-      node_pairs.push_back(std::make_pair(old_local_to_global[i] , i));
+    {
+      global_to_local_nodes_unowned.push_back(
+        std::make_pair(old_local_to_global[i] , i));
+    }
   }
-  std::map<std::size_t, int>
-    global_to_local_nodes_unowned(node_pairs.begin(), node_pairs.end());
-  std::vector<std::pair<std::size_t, int>>().swap(node_pairs);
-
-  // Build graph for re-ordering. Below block is scoped to clear
-  // working data structures once graph is constructed.
-  Graph graph(owned_local_size);
+  std::sort(global_to_local_nodes_unowned.begin(),
+            global_to_local_nodes_unowned.end());
 
   // Create contiguous local numbering for locally owned dofs
   std::size_t my_counter = 0;
@@ -1523,9 +1724,15 @@ void DofMapBuilder::compute_node_reordering(
       old_to_contiguous_node_index[i] = my_counter++;
   }
 
+  // Build graph for re-ordering (only for graph based orderings)
+  const bool graph_ordering = (dof_ordering == "rcm" or dof_ordering == "gps"
+                               or dof_ordering == "nested_dissection");
+  Graph graph(graph_ordering ? owned_local_size : 0);
+
   // Build local graph, based on old dof map, with contiguous
   // numbering
-  for (std::size_t cell = 0; cell < node_dofmap.size(); ++cell)
+  for (std::size_t cell = 0; graph_ordering and cell < node_dofmap.size();
+       ++cell)
   {
     // Cell dofmaps with old local indices
     const std::vector<la_index>& nodes = node_dofmap[cell];
@@ -1559,18 +1766,69 @@ void DofMapBuilder::compute_node_reordering(
   }
 
   // Reorder nodes
-  const std::string ordering_library
-    = dolfin::parameters["dof_ordering_library"];
   std::vector<int> node_remap;
-  if (ordering_library == "Boost")
+  if (dof_ordering == "rcm")
     node_remap = BoostGraphOrdering::compute_cuthill_mckee(graph, true);
-  else if (ordering_library == "SCOTCH")
+  else if (dof_ordering == "gps")
     node_remap = SCOTCH::compute_gps(graph);
-  else if (ordering_library == "random")
+  else if (dof_ordering == "nested_dissection")
+  {
+    // Default SCOTCH ordering strategy (nested dissection)
+    node_remap = SCOTCH::compute_reordering(graph);
+  }
+  else if (dof_ordering == "none")
+  {
+    node_remap.resize(owned_local_size);
+    std::iota(node_remap.begin(), node_remap.end(), 0);
+  }
+  else if (dof_ordering == "cell_order" or dof_ordering == "hilbert")
+  {
+    // Sequence of cells, in mesh order or along a Hilbert curve
+    // through the cell midpoints
+    std::vector<std::size_t> cells(node_dofmap.size());
+    if (dof_ordering == "hilbert")
+    {
+      dolfin_assert(node_dofmap.size() == mesh.num_cells());
+      const std::size_t gdim = mesh.geometry().dim();
+      std::vector<double> midpoints(mesh.num_cells()*gdim);
+      for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
+      {
+        const Point p = cell->midpoint();
+        std::copy(p.coordinates(), p.coordinates() + gdim,
+                  midpoints.begin() + cell->index()*gdim);
+      }
+      cells = MeshRenumbering::compute_hilbert_order(midpoints, gdim);
+    }
+    else
+      std::iota(cells.begin(), cells.end(), 0);
+
+    // Number nodes in the order they are first visited by the cells
+    node_remap.assign(owned_local_size, -1);
+    int counter = 0;
+    for (auto cell : cells)
+    {
+      for (auto node : node_dofmap[cell])
+      {
+        if (global_nodes.find(node) != global_nodes.end())
+          continue;
+        const int n_local = old_to_contiguous_node_index[node];
+        if (n_local != -1 and node_remap[n_local] == -1)
+          node_remap[n_local] = counter++;
+      }
+    }
+
+    // Number remaining (global) nodes last
+    for (auto& n : node_remap)
+    {
+      if (n == -1)
+        n = counter++;
+    }
+  }
+  else if (dof_ordering == "random")
   {
     // NOTE: Randomised dof ordering should only be used for
     // testing/benchmarking
-    node_remap.resize(graph.size());
+    node_remap.resize(owned_local_size);
     for (std::size_t i = 0; i < node_remap.size(); ++i)
       node_remap[i] = i;
     std::random_shuffle(node_remap.begin(), node_remap.end());
@@ -1579,8 +1837,8 @@ void DofMapBuilder::compute_node_reordering(
   {
     dolfin_error("DofMapBuilder.cpp",
                  "reorder degrees of freedom",
-                 "The requested ordering library '%s' is unknown",
-                 ordering_library.c_str());
+                 "The requested dof ordering '%s' is unknown",
+                 dof_ordering.c_str());
   }
 
   // Compute offset for owned nodes
@@ -1591,11 +1849,37 @@ void DofMapBuilder::compute_node_reordering(
   old_to_new_local.clear();
   old_to_new_local.resize(node_ownership.size(), -1);
 
+  // Processes to exchange data with. Global nodes are shared with
+  // all processes; otherwise only processes that share nodes with
+  // this process are involved (neighbourhood communication).
+  const std::size_t mpi_size = MPI::size(mpi_comm);
+  bool neighbourhood_comm = false;
+  #ifdef HAS_MPI
+  const std::string dofmap_comm = dolfin::parameters["dofmap_communication"];
+  neighbourhood_comm = (dofmap_comm == "neighbourhood")
+    and global_nodes.empty();
+  #endif
+  std::vector<int> neighbours;
+  if (neighbourhood_comm)
+  {
+    for (auto& node : node_to_sharing_processes)
+    {
+      neighbours.insert(neighbours.end(), node.second.begin(),
+                        node.second.end());
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                     neighbours.end());
+  }
+  else
+  {
+    neighbours.resize(mpi_size);
+    std::iota(neighbours.begin(), neighbours.end(), 0);
+  }
+
   // Renumber owned nodes, and buffer nodes that are owned but shared
   // with another process
-  const std::size_t mpi_size = MPI::size(mpi_comm);
-  std::vector<std::vector<std::size_t>> send_buffer(mpi_size);
-  std::vector<std::vector<std::size_t>> recv_buffer(mpi_size);
+  std::vector<std::vector<std::size_t>> send_buffer(neighbours.size());
   std::size_t counter = 0;
   for (std::size_t old_node_index_local = 0;
        old_node_index_local < node_ownership.size();
@@ -1619,9 +1903,15 @@ void DofMapBuilder::compute_node_reordering(
       {
         for (auto p = it->second.begin(); p != it->second.end(); ++p)
         {
+          // Position of process in neighbour list
+          const std::size_t n
+            = std::lower_bound(neighbours.begin(), neighbours.end(), *p)
+            - neighbours.begin();
+          dolfin_assert(n < neighbours.size() and neighbours[n] == *p);
+
           // Buffer old and new global indices to send
-          send_buffer[*p].push_back(old_local_to_global[old_node_index_local]);
-          send_buffer[*p].push_back(process_offset + node_remap[counter]);
+          send_buffer[n].push_back(old_local_to_global[old_node_index_local]);
+          send_buffer[n].push_back(process_offset + node_remap[counter]);
         }
       }
 
@@ -1629,33 +1919,58 @@ void DofMapBuilder::compute_node_reordering(
     ++counter;
   }
 
+  // Send old and new global indices of shared nodes to the sharing
+  // processes (in order of process rank)
+  std::vector<std::size_t> recv_buffer;
+  #ifdef HAS_MPI
+  if (neighbourhood_comm)
+  {
+    // Flatten send buffer
+    std::vector<int> send_offsets(1, 0);
+    std::vector<std::size_t> send_data;
+    for (auto& data : send_buffer)
+    {
+      send_data.insert(send_data.end(), data.begin(), data.end());
+      send_offsets.push_back(send_data.size());
+      std::vector<std::size_t>().swap(data);
+    }
+
+    MPI_Comm neighbour_comm = MPI::create_neighbour_comm(mpi_comm,
+                                                         neighbours);
+    std::vector<int> recv_offsets;
+    MPI::neighbour_all_to_all(neighbour_comm, send_data, send_offsets,
+                              recv_buffer, recv_offsets);
+    MPI_Comm_free(&neighbour_comm);
+  }
+  else
+    MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+  #else
   MPI::all_to_all(mpi_comm, send_buffer, recv_buffer);
+  #endif
 
   std::vector<std::size_t> local_to_global_unowned(unowned_local_size);
-  //  off_process_owner.resize(unowned_local_size);
   std::size_t off_process_node_counter = 0;
-
-  for (std::size_t src = 0; src != mpi_size; ++src)
-    for (auto q = recv_buffer[src].begin();
-         q != recv_buffer[src].end(); q += 2)
-    {
-      const std::size_t received_old_node_index_global = *q;
-      const std::size_t received_new_node_index_global = *(q + 1);
-
-      auto it
-        = global_to_local_nodes_unowned.find(received_old_node_index_global);
-      dolfin_assert(it != global_to_local_nodes_unowned.end());
-
-      const int received_old_node_index_local = it->second;
-      local_to_global_unowned[off_process_node_counter]
-        = received_new_node_index_global;
-      // off_process_owner[off_process_node_counter] = src;
-
-      const int new_index_local = owned_local_size + off_process_node_counter;
-      dolfin_assert(old_to_new_local[received_old_node_index_local] < 0);
-      old_to_new_local[received_old_node_index_local] = new_index_local;
-      off_process_node_counter++;
-    }
+  for (auto q = recv_buffer.begin(); q != recv_buffer.end(); q += 2)
+  {
+    const std::size_t received_old_node_index_global = *q;
+    const std::size_t received_new_node_index_global = *(q + 1);
+
+    auto it = std::lower_bound(global_to_local_nodes_unowned.begin(),
+                               global_to_local_nodes_unowned.end(),
+                               std::make_pair(received_old_node_index_global,
+                                              0));
+    dolfin_assert(it != global_to_local_nodes_unowned.end());
+    dolfin_assert(it->first == received_old_node_index_global);
+
+    const int received_old_node_index_local = it->second;
+    local_to_global_unowned[off_process_node_counter]
+      = received_new_node_index_global;
+
+    const int new_index_local = owned_local_size + off_process_node_counter;
+    dolfin_assert(old_to_new_local[received_old_node_index_local] < 0);
+    old_to_new_local[received_old_node_index_local] = new_index_local;
+    off_process_node_counter++;
+  }
 
   index_map.set_local_to_global(local_to_global_unowned);
 
@@ -98,7 +98,9 @@ namespace dolfin
     //     shared
     //
     // Also computes map from shared node to sharing processes and a
-    // set of process that share dofs on this process.
+    // set of process that share dofs on this process. If
+    // neighbourhood_comm is true, data is exchanged only with
+    // processes that share mesh vertices with this process.
     // Returns: number of locally owned nodes
     static int compute_node_ownership(
       std::vector<short int>& node_ownership,
@@ -109,8 +111,33 @@ namespace dolfin
       const std::set<std::size_t>& global_nodes,
       const std::vector<std::size_t>& node_local_to_global,
       const Mesh& mesh,
+      const std::size_t global_dim,
+      const bool neighbourhood_comm);
+
+    // Compute ownership of nodes on process boundaries and the map
+    // from shared node to sharing processes. Each node is sent to the
+    // process that owns its global index (all-to-all communication),
+    // which picks the owner and collects the sharing processes.
+    static void compute_shared_node_ownership_global(
+      std::vector<short int>& node_ownership,
+      std::unordered_map<int, std::vector<int>>& shared_node_to_processes,
+      const std::vector<int>& boundary_nodes,
+      const std::vector<std::size_t>& node_local_to_global,
+      const Mesh& mesh,
       const std::size_t global_dim);
 
+    // Compute ownership of nodes on process boundaries and the map
+    // from shared node to sharing processes. Boundary nodes are sent
+    // to the processes that share mesh vertices with this process
+    // (neighbourhood collective communication), and the owner of
+    // each node is picked consistently by all sharing processes.
+    static void compute_shared_node_ownership_neighbourhood(
+      std::vector<short int>& node_ownership,
+      std::unordered_map<int, std::vector<int>>& shared_node_to_processes,
+      const std::vector<int>& boundary_nodes,
+      const std::vector<std::size_t>& node_local_to_global,
+      const Mesh& mesh);
+
     // Build dofmap based on re-ordered nodes
     static void
       build_dofmap(std::vector<std::vector<la_index>>& dofmap,
@@ -192,7 +219,8 @@ namespace dolfin
       const std::vector<std::vector<la_index>>& node_dofmap,
       const std::vector<short int>& node_ownership,
       const std::set<std::size_t>& global_nodes,
-      const MPI_Comm mpi_comm);
+      const std::string& dof_ordering,
+      const Mesh& mesh);
 
     static void get_cell_entities_local(const Cell& cell,
       std::vector<std::vector<std::size_t>>& entity_indices,
@@ -197,6 +197,10 @@ namespace dolfin
     /// Return set of processes that share dofs with the this process
     virtual const std::set<int>& neighbours() const = 0;
 
+    /// Return local indices (sorted) of the cells with at least one
+    /// dof that is not owned by this process
+    virtual const std::vector<std::size_t>& cells_with_unowned_dofs() const = 0;
+
     /// Clear any data required to build sub-dofmaps (this is to
     /// reduce memory use)
     virtual void clear_sub_map_data() = 0;
@@ -0,0 +1,342 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <sstream>
+
+#include <dolfin/common/ArrayView.h>
+#include <dolfin/common/Timer.h>
+#include <dolfin/function/Function.h>
+#include <dolfin/function/FunctionSpace.h>
+#include <dolfin/function/GenericFunction.h>
+#include <dolfin/la/GenericVector.h>
+#include <dolfin/la/IndexMap.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Facet.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshFunction.h>
+#include "Form.h"
+#include "GenericDofMap.h"
+#include "UFC.h"
+#include "MatrixFreeOperator.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Pack cell coordinate dofs of affine mesh, if not already packed
+  // (the packed array is invalid once the modification count of the
+  // geometry has changed, e.g. by mesh motion)
+  void pack_coordinate_dofs(const Mesh& mesh)
+  {
+    const MeshGeometry& geometry = mesh.geometry();
+    if (geometry.degree() != 1 || geometry.has_packed_coordinate_dofs())
+      return;
+
+    // Packing the coordinate dofs does not change the mesh geometry,
+    // it only caches data that can be computed from it, hence the
+    // const_cast (as in Mesh::init)
+    const_cast<Mesh&>(mesh).geometry().init_packed_coordinate_dofs(
+      mesh.topology());
+  }
+
+  // Create UFC data for form if it does not exist or if the form
+  // coefficients have changed
+  void update_ufc(std::unique_ptr<UFC>& ufc,
+                  std::vector<std::shared_ptr<const GenericFunction>>& coefficients,
+                  const Form& a)
+  {
+    if (!ufc || coefficients != a.coefficients())
+    {
+      coefficients = a.coefficients();
+      ufc.reset(new UFC(a));
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+MatrixFreeOperator::MatrixFreeOperator(std::shared_ptr<const Form> a_action,
+                                       std::shared_ptr<Function> u,
+                                       std::shared_ptr<const Form> a)
+  : LinearOperator(*u->vector(), *u->vector()), _a_action(a_action), _u(u),
+    _a(a)
+{
+  dolfin_assert(_a_action);
+  dolfin_assert(_u);
+
+  // Check action form
+  if (_a_action->rank() != 1)
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "create matrix-free operator",
+                 "Action form must be linear (rank 1), but has rank %d",
+                 _a_action->rank());
+  }
+
+  // Check that u is a coefficient of the action form
+  const std::vector<std::shared_ptr<const GenericFunction>> coefficients
+    = _a_action->coefficients();
+  if (std::find(coefficients.begin(), coefficients.end(), _u)
+      == coefficients.end())
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "create matrix-free operator",
+                 "Function is not a coefficient of the action form");
+  }
+
+  // Check bilinear form (if any)
+  if (_a && _a->rank() != 2)
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "create matrix-free operator",
+                 "Form must be bilinear (rank 2), but has rank %d",
+                 _a->rank());
+  }
+}
+//-----------------------------------------------------------------------------
+MatrixFreeOperator::~MatrixFreeOperator()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+std::size_t MatrixFreeOperator::size(std::size_t dim) const
+{
+  if (dim == 0)
+    return _a_action->function_space(0)->dim();
+  else
+    return _u->function_space()->dim();
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::mult(const GenericVector& x, GenericVector& y) const
+{
+  Timer timer("Matrix-free operator action");
+
+  const Form& a_action = *_a_action;
+  dolfin_assert(a_action.mesh());
+  pack_coordinate_dofs(*a_action.mesh());
+
+  // Copy x to coefficient (this updates the ghost values of u)
+  *_u->vector() = x;
+
+  // Initialise or zero y
+  _assembler.add_values = false;
+  _assembler.init_global_tensor(y, a_action);
+
+  // Assemble action, reusing UFC data between products
+  update_ufc(_ufc_action, _action_coefficients, a_action);
+  UFC& ufc = *_ufc_action;
+  _assembler.assemble_cells(y, a_action, ufc, a_action.cell_domains(),
+                            NULL);
+  _assembler.assemble_exterior_facets(y, a_action, ufc,
+                                      a_action.exterior_facet_domains(),
+                                      NULL);
+  _assembler.assemble_interior_facets(y, a_action, ufc,
+                                      a_action.interior_facet_domains(),
+                                      a_action.cell_domains(), NULL);
+  _assembler.assemble_vertices(y, a_action, ufc, a_action.vertex_domains());
+
+  y.apply("add");
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::get_diagonal(GenericVector& x) const
+{
+  if (!_a)
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "compute diagonal of matrix-free operator",
+                 "The bilinear form has not been given");
+  }
+
+  Timer timer("Matrix-free operator diagonal");
+
+  // Check that the diagonal of the element matrices is well defined
+  const Form& a = *_a;
+  if (a.function_space(0)->dofmap() != a.function_space(1)->dofmap())
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "compute diagonal of matrix-free operator",
+                 "Test and trial spaces must have the same dofmap");
+  }
+
+  // Only cell and exterior facet integrals are supported
+  const ufc::form& form = *a.ufc_form();
+  if (form.has_interior_facet_integrals() || form.has_vertex_integrals()
+      || form.has_custom_integrals() || form.has_cutcell_integrals()
+      || form.has_interface_integrals() || form.has_overlap_integrals())
+  {
+    dolfin_error("MatrixFreeOperator.cpp",
+                 "compute diagonal of matrix-free operator",
+                 "Only cell and exterior facet integrals are supported");
+  }
+
+  dolfin_assert(a.mesh());
+  pack_coordinate_dofs(*a.mesh());
+
+  // Initialise or zero x with the layout of the action
+  _assembler.add_values = false;
+  _assembler.init_global_tensor(x, *_a_action);
+
+  // Assemble diagonal entries of element matrices. Entries are added
+  // with global indices, since x may have no local-to-global map
+  // (e.g. when created by PETSc for the Jacobi preconditioner), and
+  // entries for unowned dofs are communicated by apply()
+  update_ufc(_ufc, _coefficients, a);
+  assemble_diagonal_cells(x, *_ufc);
+  assemble_diagonal_exterior_facets(x, *_ufc);
+
+  x.apply("add");
+}
+//-----------------------------------------------------------------------------
+std::string MatrixFreeOperator::str(bool verbose) const
+{
+  std::stringstream s;
+  s << "<MatrixFreeOperator of size " << size(0) << " x " << size(1) << ">";
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::assemble_diagonal_cells(GenericVector& x,
+                                                 UFC& ufc) const
+{
+  if (!ufc.form.has_cell_integrals())
+    return;
+
+  const Form& a = *_a;
+  const Mesh& mesh = *a.mesh();
+  const GenericDofMap& dofmap = *a.function_space(0)->dofmap();
+  dolfin_assert(dofmap.index_map());
+  const IndexMap& index_map = *dofmap.index_map();
+
+  std::shared_ptr<const MeshFunction<std::size_t>> domains
+    = a.cell_domains();
+  const bool use_domains = domains && !domains->empty();
+  const ufc::cell_integral* integral = ufc.default_cell_integral.get();
+
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  std::vector<double> diagonal;
+  std::vector<dolfin::la_index> global_dofs;
+  for (CellIterator cell(mesh); !cell.end(); ++cell)
+  {
+    // Get integral for sub domain (if any)
+    if (use_domains)
+      integral = ufc.get_cell_integral((*domains)[*cell]);
+
+    // Skip if no integral on current domain
+    if (!integral)
+      continue;
+
+    // Skip if cell has no dofs
+    auto dofs = dofmap.cell_dofs(cell->index());
+    const std::size_t n = dofs.size();
+    if (n == 0)
+      continue;
+
+    // Update to current cell
+    cell->get_cell_data(ufc_cell);
+    const ArrayView<const double> cell_coordinate_dofs
+      = cell->coordinate_dofs(coordinate_dofs);
+    ufc.update(*cell, cell_coordinate_dofs.data(), ufc_cell,
+               integral->enabled_coefficients());
+
+    // Tabulate cell tensor and add its diagonal to x
+    integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                              cell_coordinate_dofs.data(),
+                              ufc_cell.orientation);
+    diagonal.resize(n);
+    global_dofs.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      diagonal[i] = ufc.A[i*n + i];
+      global_dofs[i] = index_map.local_to_global(dofs[i]);
+    }
+    x.add(diagonal.data(), n, global_dofs.data());
+  }
+}
+//-----------------------------------------------------------------------------
+void MatrixFreeOperator::assemble_diagonal_exterior_facets(GenericVector& x,
+                                                           UFC& ufc) const
+{
+  if (!ufc.form.has_exterior_facet_integrals())
+    return;
+
+  const Form& a = *_a;
+  const Mesh& mesh = *a.mesh();
+  const GenericDofMap& dofmap = *a.function_space(0)->dofmap();
+  dolfin_assert(dofmap.index_map());
+  const IndexMap& index_map = *dofmap.index_map();
+
+  std::shared_ptr<const MeshFunction<std::size_t>> domains
+    = a.exterior_facet_domains();
+  const bool use_domains = domains && !domains->empty();
+  const ufc::exterior_facet_integral* integral
+    = ufc.default_exterior_facet_integral.get();
+
+  // Compute facets and facet - cell connectivity if not already computed
+  const std::size_t D = mesh.topology().dim();
+  mesh.init(D - 1);
+  mesh.init(D - 1, D);
+
+  ufc::cell ufc_cell;
+  std::vector<double> coordinate_dofs;
+  std::vector<double> diagonal;
+  std::vector<dolfin::la_index> global_dofs;
+  for (FacetIterator facet(mesh); !facet.end(); ++facet)
+  {
+    // Only consider exterior facets
+    if (!facet->exterior())
+      continue;
+
+    // Get integral for sub domain (if any)
+    if (use_domains)
+      integral = ufc.get_exterior_facet_integral((*domains)[*facet]);
+
+    // Skip integral if zero
+    if (!integral)
+      continue;
+
+    // Get mesh cell to which mesh facet belongs
+    dolfin_assert(facet->num_entities(D) == 1);
+    Cell cell(mesh, facet->entities(D)[0]);
+    auto dofs = dofmap.cell_dofs(cell.index());
+    const std::size_t n = dofs.size();
+    if (n == 0)
+      continue;
+
+    // Update to current cell and facet
+    const std::size_t local_facet = cell.index(*facet);
+    cell.get_cell_data(ufc_cell, local_facet);
+    const ArrayView<const double> cell_coordinate_dofs
+      = cell.coordinate_dofs(coordinate_dofs);
+    ufc.update(cell, cell_coordinate_dofs.data(), ufc_cell,
+               integral->enabled_coefficients());
+
+    // Tabulate exterior facet tensor and add its diagonal to x
+    integral->tabulate_tensor(ufc.A.data(), ufc.w(),
+                              cell_coordinate_dofs.data(), local_facet,
+                              ufc_cell.orientation);
+    diagonal.resize(n);
+    global_dofs.resize(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      diagonal[i] = ufc.A[i*n + i];
+      global_dofs[i] = index_map.local_to_global(dofs[i]);
+    }
+    x.add(diagonal.data(), n, global_dofs.data());
+  }
+}
+//-----------------------------------------------------------------------------
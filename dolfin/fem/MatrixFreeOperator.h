@@ -0,0 +1,120 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __MATRIX_FREE_OPERATOR_H
+#define __MATRIX_FREE_OPERATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <dolfin/la/LinearOperator.h>
+#include "Assembler.h"
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Form;
+  class Function;
+  class GenericFunction;
+  class GenericVector;
+  class UFC;
+
+  /// This class defines a linear operator whose action on a vector
+  /// is computed by assembling the action of a bilinear form, without
+  /// assembling a matrix. The action is given as a linear form in
+  /// which the trial function of the bilinear form is replaced by a
+  /// coefficient _Function_ u. On each call to mult(x, y), the
+  /// values of x are copied to u and the action form is assembled
+  /// into y using the cell and facet loops of _Assembler_, with UFC
+  /// data created once for the operator. For affine meshes, the cell
+  /// coordinate dofs are packed (see
+  /// MeshGeometry::init_packed_coordinate_dofs) so that the geometry
+  /// is not gathered for each cell on each product.
+  ///
+  /// If the bilinear form is given, the diagonal of the operator can
+  /// be computed with get_diagonal(). This is used by the PETSc
+  /// Jacobi preconditioner when the operator is passed to a
+  /// _PETScKrylovSolver_. Computing the diagonal is supported for
+  /// forms with cell and exterior facet integrals.
+
+  class MatrixFreeOperator : public LinearOperator
+  {
+  public:
+
+    /// Create matrix-free operator
+    ///
+    /// @param[in] a_action (Form)
+    ///         The action of the bilinear form (a linear form).
+    /// @param[in] u (Function)
+    ///         The coefficient of the action form that the operator
+    ///         acts on.
+    /// @param[in] a (Form)
+    ///         The bilinear form (optional, needed by get_diagonal()).
+    MatrixFreeOperator(std::shared_ptr<const Form> a_action,
+                       std::shared_ptr<Function> u,
+                       std::shared_ptr<const Form> a=nullptr);
+
+    /// Destructor
+    ~MatrixFreeOperator();
+
+    /// Return size of given dimension
+    std::size_t size(std::size_t dim) const;
+
+    /// Compute matrix-vector product y = Ax by assembling the action
+    /// form with u = x
+    void mult(const GenericVector& x, GenericVector& y) const;
+
+    /// Compute diagonal of the operator by assembling the diagonal
+    /// entries of the element matrices of the bilinear form
+    void get_diagonal(GenericVector& x) const;
+
+    /// Return informal string representation (pretty-print)
+    std::string str(bool verbose) const;
+
+  private:
+
+    // Assemble diagonal of element matrices over cells
+    void assemble_diagonal_cells(GenericVector& x, UFC& ufc) const;
+
+    // Assemble diagonal of element matrices over exterior facets
+    void assemble_diagonal_exterior_facets(GenericVector& x,
+                                           UFC& ufc) const;
+
+    // The action form, its coefficient and the bilinear form
+    std::shared_ptr<const Form> _a_action;
+    std::shared_ptr<Function> _u;
+    std::shared_ptr<const Form> _a;
+
+    // Assembler used for the action
+    mutable Assembler _assembler;
+
+    // UFC data for the action and the bilinear form, created on
+    // first use and recreated if the form coefficients change
+    mutable std::unique_ptr<UFC> _ufc_action;
+    mutable std::unique_ptr<UFC> _ufc;
+
+    // Form coefficients that the UFC data was created for
+    mutable std::vector<std::shared_ptr<const GenericFunction>>
+      _action_coefficients;
+    mutable std::vector<std::shared_ptr<const GenericFunction>> _coefficients;
+
+  };
+
+}
+
+#endif
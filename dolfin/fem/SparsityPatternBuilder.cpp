@@ -19,17 +19,25 @@
 // Modified by Anders Logg 2008-2014
 
 #include <algorithm>
+#include <cstdint>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
 
 #include <dolfin/common/ArrayView.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/common/Timer.h>
 #include <dolfin/la/SparsityPattern.h>
 #include <dolfin/log/log.h>
 #include <dolfin/log/Progress.h>
 #include <dolfin/mesh/Cell.h>
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshConnectivity.h>
 #include <dolfin/mesh/MultiMesh.h>
 #include <dolfin/mesh/Vertex.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/function/FunctionSpace.h>
 #include <dolfin/function/MultiMeshFunctionSpace.h>
 #include "MultiMeshDofMap.h"
@@ -60,9 +68,30 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
     index_maps[i] = dofmaps[i]->index_map();
   }
 
-  // Initialise sparsity pattern
+  // Initialise sparsity pattern, with one entry per block of dofs
+  // for matrices on vector-valued spaces if requested
   if (init)
-    sparsity_pattern.init(index_maps);
+  {
+    std::size_t block_size = 1;
+    if (rank == 2
+        && std::string(parameters["matrix_block_storage"]) != "scalar")
+    {
+      block_size = index_maps[0]->block_size();
+      if ((int) block_size != index_maps[1]->block_size())
+        block_size = 1;
+
+      // Global dofs are inserted as full rows, which are not
+      // supported by blocked sparsity patterns
+      std::vector<std::size_t> global_dofs;
+      for (std::size_t i = 0; i < rank && block_size > 1; ++i)
+      {
+        dofmaps[i]->tabulate_global_dofs(global_dofs);
+        if (!global_dofs.empty())
+          block_size = 1;
+      }
+    }
+    sparsity_pattern.init(index_maps, block_size);
+  }
 
   // Only build for rank >= 2 (matrices and higher order tensors) that
   // require sparsity details
@@ -91,8 +120,48 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
   // returned on each cell will be an empty vector, but we might think
   // about optimizing this further.
 
+  // Build sparsity pattern for cell integrals from the mesh topology
+  // and the entity dofs, if requested and supported. This also covers
+  // vertex integrals.
+  bool cells_inserted = false;
+  if (cells && !interior_facets && rank == 2
+      && std::string(parameters["sparsity_pattern_method"]) == "topology")
+  {
+    cells_inserted = build_from_topology(sparsity_pattern, mesh, dofmaps);
+  }
+  const bool from_topology = cells_inserted;
+
+  // Build sparsity pattern for cell integrals using multiple
+  // threads, each inserting into its own buffer of the sparsity
+  // pattern
+  #ifdef HAS_OPENMP
+  const int num_threads = parameters["num_threads"];
+  if (cells && !cells_inserted && num_threads > 0)
+  {
+    // Skip ghost cells, as CellIterator does in the serial loop
+    sparsity_pattern.set_num_threads(num_threads);
+    const std::int64_t num_cells
+      = mesh.topology().ghost_offset(mesh.topology().dim());
+    #pragma omp parallel num_threads(num_threads)
+    {
+      std::vector<ArrayView<const dolfin::la_index>> _dofs(rank);
+      #pragma omp for schedule(static)
+      for (std::int64_t c = 0; c < num_cells; ++c)
+      {
+        for (std::size_t i = 0; i < rank; ++i)
+        {
+          auto dmap = dofmaps[i]->cell_dofs(c);
+          _dofs[i].set(dmap.size(), dmap.data());
+        }
+        sparsity_pattern.insert_local(_dofs);
+      }
+    }
+    cells_inserted = true;
+  }
+  #endif
+
   // Build sparsity pattern for cell integrals
-  if (cells)
+  if (cells && !cells_inserted)
   {
     Progress p("Building sparsity pattern over cells", mesh.num_cells());
     for (CellIterator cell(mesh); !cell.end(); ++cell)
@@ -112,7 +181,7 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
 
   // Build sparsity pattern for vertex/point integrals
   const std::size_t D = mesh.topology().dim();
-  if (vertices)
+  if (vertices && !from_topology)
   {
     mesh.init(0);
     mesh.init(0, D);
@@ -268,6 +337,192 @@ SparsityPatternBuilder::build(SparsityPattern& sparsity_pattern,
     sparsity_pattern.apply();
 }
 //-----------------------------------------------------------------------------
+bool SparsityPatternBuilder::build_from_topology(
+  SparsityPattern& sparsity_pattern, const Mesh& mesh,
+  const std::vector<const GenericDofMap*> dofmaps)
+{
+  dolfin_assert(dofmaps.size() == 2);
+  const std::size_t primary_dim = sparsity_pattern.primary_dim();
+  const std::size_t primary_codim = primary_dim == 0 ? 1 : 0;
+  dolfin_assert(dofmaps[primary_dim]);
+  dolfin_assert(dofmaps[primary_codim]);
+  const GenericDofMap& dofmap0 = *dofmaps[primary_dim];
+  const GenericDofMap& dofmap1 = *dofmaps[primary_codim];
+
+  // In parallel, all cells around an entity carrying owned dofs must
+  // be present on this process, which requires vertex ghosting
+  if (MPI::size(mesh.mpi_comm()) > 1 && mesh.ghost_mode() != "shared_vertex")
+    return false;
+
+  // Views, constrained dofmaps and global dofs do not have a one to
+  // one map from dofs to mesh entities
+  if (dofmap0.is_view() || dofmap1.is_view())
+    return false;
+  if (dofmap0.constrained_domain || dofmap1.constrained_domain)
+    return false;
+  std::vector<std::size_t> global_dofs;
+  dofmap0.tabulate_global_dofs(global_dofs);
+  if (!global_dofs.empty())
+    return false;
+  dofmap1.tabulate_global_dofs(global_dofs);
+  if (!global_dofs.empty())
+    return false;
+
+  Timer timer("Build sparsity pattern from topology");
+
+  // Get topological dimensions carrying row dofs, and tabulate the
+  // local row dofs on each entity of the reference cell
+  const std::size_t D = mesh.topology().dim();
+  const CellType& cell_type = mesh.type();
+  std::vector<std::size_t> dims0;
+  std::vector<std::vector<std::vector<std::size_t>>> entity_dofs0(D + 1);
+  for (std::size_t d = 0; d <= D; ++d)
+  {
+    if (dofmap0.num_entity_dofs(d) > 0)
+      dims0.push_back(d);
+
+    entity_dofs0[d].resize(cell_type.num_entities(d));
+    for (std::size_t i = 0; i < cell_type.num_entities(d); ++i)
+      dofmap0.tabulate_entity_dofs(entity_dofs0[d][i], d, i);
+  }
+
+  // Compute entities and connectivity
+  for (std::size_t d = 0; d <= D; ++d)
+  {
+    mesh.init(d);
+    if (d < D && std::find(dims0.begin(), dims0.end(), d) != dims0.end())
+      mesh.init(d, D);
+  }
+
+  const std::size_t num_rows
+    = dofmap0.index_map()->size(IndexMap::MapSize::OWNED);
+  const IndexMap& index_map1 = *dofmap1.index_map();
+
+  // Get the cells containing entity e of dimension d
+  auto entity_cells = [&](std::size_t d, std::size_t e,
+                          std::size_t& num_cells) -> const unsigned int*
+    {
+      if (d == D)
+      {
+        num_cells = 1;
+        return nullptr;
+      }
+      const MeshConnectivity& connectivity = mesh.topology()(d, D);
+      num_cells = connectivity.size(e);
+      return connectivity(e);
+    };
+
+  // Tabulate the owned rows (local indices) on entity e of dimension
+  // d. All cells containing e agree on its dofs, so use the first.
+  auto tabulate_rows = [&](std::size_t d, std::size_t e,
+                           std::vector<std::size_t>& rows)
+    {
+      rows.clear();
+      std::size_t num_cells = 0;
+      const unsigned int* cells = entity_cells(d, e, num_cells);
+      const std::size_t c = cells ? cells[0] : e;
+      std::size_t local_entity = 0;
+      if (d < D)
+      {
+        const unsigned int* entities = mesh.topology()(D, d)(c);
+        while (entities[local_entity] != e)
+          ++local_entity;
+      }
+      auto cell_dofs = dofmap0.cell_dofs(c);
+      for (auto dof : entity_dofs0[d][local_entity])
+      {
+        if ((std::size_t) cell_dofs[dof] < num_rows)
+          rows.push_back(cell_dofs[dof]);
+      }
+    };
+
+  // Tabulate the global columns coupled to entity e of dimension d,
+  // i.e. the dofs of all cells containing e. Dofs shared by several
+  // of these cells are merged by sorting and removing duplicates, so
+  // the work space is bounded by the cell patch rather than by the
+  // number of mesh entities.
+  auto tabulate_columns = [&](std::size_t d, std::size_t e,
+                              std::vector<std::size_t>& columns)
+    {
+      columns.clear();
+      std::size_t num_cells = 0;
+      const unsigned int* cells = entity_cells(d, e, num_cells);
+      for (std::size_t i = 0; i < num_cells; ++i)
+      {
+        const std::size_t c = cells ? cells[i] : e;
+        auto cell_dofs = dofmap1.cell_dofs(c);
+        for (Eigen::Index k = 0; k < cell_dofs.size(); ++k)
+          columns.push_back(index_map1.local_to_global(cell_dofs[k]));
+      }
+      std::sort(columns.begin(), columns.end());
+      columns.erase(std::unique(columns.begin(), columns.end()),
+                    columns.end());
+    };
+
+  #ifdef HAS_OPENMP
+  const int num_threads = std::max(1, (int) parameters["num_threads"]);
+  #endif
+
+  // Count entries in each row
+  std::vector<std::size_t> offsets(num_rows + 1, 0);
+  for (auto d : dims0)
+  {
+    const std::int64_t num_entities = mesh.num_entities(d);
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    #endif
+    {
+      std::vector<std::size_t> rows, columns;
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for (std::int64_t e = 0; e < num_entities; ++e)
+      {
+        tabulate_rows(d, e, rows);
+        if (rows.empty())
+          continue;
+        tabulate_columns(d, e, columns);
+        for (auto row : rows)
+          offsets[row + 1] = columns.size();
+      }
+    }
+  }
+  for (std::size_t i = 0; i < num_rows; ++i)
+    offsets[i + 1] += offsets[i];
+
+  // Fill in columns
+  std::vector<std::size_t> columns(offsets.back());
+  for (auto d : dims0)
+  {
+    const std::int64_t num_entities = mesh.num_entities(d);
+    #ifdef HAS_OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    #endif
+    {
+      std::vector<std::size_t> rows, entity_columns;
+      #ifdef HAS_OPENMP
+      #pragma omp for schedule(static)
+      #endif
+      for (std::int64_t e = 0; e < num_entities; ++e)
+      {
+        tabulate_rows(d, e, rows);
+        if (rows.empty())
+          continue;
+        tabulate_columns(d, e, entity_columns);
+        for (auto row : rows)
+        {
+          std::copy(entity_columns.begin(), entity_columns.end(),
+                    columns.begin() + offsets[row]);
+        }
+      }
+    }
+  }
+
+  sparsity_pattern.insert_rows_local_global(offsets, columns);
+
+  return true;
+}
+//-----------------------------------------------------------------------------
 void SparsityPatternBuilder::build_multimesh_sparsity_pattern(
   SparsityPattern& sparsity_pattern,
   const MultiMeshForm& form)
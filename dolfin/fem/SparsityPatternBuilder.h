@@ -62,6 +62,14 @@ namespace dolfin
 
   private:
 
+    // Build sparsity pattern for cell integrals from mesh
+    // connectivity and the dofs associated with each mesh entity,
+    // without inserting element blocks. Returns false (and inserts
+    // nothing) if the dofmaps are not supported.
+    static bool build_from_topology(SparsityPattern& sparsity_pattern,
+                                    const Mesh& mesh,
+                                    const std::vector<const GenericDofMap*> dofmaps);
+
     // Build sparsity pattern for interface part of multimesh form
     static void _build_multimesh_sparsity_pattern_interface
       (SparsityPattern& sparsity_pattern,
@@ -22,8 +22,14 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
+#include <numeric>
 #include <Eigen/Dense>
 
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/common/ArrayView.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/types.h>
@@ -38,6 +44,7 @@
 #include <dolfin/mesh/Facet.h>
 #include <dolfin/mesh/MeshFunction.h>
 #include <dolfin/mesh/SubDomain.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "AssemblerBase.h"
 #include "DirichletBC.h"
 #include "FiniteElement.h"
@@ -284,10 +291,36 @@ void SystemAssembler::assemble(GenericMatrix* A, GenericVector* b,
   }
   else
   {
+    // Compute facets and facet - cell connectivity if not already
+    // computed
+    const std::size_t D = mesh.topology().dim();
+    mesh.init(D - 1);
+    mesh.init(D - 1, D);
+
+    // Facet at which the cell tensor of each cell is computed
+    const std::vector<std::size_t> cell_facets = compute_cell_facets(mesh);
+
     // Assemble facet-wise (including cell assembly)
-    facet_wise_assembly(tensors, ufc, data, boundary_values,
-                        cell_domains, exterior_facet_domains,
-                        interior_facet_domains);
+    const int num_threads = parameters["num_threads"];
+    if (num_threads > 0)
+    {
+      facet_wise_assembly_threaded(tensors, ufc, data, boundary_values,
+                                   cell_domains, exterior_facet_domains,
+                                   interior_facet_domains, cell_facets);
+    }
+    else
+    {
+      std::vector<std::size_t> facets(mesh.topology().ghost_offset(D - 1));
+      for (std::size_t f = 0; f < facets.size(); ++f)
+        facets[f] = f;
+
+      Progress p("Assembling system (facet-wise)", facets.size());
+      facet_wise_assembly(tensors, ufc, data, boundary_values,
+                          cell_domains, exterior_facet_domains,
+                          interior_facet_domains,
+                          ArrayView<const std::size_t>(facets),
+                          cell_facets, &p);
+    }
   }
 
   // Finalise assembly
@@ -491,6 +524,77 @@ void SystemAssembler::cell_wise_assembly(
   }
 }
 //-----------------------------------------------------------------------------
+void SystemAssembler::facet_wise_assembly_threaded(
+  std::array<GenericTensor*, 2>& tensors,
+  std::array<UFC*, 2>& ufc,
+  Scratch& data,
+  const std::vector<DirichletBC::Map>& boundary_values,
+  std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+  std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+  std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+  const std::vector<std::size_t>& cell_facets)
+{
+#ifndef HAS_OPENMP
+  dolfin_error("SystemAssembler.cpp",
+               "perform threaded system assembly",
+               "DOLFIN has not been configured with OpenMP");
+#else
+  Timer timer("Assemble system (threaded facet-wise)");
+
+  // Extract mesh
+  dolfin_assert(ufc[0]->dolfin_form.mesh());
+  const Mesh& mesh = *(ufc[0]->dolfin_form.mesh());
+  const std::size_t D = mesh.topology().dim();
+
+  // Create one copy of the assembly data and one insert buffer per
+  // thread
+  const int num_threads = parameters["num_threads"];
+  std::vector<UFC> A_ufc(num_threads, *ufc[0]);
+  std::vector<UFC> b_ufc(num_threads, *ufc[1]);
+  std::vector<Scratch> thread_data(num_threads, data);
+  std::vector<InsertBuffer> buffers(num_threads);
+
+  // Assemble facets in blocks. Each thread assembles a contiguous
+  // range of the facets of a block and records the element tensors
+  // in its own buffer. The buffers are then added to the global
+  // tensors in thread order, i.e. in facet order, so that insertion
+  // is never concurrent and the result is identical to serial
+  // assembly.
+  const std::size_t num_facets = mesh.topology().ghost_offset(D - 1);
+  const std::size_t block_size = 256*num_threads;
+  std::vector<std::size_t> facets;
+  for (std::size_t block_begin = 0; block_begin < num_facets;
+       block_begin += block_size)
+  {
+    const std::size_t block_end = std::min(block_begin + block_size,
+                                           num_facets);
+    facets.resize(block_end - block_begin);
+    std::iota(facets.begin(), facets.end(), block_begin);
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+      // Contiguous chunk of facets for this thread
+      const std::size_t thread = omp_get_thread_num();
+      const std::size_t n = omp_get_num_threads();
+      const std::size_t begin = thread*facets.size()/n;
+      const std::size_t end = (thread + 1)*facets.size()/n;
+
+      std::array<UFC*, 2> _ufc = {{&A_ufc[thread], &b_ufc[thread]}};
+      facet_wise_assembly(tensors, _ufc, thread_data[thread], boundary_values,
+                          cell_domains, exterior_facet_domains,
+                          interior_facet_domains,
+                          ArrayView<const std::size_t>(end - begin,
+                                                       facets.data() + begin),
+                          cell_facets, NULL, &buffers[thread]);
+    }
+
+    // Add element tensors to global tensors
+    for (auto& buffer : buffers)
+      buffer.insert(tensors);
+  }
+#endif
+}
+//-----------------------------------------------------------------------------
 void SystemAssembler::facet_wise_assembly(
   std::array<GenericTensor*, 2>& tensors,
   std::array<UFC*, 2>& ufc,
@@ -498,7 +602,10 @@ void SystemAssembler::facet_wise_assembly(
   const std::vector<DirichletBC::Map>& boundary_values,
   std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
   std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
-  std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains)
+  std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+  ArrayView<const std::size_t> facets,
+  const std::vector<std::size_t>& cell_facets,
+  Progress* p, InsertBuffer* buffer)
 {
   // Extract mesh
   dolfin_assert(ufc[0]->dolfin_form.mesh());
@@ -509,11 +616,9 @@ void SystemAssembler::facet_wise_assembly(
                 || mesh.ghost_mode() == "shared_facet"
                 || MPI::size(mesh.mpi_comm()) == 1);
 
-  // Compute facets and facet - cell connectivity if not already
-  // computed
+  // Facet - cell connectivity must have been computed
   const std::size_t D = mesh.topology().dim();
-  mesh.init(D - 1);
-  mesh.init(D - 1, D);
+  dolfin_assert(!mesh.topology()(D - 1, D).empty());
 
   // Get my MPI rank
   const int my_mpi_rank = MPI::rank(mesh.mpi_comm());
@@ -566,29 +671,30 @@ void SystemAssembler::facet_wise_assembly(
   std::array<bool, 2> tensor_required_cell = {{false, false}};
   std::array<bool, 2> tensor_required_facet = {{false, false}};
 
-  // Track whether or not cell contribution has been computed
+  // Track whether or not cell contribution is computed at current
+  // facet
   std::array<bool, 2> compute_cell_tensor = {{true, true}};
-  std::vector<bool> cell_tensor_computed(mesh.num_cells(), false);
 
   // Iterate over facets
   std::array<ufc::cell, 2> ufc_cell;
   std::array<std::vector<double>, 2> coordinate_dofs;
-  Progress p("Assembling system (facet-wise)", mesh.num_facets());
-  for (FacetIterator facet(mesh); !facet.end(); ++facet)
+  for (auto facet_index : facets)
   {
+    const Facet facet(mesh, facet_index);
+
     // Number of cells sharing facet
-    const std::size_t num_cells = facet->num_entities(D);
+    const std::size_t num_cells = facet.num_entities(D);
 
     // Check that facet is not a ghost
-    dolfin_assert(!facet->is_ghost());
+    dolfin_assert(!facet.is_ghost());
 
     // Interior facet
     if (num_cells == 2)
     {
       // Get cells incident with facet (which is 0 and 1 here is arbitrary)
-      dolfin_assert(facet->num_entities(D) == 2);
-      std::array<std::size_t, 2> cell_indices = {{facet->entities(D)[0],
-                                                  facet->entities(D)[1]}};
+      dolfin_assert(facet.num_entities(D) == 2);
+      std::array<std::size_t, 2> cell_indices = {{facet.entities(D)[0],
+                                                  facet.entities(D)[1]}};
 
       // Make sure cell marker for '+' side is larger than cell marker
       // for '-' side.  Note: by ffc convention, 0 is + and 1 is -
@@ -603,11 +709,11 @@ void SystemAssembler::facet_wise_assembly(
       {
         cell[c] = Cell(mesh, cell_indices[c]);
         cell_index[c] = cell[c].index();
-        local_facet[c] = cell[c].index(*facet);
+        local_facet[c] = cell[c].index(facet);
         cell[c].get_coordinate_dofs(coordinate_dofs[c]);
         cell[c].get_cell_data(ufc_cell[c], local_facet[c]);
 
-        compute_cell_tensor[c] = !cell_tensor_computed[cell_index[c]];
+        compute_cell_tensor[c] = (cell_facets[cell_index[c]] == facet_index);
       }
 
       const bool process_facet = (cell[0].is_ghost() != cell[1].is_ghost());
@@ -664,7 +770,7 @@ void SystemAssembler::facet_wise_assembly(
         // Get facet integral for sub domain (if any)
         if (use_interior_facet_domains)
         {
-          const std::size_t domain = (*interior_facet_domains)[*facet];
+          const std::size_t domain = (*interior_facet_domains)[facet];
           interior_facet_integrals[form]
             = ufc[form]->get_interior_facet_integral(domain);
         }
@@ -752,7 +858,7 @@ void SystemAssembler::facet_wise_assembly(
         std::vector<ArrayView<const la_index>> mdofs(macro_dofs[1].size());
         for (std::size_t i = 0; i < macro_dofs[1].size(); ++i)
           mdofs[i].set(macro_dofs[1][i]);
-        tensors[1]->add_local(ufc[1]->macro_A.data(), mdofs);
+        add_to_tensor(tensors, 1, ufc[1]->macro_A.data(), mdofs, buffer);
       }
 
       const bool add_macro_element
@@ -762,7 +868,7 @@ void SystemAssembler::facet_wise_assembly(
         std::vector<ArrayView<const la_index>> mdofs(macro_dofs[0].size());
         for (std::size_t i = 0; i < macro_dofs[0].size(); ++i)
           mdofs[i].set(macro_dofs[0][i]);
-        tensors[0]->add_local(ufc[0]->macro_A.data(), mdofs);
+        add_to_tensor(tensors, 0, ufc[0]->macro_A.data(), mdofs, buffer);
       }
       else if (tensors[0] && !add_macro_element && tensor_required_cell[0])
       {
@@ -773,21 +879,18 @@ void SystemAssembler::facet_wise_assembly(
         // instead extract back out the diagonal cell blocks and add
         // them individually
         matrix_block_add(*tensors[0], data.Ae[0], ufc[0]->macro_A,
-                         compute_cell_tensor, cell_dofs[0]);
+                         compute_cell_tensor, cell_dofs[0], buffer);
       }
 
-      // Mark cells as processed
-      cell_tensor_computed[cell_index[0]] = true;
-      cell_tensor_computed[cell_index[1]] = true;
     }
     else // Exterior facet
     {
       // Get mesh cell to which mesh facet belongs (pick first, there
       // is only one)
-      Cell cell(mesh, facet->entities(mesh.topology().dim())[0]);
+      Cell cell(mesh, facet.entities(mesh.topology().dim())[0]);
 
       // Check of attached cell needs to be processed
-      compute_cell_tensor[0] = !cell_tensor_computed[cell.index()];
+      compute_cell_tensor[0] = (cell_facets[cell.index()] == facet_index);
 
        // Decide if tensor needs to be computed
       for (std::size_t form = 0; form < 2; ++form)
@@ -805,7 +908,7 @@ void SystemAssembler::facet_wise_assembly(
         // Get exterior facet integrals for sub domain (if any)
         if (use_exterior_facet_domains)
         {
-          const std::size_t domain = (*exterior_facet_domains)[*facet];
+          const std::size_t domain = (*exterior_facet_domains)[facet];
           exterior_facet_integrals[form]
             = ufc[form]->get_exterior_facet_integral(domain);
         }
@@ -845,7 +948,7 @@ void SystemAssembler::facet_wise_assembly(
                                     coordinate_dofs[0],
                                     tensor_required_cell,
                                     tensor_required_facet,
-                                    cell, *facet,
+                                    cell, facet,
                                     cell_integrals,
                                     exterior_facet_integrals,
                                     compute_cell_tensor[0]);
@@ -858,14 +961,37 @@ void SystemAssembler::facet_wise_assembly(
       for (std::size_t form = 0; form < 2; ++form)
       {
         if (tensors[form])
-          tensors[form]->add_local(data.Ae[form].data(), cell_dofs[form][0]);
+        {
+          add_to_tensor(tensors, form, data.Ae[form].data(),
+                        cell_dofs[form][0], buffer);
+        }
       }
+    }
 
-      // Mark cell as processed
-      cell_tensor_computed[cell.index()] = true;
+    if (p)
+      (*p)++;
+  }
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t> SystemAssembler::compute_cell_facets(const Mesh& mesh)
+{
+  // The cell tensor of each cell is computed together with the
+  // first (lowest numbered) facet of the cell. This makes the
+  // assignment independent of the order in which facets are visited.
+  const std::size_t D = mesh.topology().dim();
+  std::vector<std::size_t> cell_facets(mesh.num_cells(),
+                                       std::numeric_limits<std::size_t>::max());
+  for (FacetIterator facet(mesh); !facet.end(); ++facet)
+  {
+    for (std::size_t c = 0; c < facet->num_entities(D); ++c)
+    {
+      const std::size_t cell_index = facet->entities(D)[c];
+      cell_facets[cell_index] = std::min(cell_facets[cell_index],
+                                         facet->index());
     }
-    p++;
   }
+
+  return cell_facets;
 }
 //-----------------------------------------------------------------------------
 void SystemAssembler::compute_exterior_facet_tensor(
@@ -1013,7 +1139,8 @@ void SystemAssembler::matrix_block_add(
   std::vector<double>& Ae,
   std::vector<double>& macro_A,
   const std::array<bool, 2>& add_local_tensor,
-  const std::array<std::vector<ArrayView<const la_index>>, 2>& cell_dofs)
+  const std::array<std::vector<ArrayView<const la_index>>, 2>& cell_dofs,
+  InsertBuffer* buffer)
 {
   for (std::size_t c = 0; c < 2; ++c)
   {
@@ -1028,11 +1155,27 @@ void SystemAssembler::matrix_block_add(
         for (std::size_t j = 0; j < nn; j++)
           Ae[i*nn + j] = macro_A[2*nn*mm*c + 2*i*nn + nn*c +j];
       }
-      tensor.add_local(Ae.data(), cell_dofs[c]);
+      if (buffer)
+        buffer->add(0, Ae.data(), cell_dofs[c]);
+      else
+        tensor.add_local(Ae.data(), cell_dofs[c]);
     }
   }
 }
 //-----------------------------------------------------------------------------
+void SystemAssembler::add_to_tensor(
+  std::array<GenericTensor*, 2>& tensors, std::size_t form,
+  const double* values,
+  const std::vector<ArrayView<const la_index>>& dofs,
+  InsertBuffer* buffer)
+{
+  dolfin_assert(tensors[form]);
+  if (buffer)
+    buffer->add(form, values, dofs);
+  else
+    tensors[form]->add_local(values, dofs);
+}
+//-----------------------------------------------------------------------------
 void
 SystemAssembler::apply_bc(double* A, double* b,
                           const std::vector<DirichletBC::Map>& boundary_values,
@@ -1139,6 +1282,49 @@ bool SystemAssembler::cell_matrix_required(
     return false;
 }
 //-----------------------------------------------------------------------------
+void SystemAssembler::InsertBuffer::add(
+  std::size_t form, const double* values,
+  const std::vector<ArrayView<const la_index>>& dofs)
+{
+  _entries.push_back({{form, dofs.size(), _sizes.size(), _dofs.size(),
+          _values.size()}});
+  std::size_t num_values = 1;
+  for (auto& d : dofs)
+  {
+    _sizes.push_back(d.size());
+    _dofs.insert(_dofs.end(), d.begin(), d.end());
+    num_values *= d.size();
+  }
+  _values.insert(_values.end(), values, values + num_values);
+}
+//-----------------------------------------------------------------------------
+void SystemAssembler::InsertBuffer::insert(
+  std::array<GenericTensor*, 2>& tensors)
+{
+  std::vector<ArrayView<const la_index>> dofs;
+  for (auto& entry : _entries)
+  {
+    // Build views of dofs of element tensor
+    const std::size_t rank = entry[1];
+    dofs.resize(rank);
+    std::size_t offset = entry[3];
+    for (std::size_t i = 0; i < rank; ++i)
+    {
+      const std::size_t size = _sizes[entry[2] + i];
+      dofs[i].set(size, _dofs.data() + offset);
+      offset += size;
+    }
+
+    dolfin_assert(tensors[entry[0]]);
+    tensors[entry[0]]->add_local(_values.data() + entry[4], dofs);
+  }
+
+  _entries.clear();
+  _sizes.clear();
+  _dofs.clear();
+  _values.clear();
+}
+//-----------------------------------------------------------------------------
 SystemAssembler::Scratch::Scratch(const Form& a, const Form& L)
 {
   std::size_t A_num_entries
@@ -47,7 +47,9 @@ namespace dolfin
   class GenericDofMap;
   class GenericMatrix;
   class GenericVector;
+  class Mesh;
   template<typename T> class MeshFunction;
+  class Progress;
   class UFC;
 
   /// This class provides an assembler for systems of the form Ax =
@@ -94,6 +96,31 @@ namespace dolfin
       std::array<std::vector<double>, 2> Ae;
     };
 
+    // Element tensors and their dofs, recorded for insertion into
+    // the global tensors at a later point. Used by threaded assembly
+    // to add element tensors in the same order as serial assembly.
+    class InsertBuffer
+    {
+    public:
+      // Record element tensor for the global tensor of given form
+      void add(std::size_t form, const double* values,
+               const std::vector<ArrayView<const la_index>>& dofs);
+
+      // Add recorded element tensors to the global tensors, in the
+      // order they were recorded, and clear buffer
+      void insert(std::array<GenericTensor*, 2>& tensors);
+
+    private:
+      // Form, tensor rank and offsets into _sizes, _dofs and _values
+      // of each recorded element tensor
+      std::vector<std::array<std::size_t, 5>> _entries;
+
+      // Number of dofs per dimension, dofs and values
+      std::vector<std::size_t> _sizes;
+      std::vector<la_index> _dofs;
+      std::vector<double> _values;
+    };
+
     // Check form arity
     static void check_arity(std::shared_ptr<const Form> a,
                             std::shared_ptr<const Form> L);
@@ -120,6 +147,8 @@ namespace dolfin
       std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
       std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains);
 
+    // Assemble over the given facets (including the cell tensors of
+    // cells for which cell_facets holds the facet)
     static void facet_wise_assembly(
       std::array<GenericTensor*, 2>& tensors,
       std::array<UFC*, 2>& ufc,
@@ -127,7 +156,29 @@ namespace dolfin
       const std::vector<DirichletBC::Map>& boundary_values,
       std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
       std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
-      std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains);
+      std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+      ArrayView<const std::size_t> facets,
+      const std::vector<std::size_t>& cell_facets,
+      Progress* p, InsertBuffer* buffer=NULL);
+
+    // Assemble over all facets using multiple threads. Facets are
+    // processed in blocks; each thread assembles a contiguous range
+    // of facets of a block into its own insert buffer, and the
+    // buffers are added to the global tensors serially in facet
+    // order.
+    static void facet_wise_assembly_threaded(
+      std::array<GenericTensor*, 2>& tensors,
+      std::array<UFC*, 2>& ufc,
+      Scratch& data,
+      const std::vector<DirichletBC::Map>& boundary_values,
+      std::shared_ptr<const MeshFunction<std::size_t>> cell_domains,
+      std::shared_ptr<const MeshFunction<std::size_t>> exterior_facet_domains,
+      std::shared_ptr<const MeshFunction<std::size_t>> interior_facet_domains,
+      const std::vector<std::size_t>& cell_facets);
+
+    // Compute for each cell the index of the facet at which its cell
+    // tensor is assembled during facet-wise assembly
+    static std::vector<std::size_t> compute_cell_facets(const Mesh& mesh);
 
     // Compute exterior facet (and possibly connected cell)
     // contribution
@@ -168,7 +219,16 @@ namespace dolfin
       std::vector<double>& Ae,
       std::vector<double>& macro_A,
       const std::array<bool, 2>& add_local_tensor,
-      const std::array<std::vector<ArrayView<const la_index>>, 2>& cell_dofs);
+      const std::array<std::vector<ArrayView<const la_index>>, 2>& cell_dofs,
+      InsertBuffer* buffer);
+
+    // Add element tensor to the global tensor of given form, or
+    // record it in buffer (if not null)
+    static void add_to_tensor(
+      std::array<GenericTensor*, 2>& tensors, std::size_t form,
+      const double* values,
+      const std::vector<ArrayView<const la_index>>& dofs,
+      InsertBuffer* buffer);
 
     static void apply_bc(double* A, double* b,
                          const std::vector<DirichletBC::Map>& boundary_values,
@@ -153,7 +153,7 @@ void UFC::init(const Form& a)
   }
 }
 //-----------------------------------------------------------------------------
-void UFC::update(const Cell& c, const std::vector<double>& coordinate_dofs,
+void UFC::update(const Cell& c, const double* coordinate_dofs,
                  const ufc::cell& ufc_cell,
                  const std::vector<bool> & enabled_coefficients)
 {
@@ -164,7 +164,7 @@ void UFC::update(const Cell& c, const std::vector<double>& coordinate_dofs,
       continue;
     dolfin_assert(coefficients[i]);
     coefficients[i]->restrict(_w[i].data(), coefficient_elements[i], c,
-                              coordinate_dofs.data(), ufc_cell);
+                              coordinate_dofs, ufc_cell);
   }
 }
 //-----------------------------------------------------------------------------
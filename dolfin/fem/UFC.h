@@ -63,6 +63,14 @@ namespace dolfin
     void update(const Cell& cell,
                 const std::vector<double>& coordinate_dofs0,
                 const ufc::cell& ufc_cell,
+                const std::vector<bool> & enabled_coefficients)
+    { update(cell, coordinate_dofs0.data(), ufc_cell, enabled_coefficients); }
+
+    /// Update current cell, with coordinate dofs given as an array
+    /// (e.g. a view of packed coordinate dofs)
+    void update(const Cell& cell,
+                const double* coordinate_dofs0,
+                const ufc::cell& ufc_cell,
                 const std::vector<bool> & enabled_coefficients);
 
     /// Update current pair of cells for macro element
@@ -20,6 +20,8 @@
 #include <dolfin/fem/Form.h>
 #include <dolfin/fem/AssemblerBase.h>
 #include <dolfin/fem/Assembler.h>
+#include <dolfin/fem/AssemblyPlan.h>
+#include <dolfin/fem/MatrixFreeOperator.h>
 #include <dolfin/fem/SparsityPatternBuilder.h>
 #include <dolfin/fem/SystemAssembler.h>
 #include <dolfin/fem/LinearVariationalProblem.h>
@@ -260,7 +260,9 @@ void _get_set_coordinates(MeshGeometry& geometry, Function& position,
       v.set_local(values.data(), cell_dofs.size(), cell_dofs.data());
   }
 
-  if (!setting)
+  if (setting)
+    geometry.mark_modified();
+  else
     v.apply("insert");
 }
 //-----------------------------------------------------------------------------
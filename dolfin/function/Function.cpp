@@ -20,6 +20,7 @@
 // Modified by Andre Massing 2009
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <utility>
 #include <vector>
@@ -337,8 +338,9 @@ void Function::eval(Array<double>& values, const Array<double>& x,
   std::vector<double> coefficients(element.space_dimension());
 
   // Cell coordinates (re-allocated inside function for thread safety)
-  std::vector<double> coordinate_dofs;
-  dolfin_cell.get_coordinate_dofs(coordinate_dofs);
+  std::vector<double> coordinate_dofs_buffer;
+  const ArrayView<const double> coordinate_dofs
+    = dolfin_cell.coordinate_dofs(coordinate_dofs_buffer);
 
   // Restrict function to cell
   restrict(coefficients.data(), element, dolfin_cell,
@@ -380,6 +382,121 @@ void Function::eval(Eigen::Ref<Eigen::VectorXd> values,
   eval(_values, _x, dolfin_cell, ufc_cell);
 }
 //-----------------------------------------------------------------------------
+void Function::eval(std::vector<double>& values, const std::vector<double>& x,
+                    std::vector<unsigned int>& cells) const
+{
+  dolfin_assert(_function_space);
+  dolfin_assert(_function_space->mesh());
+  dolfin_assert(_function_space->element());
+  const Mesh& mesh = *_function_space->mesh();
+  const FiniteElement& element = *_function_space->element();
+  const std::size_t gdim = mesh.geometry().dim();
+  dolfin_assert(x.size() % gdim == 0);
+  const std::size_t num_points = x.size()/gdim;
+  const unsigned int not_found = std::numeric_limits<unsigned int>::max();
+
+  // Check cell hints, and collect points that must be searched for
+  if (cells.size() != num_points)
+    cells.assign(num_points, not_found);
+  std::vector<std::size_t> search_points;
+  std::vector<double> search_x;
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    const unsigned int c = cells[i];
+    if (c < mesh.num_cells()
+        && Cell(mesh, c).collides(Point(gdim, x.data() + i*gdim)))
+    {
+      continue;
+    }
+    search_points.push_back(i);
+    search_x.insert(search_x.end(), x.begin() + i*gdim,
+                    x.begin() + (i + 1)*gdim);
+  }
+
+  // Locate remaining points
+  if (!search_points.empty())
+  {
+    const std::vector<unsigned int> found = mesh.bounding_box_tree()
+      ->compute_first_entity_collisions(search_x);
+
+    // Use the closest cell for points outside the mesh, as for
+    // single point evaluation
+    std::vector<std::size_t> lost_points;
+    std::vector<double> lost_x;
+    for (std::size_t k = 0; k < search_points.size(); ++k)
+    {
+      cells[search_points[k]] = found[k];
+      if (found[k] == not_found)
+      {
+        lost_points.push_back(search_points[k]);
+        lost_x.insert(lost_x.end(), search_x.begin() + k*gdim,
+                      search_x.begin() + (k + 1)*gdim);
+      }
+    }
+
+    if (!lost_points.empty())
+    {
+      const std::pair<std::vector<unsigned int>, std::vector<double>> close
+        = mesh.bounding_box_tree()->compute_closest_entities(lost_x);
+      for (std::size_t k = 0; k < lost_points.size(); ++k)
+      {
+        if (_allow_extrapolation or close.second[k] < DOLFIN_EPS)
+          cells[lost_points[k]] = close.first[k];
+        else
+        {
+          dolfin_error("Function.cpp",
+                       "evaluate function at points",
+                       "Point %d is not inside the domain. Consider calling \"Function::set_allow_extrapolation(true)\" on this Function to allow extrapolation",
+                       lost_points[k]);
+        }
+      }
+    }
+  }
+
+  // Group points by cell
+  std::vector<std::size_t> order(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [&cells](std::size_t i, std::size_t j)
+            { return cells[i] < cells[j]; });
+
+  // Evaluate the function cell by cell
+  const std::size_t value_size_loc = value_size();
+  const std::size_t space_dimension = element.space_dimension();
+  values.resize(num_points*value_size_loc);
+  std::vector<double> coefficients(space_dimension);
+  std::vector<double> basis(space_dimension*value_size_loc);
+  std::vector<double> coordinate_dofs_buffer;
+  ufc::cell ufc_cell;
+  for (std::size_t k = 0; k < num_points;)
+  {
+    // Restrict function to cell
+    const unsigned int c = cells[order[k]];
+    const Cell cell(mesh, c);
+    const ArrayView<const double> coordinate_dofs
+      = cell.coordinate_dofs(coordinate_dofs_buffer);
+    cell.get_cell_data(ufc_cell);
+    restrict(coefficients.data(), element, cell, coordinate_dofs.data(),
+             ufc_cell);
+
+    // Compute linear combination at each point in cell
+    for (; k < num_points && cells[order[k]] == c; ++k)
+    {
+      const std::size_t i = order[k];
+      element.evaluate_basis_all(basis.data(), x.data() + i*gdim,
+                                 coordinate_dofs.data(),
+                                 ufc_cell.orientation);
+
+      double* v = values.data() + i*value_size_loc;
+      std::fill(v, v + value_size_loc, 0.0);
+      for (std::size_t j = 0; j < space_dimension; ++j)
+        for (std::size_t l = 0; l < value_size_loc; ++l)
+          v[l] += coefficients[j]*basis[j*value_size_loc + l];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void Function::interpolate(const GenericFunction& v)
 {
   dolfin_assert(_vector);
@@ -239,6 +239,25 @@ namespace dolfin
               Eigen::Ref<const Eigen::VectorXd> x,
               const dolfin::Cell& dolfin_cell, const ufc::cell& ufc_cell) const;
 
+    /// Evaluate function at many points. Points in the same cell are
+    /// evaluated together, so that the function is restricted to
+    /// each cell once and all basis functions are evaluated in one
+    /// call per point.
+    ///
+    /// *Arguments*
+    /// @param    values (std::vector<double>)
+    ///         The values (num_points x value_size, row major). Will
+    ///         be resized.
+    /// @param    x (std::vector<double>)
+    ///         The coordinates (num_points x gdim, row major).
+    /// @param    cells (std::vector<unsigned int>)
+    ///         Cell hints. If of size num_points, cells[i] is checked
+    ///         first for point i and the bounding box tree is only
+    ///         searched for points not contained in their hint.
+    ///         On return, holds the cell of each point.
+    void eval(std::vector<double>& values, const std::vector<double>& x,
+              std::vector<unsigned int>& cells) const;
+
     /// Interpolate function (on possibly non-matching meshes)
     ///
     /// @param    v (GenericFunction)
@@ -190,6 +190,30 @@ BoundingBoxTree::compute_closest_point(const Point& point) const
   return _tree->compute_closest_point(point);
 }
 //-----------------------------------------------------------------------------
+std::vector<unsigned int>
+BoundingBoxTree::compute_first_entity_collisions(const std::vector<double>& x) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_first_entity_collisions(x, *_mesh);
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<unsigned int>, std::vector<double>>
+BoundingBoxTree::compute_closest_entities(const std::vector<double>& x) const
+{
+  // Check that tree has been built
+  _check_built();
+
+  // Delegate call to implementation
+  dolfin_assert(_tree);
+  dolfin_assert(_mesh);
+  return _tree->compute_closest_entities(x, *_mesh);
+}
+//-----------------------------------------------------------------------------
 bool BoundingBoxTree::collides(const Point& point) const
 {
   return compute_first_collision(point) != std::numeric_limits<unsigned int>::max();
@@ -200,6 +224,13 @@ bool BoundingBoxTree::collides_entity(const Point& point) const
   return compute_first_entity_collision(point) != std::numeric_limits<unsigned int>::max();
 }
 //-----------------------------------------------------------------------------
+std::size_t BoundingBoxTree::gdim() const
+{
+  _check_built();
+  dolfin_assert(_tree);
+  return _tree->gdim();
+}
+//-----------------------------------------------------------------------------
 void BoundingBoxTree::_check_built() const
 {
   if (!_tree)
@@ -240,6 +240,38 @@ namespace dolfin
     std::pair<unsigned int, double>
     compute_closest_point(const Point& point) const;
 
+    /// Compute first collision between entities and each point in a
+    /// batch of points. The points are processed in the order of a
+    /// space-filling curve, using multiple threads if the global
+    /// parameter "num_threads" is set.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         For each point, the local index for the first found
+    ///         entity that collides with (intersects) the point, or
+    ///         std::numeric_limits<unsigned int>::max() if not found.
+    ///
+    /// *Arguments*
+    ///     x (std::vector<double>)
+    ///         The point coordinates (num_points x gdim, row major).
+    std::vector<unsigned int>
+    compute_first_entity_collisions(const std::vector<double>& x) const;
+
+    /// Compute closest entity to each point in a batch of points. The
+    /// points are processed as for compute_first_entity_collisions.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         For each point, the local index for the closest entity.
+    ///     std::vector<double>
+    ///         For each point, the distance to the closest entity.
+    ///
+    /// *Arguments*
+    ///     x (std::vector<double>)
+    ///         The point coordinates (num_points x gdim, row major).
+    std::pair<std::vector<unsigned int>, std::vector<double>>
+    compute_closest_entities(const std::vector<double>& x) const;
+
     /// Check whether given point collides with the bounding box tree.
     /// This is equivalent to calling compute_first_collision and
     /// checking whether any collision was detected.
@@ -259,6 +291,14 @@ namespace dolfin
     ///         True iff the point is inside the tree.
     bool collides_entity(const Point& point) const;
 
+    /// Return geometric dimension of the bounding boxes. The tree
+    /// must have been built.
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The geometric dimension.
+    std::size_t gdim() const;
+
   private:
 
     // Check that tree has been built
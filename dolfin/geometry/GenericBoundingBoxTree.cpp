@@ -23,7 +23,15 @@
 // recursion and is more convenient than sending it around.
 #define MAX_DIM 6
 
+#include <algorithm>
+#include <cstdint>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/common/MPI.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/geometry/Point.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/Cell.h>
@@ -319,6 +327,92 @@ GenericBoundingBoxTree::compute_closest_point(const Point& point) const
   return ret;
 }
 //-----------------------------------------------------------------------------
+std::vector<unsigned int>
+GenericBoundingBoxTree::compute_first_entity_collisions(
+  const std::vector<double>& x, const Mesh& mesh) const
+{
+  // Point in entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute collision between points and mesh entities",
+                 "Point-in-entity is only implemented for cells");
+  }
+
+  // Visit points along a space-filling curve, so that consecutive
+  // queries (on the same thread) traverse similar parts of the tree
+  const std::size_t _gdim = gdim();
+  if (x.size() % _gdim != 0)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute collision between points and mesh entities",
+                 "Number of point coordinates (%d) is not a multiple of the geometric dimension (%d)",
+                 x.size(), _gdim);
+  }
+  const std::int64_t num_points = x.size()/_gdim;
+  const std::vector<std::size_t> order = compute_morton_order(x, _gdim);
+
+  std::vector<unsigned int> entities(num_points);
+  const unsigned int root = num_bboxes() - 1;
+  #ifdef HAS_OPENMP
+  const int num_threads = std::max(1, (int) parameters["num_threads"]);
+  #pragma omp parallel for schedule(static) num_threads(num_threads)
+  #endif
+  for (std::int64_t i = 0; i < num_points; ++i)
+  {
+    const std::size_t p = order[i];
+    const Point point(_gdim, x.data() + _gdim*p);
+    entities[p] = _compute_first_entity_collision(*this, point, root, mesh);
+  }
+
+  return entities;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::vector<unsigned int>, std::vector<double>>
+GenericBoundingBoxTree::compute_closest_entities(const std::vector<double>& x,
+                                                 const Mesh& mesh) const
+{
+  // Closest entity only implemented for cells. Consider extending this.
+  if (_tdim != mesh.topology().dim())
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute closest entity of points",
+                 "Closest-entity is only implemented for cells");
+  }
+
+  // Compute point search tree before spawning threads
+  build_point_search_tree(mesh);
+
+  const std::size_t _gdim = gdim();
+  if (x.size() % _gdim != 0)
+  {
+    dolfin_error("GenericBoundingBoxTree.cpp",
+                 "compute closest entity of points",
+                 "Number of point coordinates (%d) is not a multiple of the geometric dimension (%d)",
+                 x.size(), _gdim);
+  }
+  const std::int64_t num_points = x.size()/_gdim;
+  const std::vector<std::size_t> order = compute_morton_order(x, _gdim);
+
+  std::vector<unsigned int> entities(num_points);
+  std::vector<double> distances(num_points);
+  #ifdef HAS_OPENMP
+  const int num_threads = std::max(1, (int) parameters["num_threads"]);
+  #pragma omp parallel for schedule(static) num_threads(num_threads)
+  #endif
+  for (std::int64_t i = 0; i < num_points; ++i)
+  {
+    const std::size_t p = order[i];
+    const Point point(_gdim, x.data() + _gdim*p);
+    const std::pair<unsigned int, double> closest
+      = compute_closest_entity(point, mesh);
+    entities[p] = closest.first;
+    distances[p] = closest.second;
+  }
+
+  return std::make_pair(entities, distances);
+}
+//-----------------------------------------------------------------------------
 // Implementation of protected functions
 //-----------------------------------------------------------------------------
 void GenericBoundingBoxTree::clear()
@@ -755,6 +849,50 @@ void GenericBoundingBoxTree::compute_bbox_of_entity(double* b,
   }
 }
 //-----------------------------------------------------------------------------
+std::vector<std::size_t>
+GenericBoundingBoxTree::compute_morton_order(const std::vector<double>& x,
+                                             std::size_t gdim)
+{
+  dolfin_assert(gdim > 0);
+  const std::size_t num_points = x.size()/gdim;
+
+  // Compute bounding box of points
+  std::vector<double> xmin(gdim, std::numeric_limits<double>::max());
+  std::vector<double> xmax(gdim, std::numeric_limits<double>::lowest());
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      xmin[j] = std::min(xmin[j], x[i*gdim + j]);
+      xmax[j] = std::max(xmax[j], x[i*gdim + j]);
+    }
+  }
+
+  // Quantise coordinates to integers and interleave their bits
+  const std::size_t bits = std::min<std::size_t>(63/gdim, 32);
+  const double max_int = static_cast<double>((std::uint64_t(1) << bits) - 1);
+  std::vector<std::pair<std::uint64_t, std::size_t>> keys(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    std::uint64_t key = 0;
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      const double h = xmax[j] - xmin[j];
+      const std::uint64_t q = h > 0.0
+        ? static_cast<std::uint64_t>((x[i*gdim + j] - xmin[j])/h*max_int) : 0;
+      for (std::size_t b = 0; b < bits; ++b)
+        key |= ((q >> b) & 1) << (b*gdim + j);
+    }
+    keys[i] = std::make_pair(key, i);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<std::size_t> order(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    order[i] = keys[i].second;
+  return order;
+}
+//-----------------------------------------------------------------------------
 void
 GenericBoundingBoxTree::sort_points(std::size_t axis,
                                     const std::vector<Point>& points,
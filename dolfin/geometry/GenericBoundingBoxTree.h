@@ -92,9 +92,24 @@ namespace dolfin
     /// Compute closest point and distance to _Point_
     std::pair<unsigned int, double> compute_closest_point(const Point& point) const;
 
+    /// Compute first collision between entities and each point in a
+    /// batch of points (num_points x gdim, row major)
+    std::vector<unsigned int>
+    compute_first_entity_collisions(const std::vector<double>& x,
+                                    const Mesh& mesh) const;
+
+    /// Compute closest entity and distance to each point in a batch
+    /// of points (num_points x gdim, row major)
+    std::pair<std::vector<unsigned int>, std::vector<double>>
+    compute_closest_entities(const std::vector<double>& x,
+                             const Mesh& mesh) const;
+
     /// Print out for debugging
     std::string str(bool verbose=false);
 
+    /// Return geometric dimension
+    virtual std::size_t gdim() const = 0;
+
   protected:
 
     /// Bounding box data. Leaf nodes are indicated by setting child_0
@@ -203,6 +218,11 @@ namespace dolfin
                                 const MeshEntity& entity,
                                 std::size_t gdim) const;
 
+    /// Compute ordering of a batch of points (num_points x gdim, row
+    /// major) along a Morton (Z-order) space-filling curve
+    static std::vector<std::size_t>
+    compute_morton_order(const std::vector<double>& x, std::size_t gdim);
+
     /// Sort points along given axis
     void sort_points(std::size_t axis,
                      const std::vector<Point>& points,
@@ -324,9 +344,6 @@ namespace dolfin
 
     //--- Dimension-dependent functions to be implemented by subclass ---
 
-    /// Return geometric dimension
-    virtual std::size_t gdim() const = 0;
-
     /// Return bounding box coordinates for node
     virtual const double* get_bbox_coordinates(unsigned int node) const = 0;
 
@@ -0,0 +1,346 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <dolfin/common/constants.h>
+#include <dolfin/geometry/Point.h>
+#include <dolfin/log/log.h>
+#include <dolfin/mesh/Cell.h>
+#include <dolfin/mesh/Mesh.h>
+#include <dolfin/mesh/MeshEntity.h>
+#include <dolfin/mesh/MeshEntityIterator.h>
+#include "WideBoundingBoxTree.h"
+
+using namespace dolfin;
+
+const std::size_t WideBoundingBoxTree::width;
+const std::size_t WideBoundingBoxTree::max_stack_size;
+const unsigned int WideBoundingBoxTree::not_found;
+
+//-----------------------------------------------------------------------------
+WideBoundingBoxTree::WideBoundingBoxTree() : _tdim(0), _mesh(0)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+WideBoundingBoxTree::~WideBoundingBoxTree()
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+void WideBoundingBoxTree::build(const Mesh& mesh)
+{
+  build(mesh, mesh.topology().dim());
+}
+//-----------------------------------------------------------------------------
+void WideBoundingBoxTree::build(const Mesh& mesh, std::size_t tdim)
+{
+  // Check dimension
+  if (tdim < 1 or tdim > mesh.topology().dim())
+  {
+    dolfin_error("WideBoundingBoxTree.cpp",
+                 "compute bounding box tree",
+                 "Dimension must be a number between 1 and %d",
+                 mesh.topology().dim());
+  }
+
+  _nodes.clear();
+  _tdim = tdim;
+  _mesh = &mesh;
+
+  // Initialize entities of given dimension if they don't exist
+  mesh.init(tdim);
+
+  // Compute bounding boxes (xmin, xmax) of all entities, padded to
+  // three dimensions. Boxes are enlarged by the same tolerance as
+  // used by BoundingBoxTree when testing points, so that no
+  // tolerance is needed during traversal.
+  const std::size_t gdim = mesh.geometry().dim();
+  const MeshGeometry& geometry = mesh.geometry();
+  const unsigned int num_leaves = mesh.num_entities(tdim);
+  std::vector<double> leaf_bboxes(6*num_leaves);
+  for (MeshEntityIterator e(mesh, tdim); !e.end(); ++e)
+  {
+    double* xmin = leaf_bboxes.data() + 6*e->index();
+    double* xmax = xmin + 3;
+    std::fill(xmin, xmin + 3, std::numeric_limits<double>::max());
+    std::fill(xmax, xmax + 3, std::numeric_limits<double>::lowest());
+
+    const unsigned int* vertices = e->entities(0);
+    for (std::size_t i = 0; i < e->num_entities(0); ++i)
+    {
+      const double* x = geometry.x(vertices[i]);
+      for (std::size_t j = 0; j < gdim; ++j)
+      {
+        xmin[j] = std::min(xmin[j], x[j]);
+        xmax[j] = std::max(xmax[j], x[j]);
+      }
+    }
+
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      const double eps = DOLFIN_EPS_LARGE*(xmax[j] - xmin[j]);
+      xmin[j] -= eps;
+      xmax[j] += eps;
+    }
+    for (std::size_t j = gdim; j < 3; ++j)
+    {
+      xmin[j] = std::numeric_limits<double>::lowest();
+      xmax[j] = std::numeric_limits<double>::max();
+    }
+  }
+
+  // Create leaf partition (to be sorted)
+  std::vector<unsigned int> leaf_partition(num_leaves);
+  for (unsigned int i = 0; i < num_leaves; ++i)
+    leaf_partition[i] = i;
+
+  // Recursively build the tree from the leaves
+  if (num_leaves > 0)
+    _build(leaf_bboxes, leaf_partition.begin(), leaf_partition.end(), 1);
+
+  log(PROGRESS,
+      "Computed wide bounding box tree with %d nodes for %d entities.",
+      _nodes.size(), num_leaves);
+}
+//-----------------------------------------------------------------------------
+std::vector<unsigned int>
+WideBoundingBoxTree::compute_collisions(const Point& point) const
+{
+  _check_built();
+  std::vector<unsigned int> entities;
+  traverse(point.coordinates(), [&entities](unsigned int entity)
+           {
+             entities.push_back(entity);
+             return false;
+           });
+  return entities;
+}
+//-----------------------------------------------------------------------------
+std::vector<unsigned int>
+WideBoundingBoxTree::compute_entity_collisions(const Point& point) const
+{
+  _check_built();
+  _check_cells();
+  dolfin_assert(_mesh);
+  const Mesh& mesh = *_mesh;
+  std::vector<unsigned int> entities;
+  traverse(point.coordinates(), [&](unsigned int entity)
+           {
+             if (Cell(mesh, entity).collides(point))
+               entities.push_back(entity);
+             return false;
+           });
+  return entities;
+}
+//-----------------------------------------------------------------------------
+unsigned int
+WideBoundingBoxTree::compute_first_collision(const Point& point) const
+{
+  _check_built();
+  return traverse(point.coordinates(), [](unsigned int)
+                  { return true; });
+}
+//-----------------------------------------------------------------------------
+unsigned int
+WideBoundingBoxTree::compute_first_entity_collision(const Point& point) const
+{
+  _check_built();
+  _check_cells();
+  dolfin_assert(_mesh);
+  const Mesh& mesh = *_mesh;
+  return traverse(point.coordinates(), [&](unsigned int entity)
+                  { return Cell(mesh, entity).collides(point); });
+}
+//-----------------------------------------------------------------------------
+bool WideBoundingBoxTree::collides(const Point& point) const
+{
+  return compute_first_collision(point) != not_found;
+}
+//-----------------------------------------------------------------------------
+bool WideBoundingBoxTree::collides_entity(const Point& point) const
+{
+  return compute_first_entity_collision(point) != not_found;
+}
+//-----------------------------------------------------------------------------
+void WideBoundingBoxTree::_check_built() const
+{
+  if (!_mesh)
+  {
+    dolfin_error("WideBoundingBoxTree.cpp",
+                 "compute collisions with bounding box tree",
+                 "Bounding box tree has not been built. You need to call tree.build()");
+  }
+}
+//-----------------------------------------------------------------------------
+void WideBoundingBoxTree::_check_cells() const
+{
+  // Point in entity only implemented for cells
+  dolfin_assert(_mesh);
+  if (_tdim != _mesh->topology().dim())
+  {
+    dolfin_error("WideBoundingBoxTree.cpp",
+                 "compute collision between point and mesh entities",
+                 "Point-in-entity is only implemented for cells");
+  }
+}
+//-----------------------------------------------------------------------------
+std::int64_t
+WideBoundingBoxTree::_build(const std::vector<double>& leaf_bboxes,
+                            std::vector<unsigned int>::iterator begin,
+                            std::vector<unsigned int>::iterator end,
+                            std::size_t depth)
+{
+  dolfin_assert(begin < end);
+
+  // Check that traversal of the tree fits in the fixed-size stack,
+  // which holds at most width - 1 pending nodes per level
+  if (depth*(width - 1) + 1 > max_stack_size)
+  {
+    dolfin_error("WideBoundingBoxTree.cpp",
+                 "compute bounding box tree",
+                 "Tree depth %d exceeds maximum traversal depth %d",
+                 depth, (max_stack_size - 1)/(width - 1));
+  }
+
+  // Split leaves into (at most) width groups by repeated median
+  // splits along the longest axis
+  std::vector<std::vector<unsigned int>::iterator> splits = {begin, end};
+  if (end - begin <= (std::ptrdiff_t) width)
+  {
+    splits.clear();
+    for (auto it = begin; it != end; ++it)
+      splits.push_back(it);
+    splits.push_back(end);
+  }
+  else
+  {
+    double b[6];
+    while (splits.size() < width + 1)
+    {
+      std::vector<std::vector<unsigned int>::iterator> _splits;
+      for (std::size_t i = 0; i + 1 < splits.size(); ++i)
+      {
+        const auto first = splits[i];
+        const auto last = splits[i + 1];
+        _splits.push_back(first);
+        if (last - first < 2)
+          continue;
+
+        const std::size_t axis
+          = compute_bbox_of_bboxes(b, leaf_bboxes, first, last);
+        const auto middle = first + (last - first)/2;
+        std::nth_element(first, middle, last,
+                         [&leaf_bboxes, axis](unsigned int i, unsigned int j)
+                         {
+                           const double* bi = leaf_bboxes.data() + 6*i;
+                           const double* bj = leaf_bboxes.data() + 6*j;
+                           return bi[axis] + bi[axis + 3]
+                             < bj[axis] + bj[axis + 3];
+                         });
+        _splits.push_back(middle);
+      }
+      _splits.push_back(end);
+      splits.swap(_splits);
+    }
+  }
+
+  // Add node, with all slots initially empty. Note that the node
+  // must be accessed by index since recursion may reallocate
+  const std::size_t index = _nodes.size();
+  _nodes.push_back(Node());
+  for (std::size_t i = 0; i < width; ++i)
+  {
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      _nodes[index].xmin[j][i] = std::numeric_limits<double>::max();
+      _nodes[index].xmax[j][i] = std::numeric_limits<double>::lowest();
+    }
+    _nodes[index].child[i] = -1;
+  }
+
+  // Add children
+  dolfin_assert(splits.size() <= width + 1);
+  for (std::size_t i = 0; i + 1 < splits.size(); ++i)
+  {
+    const auto first = splits[i];
+    const auto last = splits[i + 1];
+
+    double b[6];
+    std::int64_t child;
+    if (last - first == 1)
+    {
+      // Leaf
+      std::copy(leaf_bboxes.data() + 6*(*first),
+                leaf_bboxes.data() + 6*(*first) + 6, b);
+      child = -static_cast<std::int64_t>(*first) - 1;
+    }
+    else
+    {
+      compute_bbox_of_bboxes(b, leaf_bboxes, first, last);
+      child = _build(leaf_bboxes, first, last, depth + 1);
+    }
+
+    Node& node = _nodes[index];
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      node.xmin[j][i] = b[j];
+      node.xmax[j][i] = b[j + 3];
+    }
+    node.child[i] = child;
+  }
+
+  return index;
+}
+//-----------------------------------------------------------------------------
+std::size_t WideBoundingBoxTree::compute_bbox_of_bboxes(
+  double* bbox,
+  const std::vector<double>& leaf_bboxes,
+  std::vector<unsigned int>::const_iterator begin,
+  std::vector<unsigned int>::const_iterator end)
+{
+  dolfin_assert(begin < end);
+  std::copy(leaf_bboxes.data() + 6*(*begin),
+            leaf_bboxes.data() + 6*(*begin) + 6, bbox);
+  for (auto it = begin + 1; it != end; ++it)
+  {
+    const double* b = leaf_bboxes.data() + 6*(*it);
+    for (std::size_t j = 0; j < 3; ++j)
+    {
+      bbox[j] = std::min(bbox[j], b[j]);
+      bbox[j + 3] = std::max(bbox[j + 3], b[j + 3]);
+    }
+  }
+
+  // Compute longest axis, ignoring padded dimensions (which have
+  // infinite extent)
+  std::size_t axis = 0;
+  double longest = -1.0;
+  for (std::size_t j = 0; j < 3; ++j)
+  {
+    if (bbox[j] == std::numeric_limits<double>::lowest())
+      continue;
+    const double length = bbox[j + 3] - bbox[j];
+    if (length > longest)
+    {
+      axis = j;
+      longest = length;
+    }
+  }
+  return axis;
+}
+//-----------------------------------------------------------------------------
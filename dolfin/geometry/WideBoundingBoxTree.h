@@ -0,0 +1,254 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __WIDE_BOUNDING_BOX_TREE_H
+#define __WIDE_BOUNDING_BOX_TREE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace dolfin
+{
+
+  // Forward declarations
+  class Mesh;
+  class Point;
+
+  /// This class implements an axis aligned bounding box tree with
+  /// wide nodes, intended for fast repeated point location in
+  /// meshes. Each node stores the bounding boxes of its (up to)
+  /// width children as a structure of arrays, so that a point is
+  /// tested against all children of a node in one vectorisable
+  /// loop, and the tree is traversed iteratively using an explicit
+  /// stack.
+  ///
+  /// The point queries return the same entities as the
+  /// corresponding functions of _BoundingBoxTree_, but possibly in
+  /// a different order. In particular, if a point is contained in
+  /// more than one entity, compute_first_entity_collision may
+  /// return a different entity than _BoundingBoxTree_.
+
+  class WideBoundingBoxTree
+  {
+  public:
+
+    /// Number of children of each node
+    static const std::size_t width = 4;
+
+    /// Create empty bounding box tree
+    WideBoundingBoxTree();
+
+    /// Destructor
+    ~WideBoundingBoxTree();
+
+    /// Build bounding box tree for cells of mesh.
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh for which to compute the bounding box tree.
+    void build(const Mesh& mesh);
+
+    /// Build bounding box tree for mesh entities of given dimension.
+    ///
+    /// *Arguments*
+    ///     mesh (_Mesh_)
+    ///         The mesh for which to compute the bounding box tree.
+    ///     tdim (std::size_t)
+    ///         The entity dimension (topological dimension) for which
+    ///         to compute the bounding box tree.
+    void build(const Mesh& mesh, std::size_t tdim);
+
+    /// Compute all collisions between bounding boxes and _Point_.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         A list of local indices for entities contained in
+    ///         (leaf) bounding boxes that collide with (intersect)
+    ///         the given point.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    std::vector<unsigned int> compute_collisions(const Point& point) const;
+
+    /// Compute all collisions between entities and _Point_.
+    ///
+    /// *Returns*
+    ///     std::vector<unsigned int>
+    ///         A list of local indices for entities that collide with
+    ///         (intersect) the given point.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    std::vector<unsigned int>
+    compute_entity_collisions(const Point& point) const;
+
+    /// Compute first collision between bounding boxes and _Point_.
+    ///
+    /// *Returns*
+    ///     unsigned int
+    ///         The local index for the first found entity contained
+    ///         in a (leaf) bounding box that collides with
+    ///         (intersects) the given point. If not found,
+    ///         std::numeric_limits<unsigned int>::max() is returned.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    unsigned int compute_first_collision(const Point& point) const;
+
+    /// Compute first collision between entities and _Point_.
+    ///
+    /// *Returns*
+    ///     unsigned int
+    ///         The local index for the first found entity that
+    ///         collides with (intersects) the given point. If not
+    ///         found, std::numeric_limits<unsigned int>::max() is
+    ///         returned.
+    ///
+    /// *Arguments*
+    ///     point (_Point_)
+    ///         The point.
+    unsigned int compute_first_entity_collision(const Point& point) const;
+
+    /// Check whether given point collides with the bounding box tree
+    bool collides(const Point& point) const;
+
+    /// Check whether given point collides with any entity contained
+    /// in the bounding box tree
+    bool collides_entity(const Point& point) const;
+
+    /// Return number of nodes in the tree
+    std::size_t num_nodes() const
+    { return _nodes.size(); }
+
+  private:
+
+    // Node of the tree, holding the bounding boxes of its children
+    // per axis. Child i is the node child[i] if child[i] >= 0, and
+    // a leaf containing entity -(child[i] + 1) otherwise. Unused
+    // slots have empty boxes (xmin > xmax) so that they never
+    // collide with a point.
+    struct Node
+    {
+      double xmin[3][width];
+      double xmax[3][width];
+      std::int64_t child[width];
+    };
+
+    // Maximum size of the traversal stack. Tree depth is checked
+    // against this when building, so traversal cannot overflow.
+    static const std::size_t max_stack_size = 256;
+
+    // Check that tree has been built
+    void _check_built() const;
+
+    // Check that the tree holds cells of the mesh
+    void _check_cells() const;
+
+    // Build tree for the leaves in [begin, end) with given bounding
+    // boxes (recursive), returning index of the new node
+    std::int64_t _build(const std::vector<double>& leaf_bboxes,
+                        std::vector<unsigned int>::iterator begin,
+                        std::vector<unsigned int>::iterator end,
+                        std::size_t depth);
+
+    // Compute bounding box (xmin, xmax) of leaves in [begin, end)
+    // and return its longest axis
+    static std::size_t
+    compute_bbox_of_bboxes(double* bbox,
+                           const std::vector<double>& leaf_bboxes,
+                           std::vector<unsigned int>::const_iterator begin,
+                           std::vector<unsigned int>::const_iterator end);
+
+    // Return bit mask of the children of node containing point x
+    inline unsigned int point_in_children(const Node& node,
+                                          const double* x) const
+    {
+      unsigned int mask = 0;
+      for (std::size_t i = 0; i < width; ++i)
+      {
+        const bool inside
+          = (node.xmin[0][i] <= x[0]) & (x[0] <= node.xmax[0][i])
+          & (node.xmin[1][i] <= x[1]) & (x[1] <= node.xmax[1][i])
+          & (node.xmin[2][i] <= x[2]) & (x[2] <= node.xmax[2][i]);
+        mask |= static_cast<unsigned int>(inside) << i;
+      }
+      return mask;
+    }
+
+    // Traverse the tree depth-first for point x, calling f(entity)
+    // for each leaf that contains x until f returns true. Returns
+    // the entity for which f returned true, or not_found.
+    template<typename F>
+    unsigned int traverse(const double* x, F f) const
+    {
+      if (_nodes.empty())
+        return not_found;
+
+      std::int64_t stack[max_stack_size];
+      std::size_t size = 0;
+      stack[size++] = 0;
+      while (size > 0)
+      {
+        const Node& node = _nodes[stack[--size]];
+        const unsigned int mask = point_in_children(node, x);
+        if (mask == 0)
+          continue;
+
+        // Check leaves
+        for (std::size_t i = 0; i < width; ++i)
+        {
+          if ((mask & (1u << i)) && node.child[i] < 0)
+          {
+            const unsigned int entity = -(node.child[i] + 1);
+            if (f(entity))
+              return entity;
+          }
+        }
+
+        // Push child nodes in reverse order so that the first child
+        // is visited first
+        for (std::size_t i = width; i-- > 0;)
+        {
+          if ((mask & (1u << i)) && node.child[i] >= 0)
+            stack[size++] = node.child[i];
+        }
+      }
+      return not_found;
+    }
+
+    // Value returned when no collision is found
+    static const unsigned int not_found
+      = std::numeric_limits<unsigned int>::max();
+
+    // Topological dimension of leaf entities
+    std::size_t _tdim;
+
+    // Nodes, root node first
+    std::vector<Node> _nodes;
+
+    // The mesh the tree has been built for
+    const Mesh* _mesh;
+
+  };
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <dolfin/geometry/BoundingBoxTree.h>
 #include <dolfin/geometry/GenericBoundingBoxTree.h>
 #include <dolfin/geometry/BoundingBoxTree3D.h>
+#include <dolfin/geometry/WideBoundingBoxTree.h>
 #include <dolfin/geometry/MeshPointIntersection.h>
 #include <dolfin/geometry/CollisionPredicates.h>
 #include <dolfin/geometry/intersect.h>
@@ -19,10 +19,12 @@
 
 #ifdef HAS_HDF5
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <string>
 #include <boost/unordered_map.hpp>
 #include <boost/filesystem.hpp>
@@ -65,6 +67,12 @@ HDF5File::HDF5File(MPI_Comm comm, const std::string filename,
   // HDF5 chunking
   parameters.add("chunking", false);
 
+  // HDF5 compression. Compressed datasets are always chunked. See
+  // also HDF5File::set_compression.
+  const std::set<std::string> filters = {"none", "deflate", "shuffle_deflate"};
+  parameters.add("compression", "none", filters);
+  parameters.add("compression_level", 4, 0, 9);
+
   // Create directory, if required (create on rank 0)
   if (_mpi_comm.rank() == 0)
   {
@@ -120,6 +128,34 @@ void HDF5File::flush()
   HDF5Interface::flush_file(_hdf5_file_id);
 }
 //-----------------------------------------------------------------------------
+void HDF5File::set_compression(const std::string name,
+                               const std::string compression,
+                               int compression_level)
+{
+  if (compression != "none" and compression != "deflate"
+      and compression != "shuffle_deflate")
+  {
+    dolfin_error("HDF5File.cpp",
+                 "set compression",
+                 "Unknown compression \"%s\" (use \"none\", \"deflate\" or \"shuffle_deflate\")",
+                 compression.c_str());
+  }
+
+  if (compression_level < 0 or compression_level > 9)
+  {
+    dolfin_error("HDF5File.cpp",
+                 "set compression",
+                 "Compression level must be between 0 and 9");
+  }
+
+  // Store with leading '/' and without trailing '/'
+  std::string path = (name.size() > 0 and name[0] == '/') ? name : "/" + name;
+  while (path.size() > 1 and path.back() == '/')
+    path.pop_back();
+
+  _compression[path] = std::make_pair(compression, compression_level);
+}
+//-----------------------------------------------------------------------------
 void HDF5File::write(const std::vector<Point>& points,
                      const std::string dataset_name)
 {
@@ -164,13 +200,22 @@ void HDF5File::write(const GenericVector& x, const std::string dataset_name)
   std::vector<double> local_data;
   x.get_local(local_data);
 
+  // Get chunking and compression
+  const std::pair<std::string, int> compression
+    = get_compression(dataset_name);
+  const bool chunking = parameters["chunking"]
+    or compression.first != "none";
+  const std::int64_t chunk_rows = chunking
+    ? compute_chunk_rows(local_data.size(), sizeof(double)) : 0;
+
   // Write data to file
   std::pair<std::size_t, std::size_t> local_range = x.local_range();
-  const bool chunking = parameters["chunking"];
   const std::vector<std::int64_t> global_size(1, x.size());
   const bool mpi_io = _mpi_comm.size() > 1 ? true : false;
   HDF5Interface::write_dataset(_hdf5_file_id, dataset_name, local_data,
-                               local_range, global_size, mpi_io, chunking);
+                               local_range, global_size, mpi_io, chunking,
+                               chunk_rows, compression.first,
+                               compression.second);
 
   // Add partitioning attribute to dataset
   std::vector<std::size_t> partitions;
@@ -254,7 +299,7 @@ void HDF5File::read(GenericVector& x, const std::string dataset_name,
 
   // Read data from file
   std::vector<double> data;
-  HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, local_range, data);
+  read_data(dataset_name, local_range, data);
 
   // Set data
   x.set_local(data);
@@ -626,8 +671,7 @@ void HDF5File::read_mesh_function(MeshFunction<T>& meshfunction,
   // Read a block of cells
   std::vector<std::size_t> topology_data;
   topology_data.reserve(num_read_cells*vertices_per_cell);
-  HDF5Interface::read_dataset(_hdf5_file_id, topology_name, cell_range,
-                              topology_data);
+  read_data(topology_name, cell_range, topology_data);
 
   boost::multi_array_ref<std::size_t, 2>
     topology_array(topology_data.data(),
@@ -635,8 +679,7 @@ void HDF5File::read_mesh_function(MeshFunction<T>& meshfunction,
 
   std::vector<T> value_data;
   value_data.reserve(num_read_cells);
-  HDF5Interface::read_dataset(_hdf5_file_id, values_name, cell_range,
-                              value_data);
+  read_data(values_name, cell_range, value_data);
 
   // Now send the read data to each process on the basis of the first
   // vertex of the entity, since we do not know the global_index
@@ -1043,22 +1086,21 @@ void HDF5File::read(Function& u, const std::string name)
 
   // Read cells
   std::vector<std::size_t> input_cells;
-  HDF5Interface::read_dataset(_hdf5_file_id, cells_dataset_name,
-                              cell_range, input_cells);
+  read_data(cells_dataset_name, cell_range, input_cells);
 
   // Overlap reads of DOF indices, to get full range on each process
   std::vector<std::size_t> x_cell_dofs;
-  HDF5Interface::read_dataset(_hdf5_file_id, x_cell_dofs_dataset_name,
-                              std::make_pair(cell_range.first,
-                                             cell_range.second + 1),
-                              x_cell_dofs);
+  read_data(x_cell_dofs_dataset_name,
+            std::make_pair(cell_range.first,
+                           cell_range.second + 1),
+            x_cell_dofs);
 
   // Read cell-DOF maps
   std::vector<dolfin::la_index> input_cell_dofs;
-  HDF5Interface::read_dataset(_hdf5_file_id, cell_dofs_dataset_name,
-                              std::make_pair(x_cell_dofs.front(),
-                                             x_cell_dofs.back()),
-                              input_cell_dofs);
+  read_data(cell_dofs_dataset_name,
+            std::make_pair(x_cell_dofs.front(),
+                           x_cell_dofs.back()),
+            input_cell_dofs);
 
   GenericVector& x = *u.vector();
 
@@ -1070,8 +1112,7 @@ void HDF5File::read(Function& u, const std::string name)
     input_vector_range = MPI::local_range(_mpi_comm.comm(), vector_shape[0]);
 
   std::vector<double> input_values;
-  HDF5Interface::read_dataset(_hdf5_file_id, vector_dataset_name,
-                              input_vector_range, input_values);
+  read_data(vector_dataset_name, input_vector_range, input_values);
 
   HDF5Utility::set_local_vector_values(_mpi_comm.comm(), x, mesh, input_cells,
                                        input_cell_dofs, x_cell_dofs,
@@ -1109,14 +1150,21 @@ void HDF5File::write(const MeshValueCollection<bool>& mesh_values,
   // HDF5 does not implement bool, use int and copy
 
   MeshValueCollection<int> mvc_int(mesh_values.mesh(), mesh_values.dim());
-  const std::map<std::pair<std::size_t, std::size_t>, bool>& values
-    = mesh_values.values();
+  const std::vector<std::pair<std::pair<std::size_t, std::size_t>, bool>>&
+    values = mesh_values.values();
+  std::vector<std::size_t> cells, local_entities;
+  std::vector<int> int_values;
+  cells.reserve(values.size());
+  local_entities.reserve(values.size());
+  int_values.reserve(values.size());
   for (auto mesh_value_it = values.begin(); mesh_value_it != values.end();
        ++mesh_value_it)
   {
-    mvc_int.set_value(mesh_value_it->first.first, mesh_value_it->first.second,
-                      mesh_value_it->second ? 1 : 0);
+    cells.push_back(mesh_value_it->first.first);
+    local_entities.push_back(mesh_value_it->first.second);
+    int_values.push_back(mesh_value_it->second ? 1 : 0);
   }
+  mvc_int.set_values(cells, local_entities, int_values);
 
   write_mesh_value_collection(mvc_int, name);
 }
@@ -1129,15 +1177,21 @@ void HDF5File::read(MeshValueCollection<bool>& mesh_values,
   MeshValueCollection<int> mvc_int(mesh_values.mesh(), mesh_values.dim());
   read_mesh_value_collection(mvc_int, name);
 
-  const std::map<std::pair<std::size_t, std::size_t>, int>& values
-    = mvc_int.values();
+  const std::vector<std::pair<std::pair<std::size_t, std::size_t>, int>>&
+    values = mvc_int.values();
+  std::vector<std::size_t> cells, local_entities;
+  std::vector<bool> bool_values;
+  cells.reserve(values.size());
+  local_entities.reserve(values.size());
+  bool_values.reserve(values.size());
   for (auto mesh_value_it = values.begin(); mesh_value_it != values.end();
        ++mesh_value_it)
   {
-    mesh_values.set_value(mesh_value_it->first.first,
-                          mesh_value_it->first.second,
-                          (mesh_value_it->second != 0));
+    cells.push_back(mesh_value_it->first.first);
+    local_entities.push_back(mesh_value_it->first.second);
+    bool_values.push_back(mesh_value_it->second != 0);
   }
+  mesh_values.set_values(cells, local_entities, bool_values);
 
 }
 //-----------------------------------------------------------------------------
@@ -1150,8 +1204,8 @@ void HDF5File::write_mesh_value_collection(const MeshValueCollection<T>& mesh_va
   const std::size_t dim = mesh_values.dim();
   std::shared_ptr<const Mesh> mesh = mesh_values.mesh();
 
-  const std::map<std::pair<std::size_t, std::size_t>, T>& values
-    = mesh_values.values();
+  const std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>&
+    values = mesh_values.values();
 
   std::unique_ptr<CellType>
     entity_type(CellType::create(mesh->type().entity_type(dim)));
@@ -1199,8 +1253,8 @@ void HDF5File::write_mesh_value_collection_old(
 {
   dolfin_assert(_hdf5_file_id > 0);
 
-  const std::map<std::pair<std::size_t, std::size_t>, T>& values
-    = mesh_values.values();
+  const std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>&
+    values = mesh_values.values();
 
   const Mesh& mesh = *mesh_values.mesh();
   const std::vector<std::int64_t>& global_cell_index
@@ -1297,12 +1351,10 @@ void HDF5File::read_mesh_value_collection(MeshValueCollection<T>& mesh_vc,
   // Read local range of values and entities
   std::vector<T> values_data;
   values_data.reserve(local_size);
-  HDF5Interface::read_dataset(_hdf5_file_id, values_name, data_range,
-                              values_data);
+  read_data(values_name, data_range, values_data);
   std::vector<std::size_t> topology_data;
   topology_data.reserve(local_size*num_verts_per_entity);
-  HDF5Interface::read_dataset(_hdf5_file_id, topology_name, data_range,
-                              topology_data);
+  read_data(topology_name, data_range, topology_data);
 
   /// Basically need to tabulate all entities by vertex, and get their
   /// local index, transmit them to a 'sorting' host.  Also send the
@@ -1419,14 +1471,16 @@ void HDF5File::read_mesh_value_collection(MeshValueCollection<T>& mesh_vc,
   MPI::all_to_all(_mpi_comm.comm(), send_entities, recv_entities);
   MPI::all_to_all(_mpi_comm.comm(), send_data, recv_data);
 
+  std::vector<std::size_t> entities;
+  std::vector<T> values;
   for (std::size_t i = 0; i != num_processes; ++i)
   {
     dolfin_assert(recv_entities[i].size() == recv_data[i].size());
-    for (std::size_t j = 0; j != recv_data[i].size(); ++j)
-    {
-      mesh_vc.set_value(recv_entities[i][j], recv_data[i][j]);
-    }
+    entities.insert(entities.end(), recv_entities[i].begin(),
+                    recv_entities[i].end());
+    values.insert(values.end(), recv_data[i].begin(), recv_data[i].end());
   }
+  mesh_vc.set_values(entities, values);
 
 }
 //-----------------------------------------------------------------------------
@@ -1497,23 +1551,22 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
 
     std::vector<T> values_data;
     values_data.reserve(local_size);
-    HDF5Interface::read_dataset(_hdf5_file_id, values_name, range, values_data);
+    read_data(values_name, range, values_data);
     std::vector<std::size_t> entities_data;
     entities_data.reserve(local_size);
-    HDF5Interface::read_dataset(_hdf5_file_id, entities_name, range,
-                                entities_data);
+    read_data(entities_name, range, entities_data);
     std::vector<std::size_t> cells_data;
     cells_data.reserve(local_size);
-    HDF5Interface::read_dataset(_hdf5_file_id, cells_name, range, cells_data);
+    read_data(cells_name, range, cells_data);
 
     // Get global mapping to restore values
     const Mesh& mesh = *mesh_vc.mesh();
     const auto& global_cell_index =
       mesh.topology().global_indices(mesh.topology().dim());
 
-    // Reference to actual map of MeshValueCollection
-    std::map<std::pair<std::size_t, std::size_t>, T>& mvc_map
-      = mesh_vc.values();
+    // Values to set in MeshValueCollection
+    std::vector<std::size_t> cells, local_entities;
+    std::vector<T> values;
 
     // Find cells which are on this process,
     // under the assumption that global_cell_index is ordered.
@@ -1548,10 +1601,13 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
         // Here we do not increment j because cells_data_index is
         // ordered but not *strictly* ordered.
         std::size_t lidx = i - global_cell_index.begin();
-        mvc_map[std::make_pair(lidx, entities_data[*j])] = values_data[*j];
+        cells.push_back(lidx);
+        local_entities.push_back(entities_data[*j]);
+        values.push_back(values_data[*j]);
         ++j;
       }
     }
+    mesh_vc.set_values(cells, local_entities, values);
   }
   else
   {
@@ -1565,16 +1621,13 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
     // Read local range of values, entities and cells
     std::vector<T> values_data;
     values_data.reserve(local_size);
-    HDF5Interface::read_dataset(_hdf5_file_id, values_name, data_range,
-                                values_data);
+    read_data(values_name, data_range, values_data);
     std::vector<std::size_t> entities_data;
     entities_data.reserve(local_size);
-    HDF5Interface::read_dataset(_hdf5_file_id, entities_name, data_range,
-                                entities_data);
+    read_data(entities_name, data_range, entities_data);
     std::vector<std::size_t> cells_data;
     cells_data.reserve(local_size);
-    HDF5Interface::read_dataset(_hdf5_file_id, cells_name, data_range,
-                                cells_data);
+    read_data(cells_name, data_range, cells_data);
 
     std::vector<std::pair<std::size_t, std::size_t>> cell_ownership;
     cell_ownership = HDF5Utility::cell_owners(mesh, cells_data);
@@ -1598,24 +1651,20 @@ void HDF5File::read_mesh_value_collection_old(MeshValueCollection<T>& mesh_vc,
     MPI::all_to_all(_mpi_comm.comm(), send_local, recv_local);
     MPI::all_to_all(_mpi_comm.comm(), send_values, recv_values);
 
-    // Reference to actual map of MeshValueCollection
-    std::map<std::pair<std::size_t, std::size_t>, T>& mvc_map
-      = mesh_vc.values();
-
+    // Set values in MeshValueCollection
+    std::vector<std::size_t> cells, local_entities;
+    std::vector<T> values;
     for (std::size_t i = 0; i < num_processes; ++i)
     {
-      const std::vector<std::size_t>& local_index = recv_local[i];
-      const std::vector<std::size_t>& local_entities = recv_entities[i];
-      const std::vector<T>& local_values = recv_values[i];
-      dolfin_assert(local_index.size() == local_entities.size());
-      dolfin_assert(local_index.size() == local_values.size());
-
-      for (std::size_t j = 0; j < local_index.size(); ++j)
-      {
-        mvc_map[std::make_pair(local_index[j], local_entities[j])]
-          = local_values[j];
-      }
+      dolfin_assert(recv_local[i].size() == recv_entities[i].size());
+      dolfin_assert(recv_local[i].size() == recv_values[i].size());
+      cells.insert(cells.end(), recv_local[i].begin(), recv_local[i].end());
+      local_entities.insert(local_entities.end(), recv_entities[i].begin(),
+                            recv_entities[i].end());
+      values.insert(values.end(), recv_values[i].begin(),
+                    recv_values[i].end());
     }
+    mesh_vc.set_values(cells, local_entities, values);
   }
 }
 //-----------------------------------------------------------------------------
@@ -1817,8 +1866,7 @@ void HDF5File::read(Mesh& input_mesh,
   // Read a block of cells
   std::vector<std::int64_t> topology_data;
   topology_data.reserve(num_local_cells*num_vertices_per_cell);
-  HDF5Interface::read_dataset(_hdf5_file_id, topology_path, cell_data_range,
-                              topology_data);
+  read_data(topology_path, cell_data_range, topology_data);
 
   // FIXME: explain this more clearly.
   // Reconstruct mesh_name from topology_name - needed for
@@ -1833,8 +1881,7 @@ void HDF5File::read(Mesh& input_mesh,
   if (HDF5Interface::has_dataset(_hdf5_file_id, cell_indices_name))
   {
     global_cell_indices.reserve(num_local_cells);
-    HDF5Interface::read_dataset(_hdf5_file_id, cell_indices_name,
-                                cell_range, global_cell_indices);
+    read_data(cell_indices_name, cell_range, global_cell_indices);
   }
   else
   {
@@ -1913,8 +1960,7 @@ void HDF5File::read(Mesh& input_mesh,
   {
     std::vector<double> coordinates_data;
     coordinates_data.reserve(num_local_vertices*gdim);
-    HDF5Interface::read_dataset(_hdf5_file_id, geometry_path, vertex_data_range,
-                                coordinates_data);
+    read_data(geometry_path, vertex_data_range, coordinates_data);
 
     // Copy to boost::multi_array
     local_mesh_data.geometry.vertex_coordinates.resize(boost::extents[num_local_vertices][gdim]);
@@ -1976,5 +2022,48 @@ bool HDF5File::get_mpi_atomicity() const
   return HDF5Interface::get_mpi_atomicity(_hdf5_file_id);
 }
 //-----------------------------------------------------------------------------
+std::pair<std::string, int>
+HDF5File::get_compression(const std::string dataset_name) const
+{
+  // Look for dataset, then for enclosing groups
+  if (!_compression.empty())
+  {
+    std::string path = (dataset_name.size() > 0 and dataset_name[0] == '/')
+      ? dataset_name : "/" + dataset_name;
+    while (!path.empty())
+    {
+      auto it = _compression.find(path);
+      if (it != _compression.end())
+        return it->second;
+
+      if (path == "/")
+        break;
+      const std::size_t pos = path.rfind('/');
+      path = (pos == 0) ? "/" : path.substr(0, pos);
+    }
+  }
+
+  return std::make_pair(std::string(parameters["compression"]),
+                        (int) parameters["compression_level"]);
+}
+//-----------------------------------------------------------------------------
+std::int64_t HDF5File::compute_chunk_rows(std::int64_t num_local_rows,
+                                          std::size_t row_bytes) const
+{
+  dolfin_assert(row_bytes > 0);
+
+  // Chunk size limit (bytes)
+  const std::int64_t max_chunk_bytes = 4194304;
+
+  // Use the largest local range, so that each process writes one
+  // chunk (or a few) when rows are evenly distributed
+  std::int64_t chunk_rows = MPI::max(_mpi_comm.comm(), num_local_rows);
+  chunk_rows = std::min(chunk_rows,
+                        std::max((std::int64_t) 1,
+                                 max_chunk_bytes/(std::int64_t) row_bytes));
+
+  return std::max((std::int64_t) 1, chunk_rows);
+}
+//-----------------------------------------------------------------------------
 
 #endif
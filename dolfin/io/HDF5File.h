@@ -22,6 +22,7 @@
 
 #ifdef HAS_HDF5
 
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -63,6 +64,15 @@ namespace dolfin
     /// Flush buffered I/O to disk
     void flush();
 
+    /// Set the compression of datasets subsequently written to the
+    /// dataset or group 'name' (including datasets in subgroups),
+    /// overriding the parameters "compression" and
+    /// "compression_level". compression is "none", "deflate" or
+    /// "shuffle_deflate", and compression_level is between 0 and 9.
+    void set_compression(const std::string name,
+                         const std::string compression,
+                         int compression_level=4);
+
     /// Write points to file
     void write(const std::vector<Point>& points, const std::string name);
 
@@ -229,6 +239,28 @@ namespace dolfin
       void read_mesh_value_collection_old(MeshValueCollection<T>& mesh_values,
                                           const std::string name) const;
 
+    // Get compression filter and level for a dataset
+    std::pair<std::string, int>
+      get_compression(const std::string dataset_name) const;
+
+    // Compute the number of rows in each chunk of a dataset with
+    // num_local_rows rows of row_bytes bytes on this process. Chunks
+    // follow the largest local row range, limited to 4 MB
+    // (collective)
+    std::int64_t compute_chunk_rows(std::int64_t num_local_rows,
+                                    std::size_t row_bytes) const;
+
+    // Read range of rows of a dataset. The read is collective when
+    // running in parallel.
+    template <typename T>
+      void read_data(const std::string dataset_name,
+                     const std::pair<std::int64_t, std::int64_t> range,
+                     std::vector<T>& data) const
+    {
+      HDF5Interface::read_dataset(_hdf5_file_id, dataset_name, range, data,
+                                  _mpi_comm.size() > 1);
+    }
+
     // Write contiguous data to HDF5 data set. Data is flattened into
     // a 1D array, e.g. [x0, y0, z0, x1, y1, z1] for a vector in 3D
     template <typename T>
@@ -242,6 +274,10 @@ namespace dolfin
 
     // MPI communicator
     dolfin::MPI::Comm _mpi_comm;
+
+    // Compression (filter and level) of datasets and groups set by
+    // set_compression
+    std::map<std::string, std::pair<std::string, int>> _compression;
   };
 
   //---------------------------------------------------------------------------
@@ -256,10 +292,10 @@ namespace dolfin
     dolfin_assert(global_size.size() > 0);
 
     // Get number of 'items'
-    std::size_t num_local_items = 1;
+    std::size_t item_size = 1;
     for (std::size_t i = 1; i < global_size.size(); ++i)
-      num_local_items *= global_size[i];
-    num_local_items = data.size()/num_local_items;
+      item_size *= global_size[i];
+    const std::size_t num_local_items = data.size()/item_size;
 
     // Compute offset
     const std::size_t offset = MPI::global_offset(_mpi_comm.comm(), num_local_items,
@@ -267,15 +303,24 @@ namespace dolfin
     std::pair<std::size_t, std::size_t> range(offset,
                                               offset + num_local_items);
 
-    // Write data to HDF5 file
-    const bool chunking = parameters["chunking"];
     // Ensure dataset starts with '/'
     std::string dset_name(dataset_name);
     if (dset_name[0] != '/')
       dset_name = "/" + dataset_name;
 
+    // Get chunking and compression
+    const std::pair<std::string, int> compression
+      = get_compression(dset_name);
+    const bool chunking = parameters["chunking"]
+      or compression.first != "none";
+    const std::int64_t chunk_rows = chunking
+      ? compute_chunk_rows(num_local_items, item_size*sizeof(T)) : 0;
+
+    // Write data to HDF5 file
     HDF5Interface::write_dataset(_hdf5_file_id, dset_name, data,
-                                 range, global_size, use_mpi_io, chunking);
+                                 range, global_size, use_mpi_io, chunking,
+                                 chunk_rows, compression.first,
+                                 compression.second);
   }
   //---------------------------------------------------------------------------
 
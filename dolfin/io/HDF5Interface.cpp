@@ -20,6 +20,7 @@
 // First Added: 2012-09-21
 // Last Changed: 2013-10-24
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
@@ -396,6 +397,105 @@ HDF5Interface::get_dataset_shape(const hid_t hdf5_file_handle,
   return std::vector<std::int64_t>(size.begin(), size.end());
 }
 //-----------------------------------------------------------------------------
+bool HDF5Interface::has_compression(const std::string compression,
+                                    bool use_mpi_io)
+{
+  if (compression == "none")
+    return true;
+  else if (compression != "deflate" and compression != "shuffle_deflate")
+    return false;
+
+  // Writing filtered datasets with MPI-IO requires HDF5 1.10.2
+  if (use_mpi_io)
+  {
+#if !defined(H5_HAVE_PARALLEL) || !H5_VERSION_GE(1, 10, 2)
+    return false;
+#endif
+  }
+
+  if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0)
+    return false;
+  if (compression == "shuffle_deflate"
+      and H5Zfilter_avail(H5Z_FILTER_SHUFFLE) <= 0)
+  {
+    return false;
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------------------
+hid_t HDF5Interface::create_dataset_properties(const std::vector<hsize_t>& dims,
+                                               bool use_chunking,
+                                               std::int64_t chunk_rows,
+                                               const std::string compression,
+                                               int compression_level,
+                                               bool use_mpi_io)
+{
+  const bool use_compression = (compression != "none");
+  if (use_compression and !has_compression(compression, use_mpi_io))
+  {
+    dolfin_error("HDF5Interface.cpp",
+                 "create HDF5 dataset",
+                 "Compression \"%s\" is not supported by the HDF5 library%s",
+                 compression.c_str(),
+                 use_mpi_io ? " in parallel (requires HDF5 1.10.2)" : "");
+  }
+
+  if (compression_level < 0 or compression_level > 9)
+  {
+    dolfin_error("HDF5Interface.cpp",
+                 "create HDF5 dataset",
+                 "Compression level must be between 0 and 9 (got %d)",
+                 compression_level);
+  }
+
+  // Chunks cannot be larger than a (fixed size) dataset, and empty
+  // datasets are not chunked
+  dolfin_assert(!dims.empty());
+  if (!(use_chunking or use_compression) or dims[0] == 0)
+    return H5P_DEFAULT;
+
+  // Number of rows in each chunk. Default is half the dataset,
+  // limited to 1k-1M rows.
+  hsize_t num_rows = chunk_rows;
+  if (chunk_rows <= 0)
+  {
+    num_rows = dims[0]/2;
+    if (num_rows > 1048576)
+      num_rows = 1048576;
+    if (num_rows < 1024)
+      num_rows = 1024;
+  }
+  num_rows = std::min(num_rows, dims[0]);
+
+  std::vector<hsize_t> chunk_dims(dims);
+  chunk_dims[0] = num_rows;
+
+  const hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+  dolfin_assert(plist_id != HDF5_FAIL);
+  herr_t status = H5Pset_chunk(plist_id, chunk_dims.size(),
+                               chunk_dims.data());
+  dolfin_assert(status != HDF5_FAIL);
+
+  if (use_compression)
+  {
+    // Filters are applied in the order they are added
+    if (compression == "shuffle_deflate")
+    {
+      status = H5Pset_shuffle(plist_id);
+      dolfin_assert(status != HDF5_FAIL);
+    }
+    status = H5Pset_deflate(plist_id, compression_level);
+    dolfin_assert(status != HDF5_FAIL);
+
+    // All data is written, so avoid compressing fill values first
+    status = H5Pset_fill_time(plist_id, H5D_FILL_TIME_NEVER);
+    dolfin_assert(status != HDF5_FAIL);
+  }
+
+  return plist_id;
+}
+//-----------------------------------------------------------------------------
 int HDF5Interface::num_datasets_in_group(const hid_t hdf5_file_handle,
                                          const std::string group_name)
 {
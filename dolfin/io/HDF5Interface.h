@@ -66,23 +66,42 @@ namespace dolfin
     /// global_size: the global multidimensional shape of the array
     /// use_mpio: whether using MPI or not
     /// use_chunking: whether using chunking or not
+    /// chunk_rows: number of rows (first dimension) in each chunk,
+    /// or 0 for a default based on the dataset size. Must be the
+    /// same on all processes
+    /// compression: "none", "deflate" or "shuffle_deflate" (byte
+    /// shuffle followed by deflate). Compression implies chunking
+    /// compression_level: deflate level, from 0 (fastest) to 9
+    /// (smallest)
     template <typename T>
     static void write_dataset(const hid_t file_handle,
                               const std::string dataset_path,
                               const std::vector<T>& data,
                               const std::pair<std::int64_t, std::int64_t> range,
                               const std::vector<std::int64_t> global_size,
-                              bool use_mpio, bool use_chunking);
+                              bool use_mpio, bool use_chunking,
+                              std::int64_t chunk_rows=0,
+                              const std::string compression="none",
+                              int compression_level=0);
 
     /// Read data from a HDF5 dataset "dataset_path" as defined by
     /// range blocks on each process range: the local range on this
     /// processor data: a flattened 1D array of values. If range = {-1, -1},
-    /// then all data is read on this process.
+    /// then all data is read on this process. If use_mpio is true,
+    /// the read is collective and must be called on all processes.
+    /// Compressed datasets are decompressed transparently.
     template <typename T>
     static void read_dataset(const hid_t file_handle,
                              const std::string dataset_path,
                              const std::pair<std::int64_t, std::int64_t> range,
-                             std::vector<T>& data);
+                             std::vector<T>& data, bool use_mpio=false);
+
+    /// Return true if the compression filter ("none", "deflate" or
+    /// "shuffle_deflate") is available in the HDF5 library. When
+    /// use_mpio is true, also check that the library can write
+    /// compressed datasets in parallel (requires HDF5 1.10.2)
+    static bool has_compression(const std::string compression,
+                                bool use_mpio);
 
     /// Check for existence of group in HDF5 file
     static bool has_group(const hid_t hdf5_file_handle,
@@ -165,6 +184,16 @@ namespace dolfin
 
   private:
 
+    // Create dataset creation property list for chunking and
+    // compression of a dataset with dimensions dims. Returns
+    // H5P_DEFAULT if neither is used.
+    static hid_t create_dataset_properties(const std::vector<hsize_t>& dims,
+                                           bool use_chunking,
+                                           std::int64_t chunk_rows,
+                                           const std::string compression,
+                                           int compression_level,
+                                           bool use_mpi_io);
+
     static herr_t attribute_iteration_function(hid_t loc_id,
                                                const char* name,
                                                const H5A_info_t* info,
@@ -235,7 +264,10 @@ namespace dolfin
                                const std::vector<T>& data,
                                const std::pair<std::int64_t, std::int64_t> range,
                                const std::vector<int64_t> global_size,
-                               bool use_mpi_io, bool use_chunking)
+                               bool use_mpi_io, bool use_chunking,
+                               std::int64_t chunk_rows,
+                               const std::string compression,
+                               int compression_level)
   {
     // Data rank
     const std::size_t rank = global_size.size();
@@ -269,23 +301,11 @@ namespace dolfin
     const hid_t filespace0 = H5Screate_simple(rank, dimsf.data(), NULL);
     dolfin_assert(filespace0 != HDF5_FAIL);
 
-    // Set chunking parameters
-    hid_t chunking_properties;
-    if (use_chunking)
-    {
-      // Set chunk size and limit to 1kB min/1MB max
-      hsize_t chunk_size = dimsf[0]/2;
-      if (chunk_size > 1048576)
-        chunk_size = 1048576;
-      if (chunk_size < 1024)
-        chunk_size = 1024;
-
-      hsize_t chunk_dims[2] = {chunk_size, dimsf[1]};
-      chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
-      H5Pset_chunk(chunking_properties, rank, chunk_dims);
-    }
-    else
-      chunking_properties = H5P_DEFAULT;
+    // Set chunking and compression parameters
+    const hid_t chunking_properties
+      = create_dataset_properties(dimsf, use_chunking, chunk_rows,
+                                  compression, compression_level,
+                                  use_mpi_io);
 
     // Check that group exists and recursively create if required
     const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
@@ -330,7 +350,7 @@ namespace dolfin
                       data.data());
     dolfin_assert(status != HDF5_FAIL);
 
-    if (use_chunking)
+    if (chunking_properties != H5P_DEFAULT)
     {
       // Close chunking properties
       status = H5Pclose(chunking_properties);
@@ -359,7 +379,7 @@ namespace dolfin
   HDF5Interface::read_dataset(const hid_t file_handle,
                               const std::string dataset_path,
                               const std::pair<std::int64_t, std::int64_t> range,
-                              std::vector<T>& data)
+                              std::vector<T>& data, bool use_mpi_io)
   {
     // Open the dataset
     const hid_t dset_id = H5Dopen2(file_handle, dataset_path.c_str(),
@@ -412,12 +432,30 @@ namespace dolfin
       data_size *= count[i];
     data.resize(data_size);
 
+    // Set parallel access
+    const hid_t plist_id = H5Pcreate(H5P_DATASET_XFER);
+    if (use_mpi_io)
+    {
+     #ifdef H5_HAVE_PARALLEL
+      status = H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_COLLECTIVE);
+      dolfin_assert(status != HDF5_FAIL);
+     #else
+      dolfin_error("HDF5Interface.h",
+                   "use MPI",
+                   "HDF5 library has not been configured with MPI");
+     #endif
+    }
+
     // Read data on each process
     const hid_t h5type = hdf5_type<T>();
-    status = H5Dread(dset_id, h5type, memspace, dataspace, H5P_DEFAULT,
+    status = H5Dread(dset_id, h5type, memspace, dataspace, plist_id,
                      data.data());
     dolfin_assert(status != HDF5_FAIL);
 
+    // Release transfer properties
+    status = H5Pclose(plist_id);
+    dolfin_assert(status != HDF5_FAIL);
+
     // Close dataspace
     status = H5Sclose(dataspace);
     dolfin_assert(status != HDF5_FAIL);
@@ -55,6 +55,25 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Return true if HDF5 writes may be issued from a thread other
+  // than the one that called MPI_Init
+  bool supports_asynchronous_output(MPI_Comm comm)
+  {
+    if (dolfin::MPI::size(comm) == 1)
+      return true;
+
+#ifdef HAS_MPI
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    return provided == MPI_THREAD_MULTIPLE;
+#else
+    return true;
+#endif
+  }
+}
+
 //-----------------------------------------------------------------------------
 XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename)
   : _mpi_comm(comm), _filename(filename),
@@ -73,23 +92,44 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename)
   // HDF5 file whilst running, at some performance cost.
   parameters.add("flush_output", false);
 
+  // Write time series of functions asynchronously (HDF5 only). See
+  // XDMFFile::wait.
+  parameters.add("asynchronous_output", false);
 }
 //-----------------------------------------------------------------------------
 XDMFFile::~XDMFFile()
 {
+  // Wait for a pending write, but do not rethrow errors from the
+  // destructor
+  if (_pending_write.valid())
+  {
+    _pending_write.wait();
+    _pending_write = std::future<void>();
+  }
+
   close();
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::close()
 {
+  wait();
+
 #ifdef HAS_HDF5
   // Close the HDF5 file
   _hdf5_file.reset();
 #endif
 }
 //-----------------------------------------------------------------------------
+void XDMFFile::wait() const
+{
+  if (_pending_write.valid())
+    _pending_write.get();
+}
+//-----------------------------------------------------------------------------
 void XDMFFile::write(const Mesh& mesh, const Encoding encoding)
 {
+  wait();
+
   // Check that encoding is supported
   check_encoding(encoding);
 
@@ -136,6 +176,8 @@ void XDMFFile::write_checkpoint(const Function& u,
                                 const Encoding encoding,
                                 bool append)
 {
+  wait();
+
   check_encoding(encoding);
   check_function_name(function_name);
 
@@ -306,6 +348,8 @@ void XDMFFile::write_checkpoint(const Function& u,
 //-----------------------------------------------------------------------------
 void XDMFFile::write(const Function& u, const Encoding encoding)
 {
+  wait();
+
   check_encoding(encoding);
 
   // If counter is non-zero, a time series has been saved before
@@ -395,10 +439,27 @@ void XDMFFile::write(const Function& u, const Encoding encoding)
 void XDMFFile::write(const Function& u, double time_step,
                      const Encoding encoding)
 {
+  wait();
+
   check_encoding(encoding);
 
   const Mesh& mesh = *u.function_space()->mesh();
 
+  // Check whether HDF5 datasets and the XML file should be written by
+  // a background thread. Data is always collected (collectively) on
+  // the calling thread.
+  bool async = false;
+  if (parameters["asynchronous_output"] and encoding == Encoding::HDF5)
+  {
+    async = supports_asynchronous_output(_mpi_comm.comm());
+    if (!async)
+    {
+      warning("MPI is not initialized with MPI_THREAD_MULTIPLE. "
+              "XDMFFile will write synchronously.");
+    }
+  }
+  std::shared_ptr<DeferredWrites> deferred(new DeferredWrites);
+
   // Clear the pugi doc the first time
   if (_counter == 0)
   {
@@ -478,7 +539,8 @@ void XDMFFile::write(const Function& u, double time_step,
     if (new_timegrid or parameters["rewrite_function_mesh"])
     {
       add_mesh(_mpi_comm.comm(), timegrid_node, h5_id, mesh,
-        "/Mesh/" + std::to_string(_counter));
+        "/Mesh/" + std::to_string(_counter),
+        async ? deferred.get() : nullptr);
     }
     else
     {
@@ -530,21 +592,44 @@ void XDMFFile::write(const Function& u, double time_step,
                                    + std::to_string(_counter);
 
   add_data_item(_mpi_comm.comm(), attribute_node, h5_id,
-                dataset_name, data_values, {num_values, width});
+                dataset_name, data_values, {num_values, width}, "",
+                async ? deferred.get() : nullptr);
 
   // Save XML file (on process 0 only)
   if (_mpi_comm.rank() == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  {
+    if (async)
+    {
+      deferred->push_back([this]()
+        { _xml_doc->save_file(_filename.c_str(), "  "); });
+    }
+    else
+      _xml_doc->save_file(_filename.c_str(), "  ");
+  }
 
 #ifdef HAS_HDF5
   // Close the HDF5 file if in "flush" mode
   if (encoding == Encoding::HDF5 and parameters["flush_output"])
   {
     dolfin_assert(_hdf5_file);
-    _hdf5_file.reset();
+    if (async)
+      deferred->push_back([this]() { _hdf5_file.reset(); });
+    else
+      _hdf5_file.reset();
   }
 #endif
 
+  // Launch background write. The XML document and HDF5 file are not
+  // touched again before the write has completed (see XDMFFile::wait).
+  if (async)
+  {
+    _pending_write = std::async(std::launch::async, [deferred]()
+      {
+        for (auto& write : *deferred)
+          write();
+      });
+  }
+
   ++_counter;
 }
 //-----------------------------------------------------------------------------
@@ -600,6 +685,8 @@ template <typename T>
 void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
                                            const Encoding encoding)
 {
+  wait();
+
   check_encoding(encoding);
 
   // Provide some very basic functionality for saving
@@ -706,8 +793,8 @@ void XDMFFile::write_mesh_value_collection(const MeshValueCollection<T>& mvc,
     = vtk_cell_type_str(mesh->type().entity_type(cell_dim), mesh->geometry().degree());
   const std::int64_t num_vertices_per_cell = mesh->type().num_vertices(cell_dim);
 
-  const std::map<std::pair<std::size_t, std::size_t>, T>& values
-    = mvc.values();
+  const std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>&
+    values = mvc.values();
   const std::int64_t num_cells = values.size();
   const std::int64_t num_cells_global = MPI::sum(mesh->mpi_comm(), num_cells);
 
@@ -774,8 +861,15 @@ void XDMFFile::read(MeshValueCollection<bool>& mvc, std::string name)
   read_mesh_value_collection(mvc_int, name);
 
   mvc.init(mvc.mesh(), mvc_int.dim());
+  std::vector<std::size_t> cells, local_entities;
+  std::vector<bool> values;
   for (const auto &p : mvc_int.values())
-    mvc.set_value(p.first.first, p.first.second, (bool)p.second);
+  {
+    cells.push_back(p.first.first);
+    local_entities.push_back(p.first.second);
+    values.push_back((bool)p.second);
+  }
+  mvc.set_values(cells, local_entities, values);
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::read(MeshValueCollection<int>& mvc, std::string name)
@@ -797,6 +891,8 @@ template <typename T>
 void XDMFFile::read_mesh_value_collection
 (MeshValueCollection<T>& mvc, std::string name)
 {
+  wait();
+
   // Load XML doc from file
   pugi::xml_document xml_doc;
   pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
@@ -964,20 +1060,24 @@ void XDMFFile::read_mesh_value_collection
   MPI::all_to_all(_mpi_comm.comm(), send_entities, recv_entities);
   MPI::all_to_all(_mpi_comm.comm(), send_data, recv_data);
 
+  std::vector<std::size_t> entities;
+  std::vector<T> values;
   for (std::int32_t i = 0; i != num_processes; ++i)
   {
     dolfin_assert(recv_entities[i].size() == recv_data[i].size());
-    for (std::size_t j = 0; j != recv_data[i].size(); ++j)
-    {
-      mvc.set_value(recv_entities[i][j], recv_data[i][j]);
-    }
+    entities.insert(entities.end(), recv_entities[i].begin(),
+                    recv_entities[i].end());
+    values.insert(values.end(), recv_data[i].begin(), recv_data[i].end());
   }
+  mvc.set_values(entities, values);
 
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write(const std::vector<Point>& points,
                      const Encoding encoding)
 {
+  wait();
+
   // Check that encoding is supported
   check_encoding(encoding);
 
@@ -1052,6 +1152,8 @@ void XDMFFile::write(const std::vector<Point>& points,
                      const std::vector<double>& values,
                      const Encoding encoding)
 {
+  wait();
+
   // Write clouds of points to XDMF/HDF5 with values
   dolfin_assert(points.size() == values.size());
 
@@ -1135,7 +1237,8 @@ void XDMFFile::read(MeshFunction<double>& meshfunction, std::string name)
 //----------------------------------------------------------------------------
 void XDMFFile::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
                         hid_t h5_id, const Mesh& mesh,
-                        const std::string path_prefix)
+                        const std::string path_prefix,
+                        DeferredWrites* deferred)
 {
   log(PROGRESS, "Adding mesh to node \"%s\"", xml_node.path('/').c_str());
 
@@ -1150,13 +1253,13 @@ void XDMFFile::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
   const std::int64_t num_global_cells = mesh.num_entities_global(tdim);
   if (num_global_cells < 1e9)
     add_topology_data<std::int32_t>(comm, grid_node, h5_id, path_prefix,
-                                    mesh, tdim);
+                                    mesh, tdim, deferred);
   else
     add_topology_data<std::int64_t>(comm, grid_node, h5_id, path_prefix,
-                                    mesh, tdim);
+                                    mesh, tdim, deferred);
 
   // Add geometry node and attributes (including writing data)
-  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh);
+  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh, deferred);
 }
 //----------------------------------------------------------------------------
 void XDMFFile::add_function(MPI_Comm mpi_comm, pugi::xml_node& xml_node,
@@ -1305,6 +1408,8 @@ void XDMFFile::add_function(MPI_Comm mpi_comm, pugi::xml_node& xml_node,
 //-----------------------------------------------------------------------------
 void XDMFFile::read(Mesh& mesh) const
 {
+  wait();
+
   // Extract parent filepath (required by HDF5 when XDMF stores relative path
   // of the HDF5 files(s) and the XDMF is not opened from its own directory)
   boost::filesystem::path xdmf_filename(_filename);
@@ -1417,6 +1522,8 @@ void XDMFFile::read(Mesh& mesh) const
 void XDMFFile::read_checkpoint(Function& u, std::string func_name,
                                std::int64_t counter)
 {
+  wait();
+
   check_function_name(func_name);
 
   log(PROGRESS, "Reading function \"%s\" from XDMF file \"%s\" with "
@@ -1783,7 +1890,8 @@ XDMFFile::build_local_mesh_data(LocalMeshData& local_mesh_data,
 template<typename T>
 void XDMFFile::add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                  hid_t h5_id, const std::string path_prefix,
-                                 const Mesh& mesh, int cell_dim)
+                                 const Mesh& mesh, int cell_dim,
+                                 DeferredWrites* deferred)
 {
   // Get number of cells (global) and vertices per cell from mesh
   const std::int64_t num_cells = mesh.topology().size_global(cell_dim);
@@ -1821,12 +1929,12 @@ void XDMFFile::add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
   const std::string number_type = "UInt";
 
   add_data_item(comm, topology_node, h5_id, h5_path,
-                topology_data, shape, number_type);
+                topology_data, shape, number_type, deferred);
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                  hid_t h5_id, const std::string path_prefix,
-                                 const Mesh& mesh)
+                                 const Mesh& mesh, DeferredWrites* deferred)
 {
   const MeshGeometry& mesh_geometry = mesh.geometry();
   int gdim = mesh_geometry.dim();
@@ -1868,14 +1976,15 @@ void XDMFFile::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
   const std::string h5_path = group_name + "/geometry";
   const std::vector<std::int64_t> shape = {num_points, gdim};
 
-  add_data_item(comm, geometry_node, h5_id, h5_path, x, shape);
+  add_data_item(comm, geometry_node, h5_id, h5_path, x, shape, "", deferred);
 }
 //-----------------------------------------------------------------------------
 template<typename T>
 void XDMFFile::add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
                              hid_t h5_id, const std::string h5_path, const T& x,
                              const std::vector<std::int64_t> shape,
-                             const std::string number_type)
+                             const std::string number_type,
+                             DeferredWrites* deferred)
 {
 
   log(DBG, "Adding data item to node %s", xml_node.path().c_str());
@@ -1933,16 +2042,31 @@ void XDMFFile::add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
     const std::pair<std::int64_t, std::int64_t> local_range
       = {offset, offset + local_shape0};
 
-    const bool use_mpi_io = (MPI::size(comm) > 1);
-    HDF5Interface::write_dataset(h5_id, h5_path, x, local_range, shape, use_mpi_io,
-                                 false);
-
-    // Add partitioning attribute to dataset
+    // Compute partitioning attribute of dataset
     std::vector<std::size_t> partitions;
     std::vector<std::size_t> offset_tmp(1, offset);
     MPI::gather(comm, offset_tmp, partitions);
     MPI::broadcast(comm, partitions);
-    HDF5Interface::add_attribute(h5_id, h5_path, "partition", partitions);
+
+    // Write data and add partitioning attribute, now or later
+    const bool use_mpi_io = (MPI::size(comm) > 1);
+    if (deferred)
+    {
+      std::shared_ptr<const T> data(new T(x));
+      deferred->push_back([=]()
+        {
+          HDF5Interface::write_dataset(h5_id, h5_path, *data, local_range,
+                                       shape, use_mpi_io, false);
+          HDF5Interface::add_attribute(h5_id, h5_path, "partition",
+                                       partitions);
+        });
+    }
+    else
+    {
+      HDF5Interface::write_dataset(h5_id, h5_path, x, local_range, shape,
+                                   use_mpi_io, false);
+      HDF5Interface::add_attribute(h5_id, h5_path, "partition", partitions);
+    }
 
 #else
     // Should never reach this point
@@ -2426,6 +2550,8 @@ template<typename T>
 void XDMFFile::read_mesh_function(MeshFunction<T>& meshfunction,
                                   std::string name)
 {
+  wait();
+
   // Load XML doc from file
   pugi::xml_document xml_doc;
   pugi::xml_parse_result result = xml_doc.load_file(_filename.c_str());
@@ -2687,6 +2813,8 @@ template<typename T>
 void XDMFFile::write_mesh_function(const MeshFunction<T>& meshfunction,
                                    Encoding encoding)
 {
+  wait();
+
   check_encoding(encoding);
 
   if (meshfunction.size() == 0)
@@ -21,6 +21,8 @@
 #define __DOLFIN_XDMFFILE_H
 
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <utility>
@@ -112,6 +114,21 @@ namespace dolfin
     /// The file is automatically closed at the end of the with block
     void close();
 
+    /// Wait for a pending asynchronous write to complete, and
+    /// rethrow any error raised while writing. This is called
+    /// automatically before any other operation on the file.
+    ///
+    /// Time series of functions are written asynchronously if the
+    /// parameter "asynchronous_output" is set. Function and mesh
+    /// data are computed when write() is called, and the HDF5
+    /// datasets and XML file are written by a background thread
+    /// while the caller continues. At most one write is pending at a
+    /// time. The file is written synchronously if MPI does not
+    /// provide MPI_THREAD_MULTIPLE when running in parallel. No
+    /// other HDF5 files should be accessed while a write is pending,
+    /// unless HDF5 is built thread-safe.
+    void wait() const;
+
     /// Save a mesh to XDMF format, either using an associated HDF5
     /// file, or storing the data inline as XML Create function on
     /// given function space
@@ -393,6 +410,9 @@ namespace dolfin
 
   private:
 
+    // HDF5 writes (and other file operations) to be performed later
+    typedef std::vector<std::function<void()>> DeferredWrites;
+
     // Generic MVC writer
     template <typename T>
     void write_mesh_value_collection(const MeshValueCollection<T>& mvc,
@@ -440,7 +460,8 @@ namespace dolfin
     // write data
     static void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
                          hid_t h5_id, const Mesh& mesh,
-                         const std::string path_prefix);
+                         const std::string path_prefix,
+                         DeferredWrites* deferred=nullptr);
 
     // Add function to a XML node
     static void add_function(MPI_Comm comm, pugi::xml_node& xml_node,
@@ -457,22 +478,27 @@ namespace dolfin
     template<typename T>
     static void add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   hid_t h5_id, const std::string path_prefix,
-                                  const Mesh& mesh, int tdim);
+                                  const Mesh& mesh, int tdim,
+                                  DeferredWrites* deferred=nullptr);
 
     // Add geometry node and data to xml_node
     static void add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   hid_t h5_id, const std::string path_prefix,
-                                  const Mesh& mesh);
+                                  const Mesh& mesh,
+                                  DeferredWrites* deferred=nullptr);
 
     // Add DataItem node to an XML node. If HDF5 is open (h5_id > 0)
     // the data is written to the HDFF5 file with the path
     // 'h5_path'. Otherwise, data is witten to the XML node and
-    // 'h5_path' is ignored
+    // 'h5_path' is ignored. If deferred is given, a copy of the data
+    // is made and the HDF5 write is appended to deferred instead of
+    // being performed.
     template<typename T>
     static void add_data_item(MPI_Comm comm, pugi::xml_node& xml_node,
                               hid_t h5_id, const std::string h5_path, const T& x,
                               const std::vector<std::int64_t> dimensions,
-                              const std::string number_type="");
+                              const std::string number_type="",
+                              DeferredWrites* deferred=nullptr);
 
     // Calculate set of entities of dimension cell_dim which are
     // duplicated on other processes and should not be output on this
@@ -588,6 +614,10 @@ namespace dolfin
     // which needs to be kept open for time series etc.
     std::unique_ptr<pugi::xml_document> _xml_doc;
 
+    // Pending asynchronous write, if any (mutable so that reading,
+    // which must wait for it, can be const)
+    mutable std::future<void> _pending_write;
+
   };
 
 #ifndef DOXYGEN_IGNORE
@@ -597,13 +627,15 @@ namespace dolfin
                                hid_t h5_id, const std::string h5_path,
                                const std::vector<bool>& x,
                                const std::vector<std::int64_t> shape,
-                               const std::string number_type)
+                               const std::string number_type,
+                               DeferredWrites* deferred)
   {
     // HDF5 cannot accept 'bool' so copy to 'int'
     std::vector<int> x_int(x.size());
     for (std::size_t i = 0; i < x.size(); ++i)
       x_int[i] = (int)x[i];
-    add_data_item(comm, xml_node, h5_id, h5_path, x_int, shape, number_type);
+    add_data_item(comm, xml_node, h5_id, h5_path, x_int, shape, number_type,
+                  deferred);
   }
 #endif
 
@@ -292,14 +292,14 @@ void XMLMesh::read_domains(MeshDomains& domains, const Mesh& mesh,
     XMLMeshValueCollection::read(mvc, type, *it);
 
     // Get mesh value collection data
-    const std::map<std::pair<std::size_t, std::size_t>, std::size_t>&
-      values = mvc.values();
+    const std::vector<std::pair<std::pair<std::size_t, std::size_t>,
+                                std::size_t>>& values = mvc.values();
 
     // Get mesh domain data and fill
     std::map<std::size_t, std::size_t>& markers
       = domains.markers(dim);
-    std::map<std::pair<std::size_t, std::size_t>,
-             std::size_t>::const_iterator entry;
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>,
+                          std::size_t>>::const_iterator entry;
     if (dim != mesh.topology().dim())
     {
       for (entry = values.begin(); entry != values.end(); ++entry)
@@ -237,6 +237,18 @@ std::size_t BelosKrylovSolver::_solve(TpetraVector& x, const TpetraVector& b)
                  _matA->size(0), b.size());
   }
 
+  // Mixed precision solves are not supported
+  if (parameters["precision"].is_set())
+  {
+    const std::string precision = parameters["precision"];
+    if (precision == "mixed")
+    {
+      dolfin_error("BelosKrylovSolver.cpp",
+                   "unable to solve linear system with Belos Krylov solver",
+                   "Mixed precision solves are only supported by the Eigen backend");
+    }
+  }
+
   // Get MPI rank
   const int mpi_rank = MPI::rank(_matA->mpi_comm());
 
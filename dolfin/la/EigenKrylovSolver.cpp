@@ -17,6 +17,7 @@
 //
 // First added:  2015-02-04
 
+#include <algorithm>
 #include <iostream> // Seem to be missing some Eigen headers
 #include <map>
 #include <string>
@@ -163,186 +164,262 @@ std::size_t EigenKrylovSolver::solve(EigenVector& x, const EigenVector& b)
   log(PROGRESS, "Eigen Krylov solver starting to solve %i x %i system.",
       _matA->size(0), _matA->size(1));
 
-  std::size_t num_iterations = 0;
+  // Solve by mixed precision iterative refinement if requested
+  if (parameters["precision"].is_set())
+  {
+    const std::string precision = parameters["precision"];
+    if (precision == "mixed")
+      return solve_mixed_precision(x, b);
+  }
+
+  const double rtol = parameters["relative_tolerance"].is_set()
+    ? (double) parameters["relative_tolerance"] : 0.0;
+  const bool nonzero_guess = parameters["nonzero_initial_guess"].is_set()
+    ? parameters["nonzero_initial_guess"] : false;
+  const bool error_on_nonconvergence
+    = parameters["error_on_nonconvergence"].is_set()
+    ? parameters["error_on_nonconvergence"] : true;
+
+  dolfin_assert(b.vec());
+  dolfin_assert(x.vec());
+  return solve_system(_matA->mat(), *x.vec(), *b.vec(), rtol, nonzero_guess,
+                      error_on_nonconvergence);
+}
+//-----------------------------------------------------------------------------
+std::size_t EigenKrylovSolver::solve(const EigenMatrix& A, EigenVector& x,
+                                     const EigenVector& b)
+{
+  // Set operator
+  std::shared_ptr<const EigenMatrix> Atmp(&A, NoDeleter());
+  set_operator(Atmp);
+
+  // Call solve
+  return solve(x, b);
+}
+//-----------------------------------------------------------------------------
+std::string EigenKrylovSolver::str(bool verbose) const
+{
+  std::stringstream s;
+  if (verbose)
+    s << "Eigen Krylov Solver (" << _method << ", "
+      << _pc << ")" << std::endl;
+  else
+    s << "<EigenKrylovSolver>";
+
+  return s.str();
+}
+//-----------------------------------------------------------------------------
+void EigenKrylovSolver::init(const std::string method,
+                             const std::string pc)
+{
+  // Check that the requested solver method is known
+  if (_methods_descr.find(method) == _methods_descr.end())
+  {
+    dolfin_error("EigenKrylovSolver.cpp",
+                 "create Eigen Krylov solver",
+                 "Unknown Krylov method \"%s\"", method.c_str());
+  }
+
+  // Check that the requested preconditioner is known
+  if (_pcs_descr.find(pc) == _pcs_descr.end())
+  {
+    dolfin_error("EigenKrylovSolver.cpp",
+                 "create Eigen Krylov solver",
+                 "Unknown preconditioner \"%s\"", pc.c_str());
+  }
 
+  // Set method and preconditioner
+  _method = (method == "default" ? "gmres" : method);
+  _pc = pc;
+}
+//-----------------------------------------------------------------------------
+std::size_t EigenKrylovSolver::solve_mixed_precision(EigenVector& x,
+                                                     const EigenVector& b)
+{
+  Timer timer("Eigen Krylov solver (mixed precision)");
+
+  // Relative tolerance for the single precision correction solves
+  // (should be well above the single precision machine epsilon)
+  const double inner_rtol = parameters["inner_relative_tolerance"].is_set()
+    ? (double) parameters["inner_relative_tolerance"] : 1.0e-4;
+
+  const bool nonzero_guess = parameters["nonzero_initial_guess"].is_set()
+    ? parameters["nonzero_initial_guess"] : false;
+  const bool error_on_nonconvergence
+    = parameters["error_on_nonconvergence"].is_set()
+    ? parameters["error_on_nonconvergence"] : true;
+
+  // Copy operator to single precision storage. The values are copied
+  // on each solve since the matrix may have been modified in-place
+  // since the last solve, but the storage is reused if the sparsity
+  // pattern is unchanged.
+  const EigenMatrix::eigen_matrix_type& A = _matA->mat();
+  if (A.isCompressed() && _matA_single.isCompressed()
+      && A.rows() == _matA_single.rows() && A.cols() == _matA_single.cols()
+      && A.nonZeros() == _matA_single.nonZeros()
+      && std::equal(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1,
+                    _matA_single.outerIndexPtr())
+      && std::equal(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros(),
+                    _matA_single.innerIndexPtr()))
+  {
+    std::copy(A.valuePtr(), A.valuePtr() + A.nonZeros(),
+              _matA_single.valuePtr());
+  }
+  else
+    _matA_single = A.cast<float>();
+
+  // Create the single precision solver and solve by iterative
+  // refinement (see call_solver for single precision operators)
+  dolfin_assert(b.vec());
+  dolfin_assert(x.vec());
+  return solve_system(_matA_single, *x.vec(), *b.vec(), inner_rtol,
+                      nonzero_guess, error_on_nonconvergence);
+}
+//-----------------------------------------------------------------------------
+template <typename Matrix, typename Vector>
+std::size_t EigenKrylovSolver::solve_system(const Matrix& A, Vector& x,
+                                            const Vector& b, double rtol,
+                                            bool nonzero_guess,
+                                            bool error_on_nonconvergence)
+{
+  typedef typename Matrix::Scalar Scalar;
+
+  std::size_t num_iterations = 0;
   if (_method == "cg")
   {
     if (_pc == "none")
     {
-      Eigen::ConjugateGradient<EigenMatrix::eigen_matrix_type,
-                               Eigen::Upper|Eigen::Lower,
+      Eigen::ConjugateGradient<Matrix, Eigen::Upper|Eigen::Lower,
                                Eigen::IdentityPreconditioner> solver;
-      num_iterations = call_solver(solver, x, b);
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "jacobi")
     {
-      Eigen::ConjugateGradient<EigenMatrix::eigen_matrix_type,
-                               Eigen::Upper|Eigen::Lower,
-                               Eigen::DiagonalPreconditioner<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::ConjugateGradient<Matrix, Eigen::Upper|Eigen::Lower,
+                               Eigen::DiagonalPreconditioner<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "ilu")
     {
-      Eigen::ConjugateGradient<EigenMatrix::eigen_matrix_type,
-                               Eigen::Upper|Eigen::Lower,
-                               Eigen::IncompleteLUT<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::ConjugateGradient<Matrix, Eigen::Upper|Eigen::Lower,
+                               Eigen::IncompleteLUT<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else
     {
-      Eigen::ConjugateGradient<EigenMatrix::eigen_matrix_type,
-                               Eigen::Upper|Eigen::Lower> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::ConjugateGradient<Matrix, Eigen::Upper|Eigen::Lower> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
   }
   else if (_method == "bicgstab")
   {
     if (_pc == "none")
     {
-      Eigen::BiCGSTAB<EigenMatrix::eigen_matrix_type,
-                      Eigen::IdentityPreconditioner> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::BiCGSTAB<Matrix, Eigen::IdentityPreconditioner> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "jacobi")
     {
-      Eigen::BiCGSTAB<EigenMatrix::eigen_matrix_type,
-                      Eigen::DiagonalPreconditioner<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::BiCGSTAB<Matrix, Eigen::DiagonalPreconditioner<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "ilu")
     {
-      Eigen::BiCGSTAB<EigenMatrix::eigen_matrix_type,
-                      Eigen::IncompleteLUT<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::BiCGSTAB<Matrix, Eigen::IncompleteLUT<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else
     {
-      Eigen::BiCGSTAB<EigenMatrix::eigen_matrix_type> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::BiCGSTAB<Matrix> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
   }
   else if (_method == "gmres")
   {
     if (_pc == "none")
     {
-      Eigen::GMRES<EigenMatrix::eigen_matrix_type,
-                   Eigen::IdentityPreconditioner> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::GMRES<Matrix, Eigen::IdentityPreconditioner> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "jacobi")
     {
-      Eigen::GMRES<EigenMatrix::eigen_matrix_type,
-                   Eigen::DiagonalPreconditioner<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::GMRES<Matrix, Eigen::DiagonalPreconditioner<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "ilu")
     {
-      Eigen::GMRES<EigenMatrix::eigen_matrix_type,
-                   Eigen::IncompleteLUT<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::GMRES<Matrix, Eigen::IncompleteLUT<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else
     {
-      Eigen::GMRES<EigenMatrix::eigen_matrix_type> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::GMRES<Matrix> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
   }
   else if (_method == "minres")
   {
     if (_pc == "none")
     {
-      Eigen::MINRES<EigenMatrix::eigen_matrix_type, Eigen::Upper|Eigen::Lower,
+      Eigen::MINRES<Matrix, Eigen::Upper|Eigen::Lower,
                     Eigen::IdentityPreconditioner> solver;
-      num_iterations = call_solver(solver, x, b);
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "jacobi")
     {
-      Eigen::MINRES<EigenMatrix::eigen_matrix_type, Eigen::Upper|Eigen::Lower,
-                    Eigen::DiagonalPreconditioner<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::MINRES<Matrix, Eigen::Upper|Eigen::Lower,
+                    Eigen::DiagonalPreconditioner<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else if (_pc == "ilu")
     {
-      Eigen::MINRES<EigenMatrix::eigen_matrix_type, Eigen::Upper|Eigen::Lower,
-                    Eigen::IncompleteLUT<double>> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::MINRES<Matrix, Eigen::Upper|Eigen::Lower,
+                    Eigen::IncompleteLUT<Scalar>> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
     else
     {
-      Eigen::MINRES<EigenMatrix::eigen_matrix_type> solver;
-      num_iterations = call_solver(solver, x, b);
+      Eigen::MINRES<Matrix> solver;
+      num_iterations = call_solver(solver, A, x, b, rtol, nonzero_guess,
+                                   error_on_nonconvergence);
     }
   }
 
   return num_iterations;
 }
 //-----------------------------------------------------------------------------
-std::size_t EigenKrylovSolver::solve(const EigenMatrix& A, EigenVector& x,
-                                     const EigenVector& b)
-{
-  // Set operator
-  std::shared_ptr<const EigenMatrix> Atmp(&A, NoDeleter());
-  set_operator(Atmp);
-
-  // Call solve
-  return solve(x, b);
-}
-//-----------------------------------------------------------------------------
-std::string EigenKrylovSolver::str(bool verbose) const
-{
-  std::stringstream s;
-  if (verbose)
-    s << "Eigen Krylov Solver (" << _method << ", "
-      << _pc << ")" << std::endl;
-  else
-    s << "<EigenKrylovSolver>";
-
-  return s.str();
-}
-//-----------------------------------------------------------------------------
-void EigenKrylovSolver::init(const std::string method,
-                             const std::string pc)
-{
-  // Check that the requested solver method is known
-  if (_methods_descr.find(method) == _methods_descr.end())
-  {
-    dolfin_error("EigenKrylovSolver.cpp",
-                 "create Eigen Krylov solver",
-                 "Unknown Krylov method \"%s\"", method.c_str());
-  }
-
-  // Check that the requested preconditioner is known
-  if (_pcs_descr.find(pc) == _pcs_descr.end())
-  {
-    dolfin_error("EigenKrylovSolver.cpp",
-                 "create Eigen Krylov solver",
-                 "Unknown preconditioner \"%s\"", pc.c_str());
-  }
-
-  // Set method and preconditioner
-  _method = (method == "default" ? "gmres" : method);
-  _pc = pc;
-}
-//-----------------------------------------------------------------------------
-template <typename Solver>
-std::size_t EigenKrylovSolver::call_solver(Solver& solver,
-                                           GenericVector& x,
-                                           const GenericVector& b)
+template <typename Solver, typename Matrix, typename Vector>
+std::size_t EigenKrylovSolver::call_solver(Solver& solver, const Matrix& A,
+                                           Vector& x, const Vector& b,
+                                           double rtol, bool nonzero_guess,
+                                           bool error_on_nonconvergence)
 {
   std::string timer_title = "Eigen Krylov solver (" + _method + ")";
   Timer timer(timer_title);
 
-  EigenVector& _x = as_type<EigenVector>(x);
-  const EigenVector& _b = as_type<const EigenVector>(b);
-
-  if (parameters["relative_tolerance"].is_set())
-    solver.setTolerance(parameters["relative_tolerance"]);
+  if (rtol > 0.0)
+    solver.setTolerance(rtol);
 
   if (parameters["maximum_iterations"].is_set())
     solver.setMaxIterations((int) parameters["maximum_iterations"]);
 
   // Prepare solver
-  solver.compute(_matA->mat());
+  solver.compute(A);
   if (solver.info() != Eigen::Success)
   {
     dolfin_error("EigenKrylovSolver.cpp",
@@ -351,24 +428,15 @@ std::size_t EigenKrylovSolver::call_solver(Solver& solver,
   }
 
   // Call approriate solve function
-  dolfin_assert(_b.vec());
-  dolfin_assert(_x.vec());
-  if (parameters["nonzero_initial_guess"].is_set())
-  {
-    const bool nonzero_guess = parameters["nonzero_initial_guess"];
-    if (nonzero_guess)
-      *_x.vec() = solver.solveWithGuess(*_b.vec(), *_x.vec());
-    else
-      *_x.vec() = solver.solve(*_b.vec());
-  }
+  if (nonzero_guess)
+    x = solver.solveWithGuess(b, x);
   else
-    *_x.vec() = solver.solve(*_b.vec());
+    x = solver.solve(b);
 
   // Get number of solver iterations
   const int num_iterations = solver.iterations();
 
   // Handle case that solver fails to converge
-  bool error_on_nonconvergence = parameters["error_on_nonconvergence"].is_set() ? parameters["error_on_nonconvergence"] : true;
   if (solver.info() != Eigen::Success)
   {
     if (num_iterations >= solver.maxIterations())
@@ -396,3 +464,105 @@ std::size_t EigenKrylovSolver::call_solver(Solver& solver,
   return num_iterations;
 }
 //-----------------------------------------------------------------------------
+template <typename Solver>
+std::size_t EigenKrylovSolver::call_solver(
+  Solver& solver,
+  const Eigen::SparseMatrix<float, Eigen::RowMajor, int>& A_single,
+  Eigen::VectorXd& x, const Eigen::VectorXd& b, double inner_rtol,
+  bool nonzero_guess, bool error_on_nonconvergence)
+{
+  // Outer (double precision) tolerances and number of refinement
+  // steps
+  const double rtol = parameters["relative_tolerance"].is_set()
+    ? (double) parameters["relative_tolerance"] : 1.0e-12;
+  const double atol = parameters["absolute_tolerance"].is_set()
+    ? (double) parameters["absolute_tolerance"] : 0.0;
+  const int max_steps = parameters["maximum_refinement_steps"].is_set()
+    ? (int) parameters["maximum_refinement_steps"] : 20;
+
+  solver.setTolerance(inner_rtol);
+  if (parameters["maximum_iterations"].is_set())
+    solver.setMaxIterations((int) parameters["maximum_iterations"]);
+
+  // Prepare solver (and preconditioner) once for all refinement steps
+  solver.compute(A_single);
+  if (solver.info() != Eigen::Success)
+  {
+    dolfin_error("EigenKrylovSolver.cpp",
+                 "prepare Krylov solver",
+                 "Preconditioner might fail");
+  }
+
+  const EigenMatrix::eigen_matrix_type& A = _matA->mat();
+  if (!nonzero_guess)
+    x.setZero();
+
+  // Compute residual in double precision
+  Eigen::VectorXd r = b - A*x;
+  double r_norm = r.norm();
+  const double tol = std::max(rtol*b.norm(), atol);
+
+  Eigen::VectorXf r_single, dx_single;
+  std::size_t num_iterations = 0;
+  int step = 0;
+  while (r_norm > tol)
+  {
+    if (step == max_steps)
+    {
+      if (error_on_nonconvergence)
+      {
+        dolfin_error("EigenKrylovSolver.cpp",
+                     "solve A.x = b",
+                     "Mixed precision refinement did not converge in %d steps (residual norm %g)",
+                     max_steps, r_norm);
+      }
+      warning("Mixed precision refinement did not converge in %d steps",
+              max_steps);
+      break;
+    }
+
+    // Solve for correction in single precision. The residual is
+    // scaled to unit norm to keep it within the range of float. An
+    // inexact correction is acceptable, since it is refined in the
+    // next step.
+    r_single = (r/r_norm).cast<float>();
+    dx_single = solver.solve(r_single);
+    num_iterations += solver.iterations();
+    if (solver.info() != Eigen::Success
+        && solver.iterations() < solver.maxIterations())
+    {
+      dolfin_error("EigenKrylovSolver.cpp",
+                   "solve A.x = b",
+                   "Solver failed");
+    }
+
+    // Update solution and residual in double precision
+    x += r_norm*dx_single.cast<double>();
+    r = b - A*x;
+    const double r_norm_previous = r_norm;
+    r_norm = r.norm();
+    ++step;
+
+    log(PROGRESS, "Mixed precision refinement step %d: residual norm %g.",
+        step, r_norm);
+
+    // Check for stagnation, which happens if the single precision
+    // operator is too ill-conditioned to give useful corrections
+    if (r_norm >= r_norm_previous && r_norm > tol)
+    {
+      if (error_on_nonconvergence)
+      {
+        dolfin_error("EigenKrylovSolver.cpp",
+                     "solve A.x = b",
+                     "Mixed precision refinement stagnated at residual norm %g (operator may be too ill-conditioned for single precision)",
+                     r_norm);
+      }
+      warning("Mixed precision refinement stagnated at residual norm %g",
+              r_norm);
+      break;
+    }
+  }
+
+  return num_iterations;
+}
+//-----------------------------------------------------------------------------
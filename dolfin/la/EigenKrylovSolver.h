@@ -22,6 +22,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <Eigen/Sparse>
 #include <dolfin/common/types.h>
 #include "GenericLinearSolver.h"
 
@@ -36,6 +38,16 @@ namespace dolfin
 
   /// This class implements Krylov methods for linear systems of the
   /// form Ax = b. It is a wrapper for the Krylov solvers of Eigen.
+  ///
+  /// If the parameter "precision" is set to "mixed", the system is
+  /// solved by iterative refinement: the residual is computed in
+  /// double precision and the corrections are computed by the Krylov
+  /// method with a single precision copy of the operator, to the
+  /// relative tolerance "inner_relative_tolerance" (default 1e-4).
+  /// Refinement stops when the residual satisfies the relative or
+  /// absolute tolerance (default relative tolerance 1e-12), or after
+  /// "maximum_refinement_steps" steps (default 20). The returned
+  /// number of iterations is the total number of Krylov iterations.
 
   class EigenKrylovSolver : public GenericLinearSolver
   {
@@ -101,10 +113,34 @@ namespace dolfin
     // Initialize solver
     void init(const std::string method, const std::string pc="default");
 
+    // Solve by iterative refinement, with corrections computed in
+    // single precision
+    std::size_t solve_mixed_precision(EigenVector& x, const EigenVector& b);
+
+    // Solve Ax = b with the chosen method and preconditioner, in the
+    // scalar type of A (rtol <= 0 uses the Eigen default tolerance)
+    template <typename Matrix, typename Vector>
+    std::size_t solve_system(const Matrix& A, Vector& x, const Vector& b,
+                             double rtol, bool nonzero_guess,
+                             bool error_on_nonconvergence);
+
     // Call with an actual solver
+    template <typename Solver, typename Matrix, typename Vector>
+    std::size_t call_solver(Solver& solver, const Matrix& A, Vector& x,
+                            const Vector& b, double rtol, bool nonzero_guess,
+                            bool error_on_nonconvergence);
+
+    // Call with an actual single precision solver for the double
+    // precision system (mixed precision solves). The solver is
+    // prepared once and used for the corrections of all refinement
+    // steps.
     template <typename Solver>
-    std::size_t call_solver(Solver& solver, GenericVector& x,
-                            const GenericVector& b);
+    std::size_t
+      call_solver(Solver& solver,
+                  const Eigen::SparseMatrix<float, Eigen::RowMajor, int>& A_single,
+                  Eigen::VectorXd& x, const Eigen::VectorXd& b,
+                  double inner_rtol, bool nonzero_guess,
+                  bool error_on_nonconvergence);
 
     // Chosen Krylov method
     std::string _method;
@@ -122,6 +158,9 @@ namespace dolfin
     // Matrix used to construct the preconditioner
     std::shared_ptr<const EigenMatrix> _matP;
 
+    // Single precision copy of the operator (mixed precision solves)
+    Eigen::SparseMatrix<float, Eigen::RowMajor, int> _matA_single;
+
   };
 
 }
@@ -15,6 +15,8 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+
 #include <dolfin/common/types.h>
 #include <Eigen/SparseLU>
 #ifdef HAS_CHOLMOD
@@ -61,6 +63,12 @@ class EigenLUSolver::EigenLUImplBase
 {
 public:
   virtual void solve(EigenVector &x, const EigenVector &b) = 0;
+
+  // Recompute the numeric factorisation for a matrix with the same
+  // sparsity pattern, reusing the symbolic factorisation. Returns
+  // false (and does nothing) if the sparsity pattern has changed.
+  virtual bool refactorize(const EigenMatrix &A) = 0;
+
   virtual ~EigenLUImplBase() {}
 };
 
@@ -80,15 +88,36 @@ public:
     // Most solvers require a compressed matrix
     _A.makeCompressed();
 
-    // Factorize matrix
-    _solver->compute(_A);
+    // Compute symbolic and numeric factorization
+    {
+      Timer timer("Eigen LU symbolic factorisation");
+      _solver->analyzePattern(_A);
+    }
+    factorize();
+  }
 
-    if (_solver->info() != Eigen::Success)
+  bool refactorize(const EigenMatrix &A) override
+  {
+    typename Solver::MatrixType A_new(A.mat());
+    A_new.makeCompressed();
+
+    // Check that sparsity pattern is unchanged
+    if (A_new.rows() != _A.rows() || A_new.cols() != _A.cols()
+        || A_new.nonZeros() != _A.nonZeros()
+        || !std::equal(A_new.outerIndexPtr(),
+                       A_new.outerIndexPtr() + A_new.outerSize() + 1,
+                       _A.outerIndexPtr())
+        || !std::equal(A_new.innerIndexPtr(),
+                       A_new.innerIndexPtr() + A_new.nonZeros(),
+                       _A.innerIndexPtr()))
     {
-      dolfin_error("EigenLUSolver.cpp",
-                   "compute matrix factorisation",
-                   "The provided data did not satisfy the prerequisites");
+      return false;
     }
+
+    // Compute numeric factorization only
+    _A.swap(A_new);
+    factorize();
+    return true;
   }
 
   void solve(EigenVector &x, const EigenVector &b) override
@@ -106,6 +135,19 @@ public:
   }
 
 private:
+
+  void factorize()
+  {
+    Timer timer("Eigen LU numeric factorisation");
+    _solver->factorize(_A);
+    if (_solver->info() != Eigen::Success)
+    {
+      dolfin_error("EigenLUSolver.cpp",
+                   "compute matrix factorisation",
+                   "The provided data did not satisfy the prerequisites");
+    }
+  }
+
   std::shared_ptr<Solver> _solver;
   typename Solver::MatrixType _A;
 };
@@ -146,7 +188,7 @@ Parameters EigenLUSolver::default_parameters()
   return p;
 }
 //-----------------------------------------------------------------------------
-EigenLUSolver::EigenLUSolver(std::string method)
+EigenLUSolver::EigenLUSolver(std::string method) : _factorized(false)
 {
   // Set parameter values
   parameters = default_parameters();
@@ -155,7 +197,8 @@ EigenLUSolver::EigenLUSolver(std::string method)
 }
 //-----------------------------------------------------------------------------
 EigenLUSolver::EigenLUSolver(std::shared_ptr<const EigenMatrix> A,
-                             std::string method) : _matA(A)
+                             std::string method)
+  : _matA(A), _factorized(false)
 {
   // Check dimensions
   if (A->size(0) != A->size(1))
@@ -193,7 +236,10 @@ void EigenLUSolver::set_operator(std::shared_ptr<const EigenMatrix> A)
   dolfin_assert(_matA);
   dolfin_assert(!_matA->empty());
 
-  _impl.reset(nullptr);
+  // Mark factorisation as out of date. The factorisation object is
+  // kept such that the symbolic factorisation can be reused (see
+  // parameter "reuse_symbolic_factorisation")
+  _factorized = false;
 }
 //-----------------------------------------------------------------------------
 const GenericLinearOperator& EigenLUSolver::get_operator() const
@@ -230,6 +276,15 @@ std::size_t EigenLUSolver::solve(GenericVector& x, const GenericVector& b)
   if (x.empty())
     _matA->init_vector(x, 1);
 
+  // Recompute numeric factorization only, if requested and the
+  // sparsity pattern is unchanged
+  if (_impl && !_factorized)
+  {
+    const bool reuse_symbolic = parameters["reuse_symbolic_factorisation"];
+    if (!reuse_symbolic || !_impl->refactorize(*_matA))
+      _impl.reset(nullptr);
+  }
+
   // Initialize Eigen LU solver and compute factorization
   if (!_impl) {
     if (_method == "sparselu")
@@ -293,6 +348,7 @@ std::size_t EigenLUSolver::solve(GenericVector& x, const GenericVector& b)
       dolfin_error("EigenLUSolver.cpp", "solve A.x =b",
                    "Unknown method \"%s\"", _method.c_str());
   }
+  _factorized = true;
 
   // Solve linear system
   _impl->solve(_x, _b);
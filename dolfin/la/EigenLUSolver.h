@@ -101,6 +101,9 @@ namespace dolfin
     // Operator (the matrix)
     std::shared_ptr<const EigenMatrix> _matA;
 
+    // True if the factorisation is up to date with the operator
+    bool _factorized;
+
   };
 
 }
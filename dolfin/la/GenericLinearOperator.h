@@ -52,6 +52,16 @@ namespace dolfin
     /// Compute matrix-vector product y = Ax
     virtual void mult(const GenericVector& x, GenericVector& y) const = 0;
 
+    /// Compute the diagonal of the operator. Linear operators that
+    /// can compute their diagonal overload this function, which
+    /// enables Jacobi preconditioning of matrix-free operators.
+    virtual void get_diagonal(GenericVector& x) const
+    {
+      dolfin_error("GenericLinearOperator.h",
+                   "get diagonal of linear operator",
+                   "Diagonal is not available for this linear operator");
+    }
+
     /// Return informal string representation (pretty-print)
     virtual std::string str(bool verbose) const = 0;
 
@@ -0,0 +1,263 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifdef HAS_MPI
+
+#include <algorithm>
+#include <numeric>
+#include <dolfin/log/log.h>
+#include "IndexMap.h"
+#include "GhostScatter.h"
+
+using namespace dolfin;
+
+namespace
+{
+  // Global indices of the unowned entries of an index map (all
+  // entries of each block)
+  std::vector<std::size_t> ghost_indices(const IndexMap& index_map)
+  {
+    const std::size_t bs = index_map.block_size();
+    const std::vector<std::size_t>& ghost_nodes
+      = index_map.local_to_global_unowned();
+    std::vector<std::size_t> ghosts(bs*ghost_nodes.size());
+    for (std::size_t i = 0; i < ghost_nodes.size(); ++i)
+      for (std::size_t j = 0; j < bs; ++j)
+        ghosts[bs*i + j] = bs*ghost_nodes[i] + j;
+    return ghosts;
+  }
+
+  // Owning processes of the unowned entries of an index map (all
+  // entries of each block)
+  std::vector<int> ghost_owners(const IndexMap& index_map)
+  {
+    const std::size_t bs = index_map.block_size();
+    const std::vector<int>& node_owners = index_map.off_process_owner();
+    std::vector<int> owners(bs*node_owners.size());
+    for (std::size_t i = 0; i < node_owners.size(); ++i)
+      std::fill_n(owners.begin() + bs*i, bs, node_owners[i]);
+    return owners;
+  }
+}
+
+//-----------------------------------------------------------------------------
+struct GhostScatter::Pattern
+{
+  // Neighbourhood communicator
+  std::unique_ptr<MPI::Comm> neighbour_comm;
+
+  // Neighbouring processes (sorted)
+  std::vector<int> neighbours;
+
+  // Number of owned entries
+  std::size_t num_owned;
+
+  // Owned entries (local indices) to send to each neighbour, with
+  // counts and offsets per neighbour
+  std::vector<std::int32_t> send_indices;
+  std::vector<int> send_sizes, send_offsets;
+
+  // Ghost entries (position among ghosts) to receive from each
+  // neighbour, with counts and offsets per neighbour
+  std::vector<std::int32_t> recv_indices;
+  std::vector<int> recv_sizes, recv_offsets;
+};
+//-----------------------------------------------------------------------------
+GhostScatter::GhostScatter(MPI_Comm comm,
+                           std::pair<std::size_t, std::size_t> local_range,
+                           const std::vector<std::size_t>& ghosts,
+                           const std::vector<int>& ghost_owners)
+  : _request(MPI_REQUEST_NULL)
+{
+  dolfin_assert(ghosts.size() == ghost_owners.size());
+  const std::size_t mpi_size = MPI::size(comm);
+
+  std::shared_ptr<Pattern> pattern = std::make_shared<Pattern>();
+  pattern->num_owned = local_range.second - local_range.first;
+
+  // Global indices of ghosts, per owning process
+  std::vector<int> owners;
+  std::vector<std::vector<std::int64_t>> send_ghosts(mpi_size);
+  for (std::size_t i = 0; i < ghosts.size(); ++i)
+  {
+    if (send_ghosts[ghost_owners[i]].empty())
+      owners.push_back(ghost_owners[i]);
+    send_ghosts[ghost_owners[i]].push_back(ghosts[i]);
+  }
+
+  // Count the processes that hold owned entries of this process as
+  // ghosts (the only global operation)
+  std::vector<int> num_messages(mpi_size, 0);
+  for (auto p : owners)
+    num_messages[p] = 1;
+  int num_sources = 0;
+  MPI_Reduce_scatter_block(num_messages.data(), &num_sources, 1, MPI_INT,
+                           MPI_SUM, comm);
+
+  // Send global indices of ghosts to owning processes, and receive
+  // the owned entries requested by other processes
+  const int tag = 1;
+  std::vector<MPI_Request> requests(owners.size());
+  for (std::size_t i = 0; i < owners.size(); ++i)
+  {
+    const std::vector<std::int64_t>& data = send_ghosts[owners[i]];
+    MPI_Isend(data.data(), data.size(), MPI_INT64_T, owners[i], tag, comm,
+              &requests[i]);
+  }
+  std::vector<std::vector<std::int64_t>> recv_ghosts(mpi_size);
+  for (int i = 0; i < num_sources; ++i)
+  {
+    MPI_Status status;
+    MPI_Probe(MPI_ANY_SOURCE, tag, comm, &status);
+    int count = 0;
+    MPI_Get_count(&status, MPI_INT64_T, &count);
+    std::vector<std::int64_t>& data = recv_ghosts[status.MPI_SOURCE];
+    data.resize(count);
+    MPI_Recv(data.data(), count, MPI_INT64_T, status.MPI_SOURCE, tag, comm,
+             MPI_STATUS_IGNORE);
+  }
+  MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+  // Neighbours are the owners of ghosts on this process and the
+  // processes that hold owned entries as ghosts
+  std::vector<int>& neighbours = pattern->neighbours;
+  for (std::size_t p = 0; p < mpi_size; ++p)
+  {
+    if (!send_ghosts[p].empty() or !recv_ghosts[p].empty())
+      neighbours.push_back(p);
+  }
+  std::vector<std::vector<std::int64_t>>().swap(send_ghosts);
+
+  // Owned entries to send to each neighbour, in the order requested
+  pattern->send_sizes.resize(neighbours.size());
+  pattern->send_offsets.assign(neighbours.size() + 1, 0);
+  for (std::size_t n = 0; n < neighbours.size(); ++n)
+  {
+    for (auto index : recv_ghosts[neighbours[n]])
+    {
+      dolfin_assert(index >= (std::int64_t) local_range.first
+                    and index < (std::int64_t) local_range.second);
+      pattern->send_indices.push_back(index - local_range.first);
+    }
+    pattern->send_sizes[n] = recv_ghosts[neighbours[n]].size();
+    pattern->send_offsets[n + 1]
+      = pattern->send_offsets[n] + pattern->send_sizes[n];
+  }
+
+  // Ghost entries to receive from each neighbour, in the order in
+  // which they were requested
+  std::vector<int> neighbour_index(mpi_size, -1);
+  for (std::size_t n = 0; n < neighbours.size(); ++n)
+    neighbour_index[neighbours[n]] = n;
+  pattern->recv_sizes.assign(neighbours.size(), 0);
+  for (auto owner : ghost_owners)
+    ++pattern->recv_sizes[neighbour_index[owner]];
+  pattern->recv_offsets.assign(neighbours.size() + 1, 0);
+  std::partial_sum(pattern->recv_sizes.begin(), pattern->recv_sizes.end(),
+                   pattern->recv_offsets.begin() + 1);
+  std::vector<int> pos(pattern->recv_offsets.begin(),
+                       pattern->recv_offsets.end() - 1);
+  pattern->recv_indices.resize(ghosts.size());
+  for (std::size_t i = 0; i < ghost_owners.size(); ++i)
+    pattern->recv_indices[pos[neighbour_index[ghost_owners[i]]]++] = i;
+
+  // Create neighbourhood communicator
+  MPI_Comm neighbour_comm = MPI::create_neighbour_comm(comm, neighbours);
+  pattern->neighbour_comm.reset(new MPI::Comm(neighbour_comm));
+  MPI_Comm_free(&neighbour_comm);
+
+  _send_buffer.resize(pattern->send_indices.size());
+  _recv_buffer.resize(pattern->recv_indices.size());
+  _pattern = pattern;
+}
+//-----------------------------------------------------------------------------
+GhostScatter::GhostScatter(const IndexMap& index_map)
+  : GhostScatter(index_map.mpi_comm(), index_map.local_range(),
+                 ghost_indices(index_map), ghost_owners(index_map))
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+GhostScatter::GhostScatter(const GhostScatter& scatter)
+  : _pattern(scatter._pattern),
+    _send_buffer(scatter._send_buffer.size()),
+    _recv_buffer(scatter._recv_buffer.size()),
+    _request(MPI_REQUEST_NULL)
+{
+  // Do nothing
+}
+//-----------------------------------------------------------------------------
+GhostScatter::~GhostScatter()
+{
+  // Complete any pending update before buffers are released
+  if (_request != MPI_REQUEST_NULL)
+    MPI_Wait(&_request, MPI_STATUS_IGNORE);
+}
+//-----------------------------------------------------------------------------
+void GhostScatter::update_begin(const double* x)
+{
+  if (_request != MPI_REQUEST_NULL)
+  {
+    dolfin_error("GhostScatter.cpp",
+                 "begin update of ghost values",
+                 "A previous update has not been completed");
+  }
+
+  // Pack owned values
+  const Pattern& p = *_pattern;
+  for (std::size_t i = 0; i < p.send_indices.size(); ++i)
+    _send_buffer[i] = x[p.send_indices[i]];
+
+  MPI_Ineighbor_alltoallv(_send_buffer.data(), p.send_sizes.data(),
+                          p.send_offsets.data(), MPI_DOUBLE,
+                          _recv_buffer.data(), p.recv_sizes.data(),
+                          p.recv_offsets.data(), MPI_DOUBLE,
+                          p.neighbour_comm->comm(), &_request);
+}
+//-----------------------------------------------------------------------------
+void GhostScatter::update_end(double* x)
+{
+  MPI_Wait(&_request, MPI_STATUS_IGNORE);
+
+  // Unpack ghost values
+  const Pattern& p = *_pattern;
+  for (std::size_t i = 0; i < p.recv_indices.size(); ++i)
+    x[p.num_owned + p.recv_indices[i]] = _recv_buffer[i];
+}
+//-----------------------------------------------------------------------------
+const std::vector<int>& GhostScatter::neighbours() const
+{
+  return _pattern->neighbours;
+}
+//-----------------------------------------------------------------------------
+MPI_Comm GhostScatter::neighbour_comm() const
+{
+  return _pattern->neighbour_comm->comm();
+}
+//-----------------------------------------------------------------------------
+std::size_t GhostScatter::num_owned() const
+{
+  return _pattern->num_owned;
+}
+//-----------------------------------------------------------------------------
+std::size_t GhostScatter::num_ghosts() const
+{
+  return _pattern->recv_indices.size();
+}
+//-----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,116 @@
+// Copyright (C) 2018 Ryan Freckleton
+//
+// This file is part of DOLFIN.
+//
+// DOLFIN is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// DOLFIN is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __DOLFIN_GHOST_SCATTER_H
+#define __DOLFIN_GHOST_SCATTER_H
+
+#ifdef HAS_MPI
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <dolfin/common/MPI.h>
+
+namespace dolfin
+{
+
+  class IndexMap;
+
+  /// This class updates the ghost entries of a distributed array
+  /// with the values held by the owning processes. Data is exchanged
+  /// with neighbouring processes only (processes that own ghost
+  /// entries of this process, or hold owned entries of this process
+  /// as ghosts), using an MPI-3 neighbourhood collective. The
+  /// neighbourhood communicator and the lists of entries to send and
+  /// receive are computed once, on construction, and are shared by
+  /// copies of the scatter. IndexMap::ghost_scatter() returns a
+  /// scatter that is computed once per index map.
+  ///
+  /// Updates are split into a begin and an end phase, so that work
+  /// which does not depend on ghost values can be done while data is
+  /// being exchanged.
+
+  class GhostScatter
+  {
+  public:
+
+    /// Create scatter for an array with given ownership range
+    /// (global indices) and ghost entries with given global indices
+    /// and owning processes. This constructor is collective, but
+    /// only exchanges data with neighbouring processes (apart from
+    /// one reduction of message counts).
+    GhostScatter(MPI_Comm comm,
+                 std::pair<std::size_t, std::size_t> local_range,
+                 const std::vector<std::size_t>& ghosts,
+                 const std::vector<int>& ghost_owners);
+
+    /// Create scatter for the unowned entries of an index map
+    /// (including all entries of each block). This constructor is
+    /// collective.
+    explicit GhostScatter(const IndexMap& index_map);
+
+    /// Copy constructor (the communication pattern is shared, and
+    /// buffers are created for the copy)
+    GhostScatter(const GhostScatter& scatter);
+
+    /// Destructor
+    ~GhostScatter();
+
+    /// Start update of ghost values. The array x holds the owned
+    /// entries followed by the ghost entries. Owned values are
+    /// buffered, and may be modified before update_end() is called.
+    /// This function is collective.
+    void update_begin(const double* x);
+
+    /// Complete update of ghost values started by update_begin(),
+    /// writing the received values into the ghost entries of x
+    void update_end(double* x);
+
+    /// Return processes that this process exchanges data with
+    const std::vector<int>& neighbours() const;
+
+    /// Return neighbourhood communicator, with the processes
+    /// returned by neighbours() as sources and destinations
+    MPI_Comm neighbour_comm() const;
+
+    /// Return number of owned entries
+    std::size_t num_owned() const;
+
+    /// Return number of ghost entries
+    std::size_t num_ghosts() const;
+
+  private:
+
+    // Communication pattern (neighbourhood communicator and entries
+    // to send and receive), shared by copies
+    struct Pattern;
+    std::shared_ptr<const Pattern> _pattern;
+
+    // Send and receive buffers
+    std::vector<double> _send_buffer, _recv_buffer;
+
+    // Request for pending update
+    MPI_Request _request;
+
+  };
+
+}
+
+#endif
+
+#endif
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <limits>
+#include "GhostScatter.h"
 #include "IndexMap.h"
 
 using namespace dolfin;
@@ -49,6 +50,7 @@ IndexMap::~IndexMap()
 void IndexMap::init(std::size_t local_size, std::size_t block_size)
 {
   _block_size = block_size;
+  _ghost_scatter.reset();
 
   // Calculate offsets
   MPI::all_gather(_mpi_comm.comm(), local_size, _all_ranges);
@@ -112,6 +114,8 @@ const std::vector<std::size_t>& IndexMap::local_to_global_unowned() const
 void IndexMap::set_local_to_global(const std::vector<std::size_t>& indices)
 {
   _local_to_global = indices;
+  _off_process_owner.clear();
+  _ghost_scatter.reset();
 
   for (const auto &node : _local_to_global)
   {
@@ -119,6 +123,12 @@ void IndexMap::set_local_to_global(const std::vector<std::size_t>& indices)
     dolfin_assert(p != _rank);
     _off_process_owner.push_back(p);
   }
+
+  // Build the neighbourhood scatter here, where all processes take
+  // part, so that neighbours() and ghost_scatter() do not communicate
+  #ifdef HAS_MPI
+  _ghost_scatter = std::make_shared<GhostScatter>(*this);
+  #endif
 }
 //-----------------------------------------------------------------------------
 int IndexMap::global_index_owner(std::size_t index) const
@@ -129,6 +139,30 @@ int IndexMap::global_index_owner(std::size_t index) const
   return p;
 }
 //-----------------------------------------------------------------------------
+const std::vector<int>& IndexMap::neighbours() const
+{
+  // Without unowned indices on any process there are no neighbours
+  #ifdef HAS_MPI
+  if (_ghost_scatter)
+    return _ghost_scatter->neighbours();
+  #endif
+  static const std::vector<int> no_neighbours;
+  return no_neighbours;
+}
+//-----------------------------------------------------------------------------
+#ifdef HAS_MPI
+const GhostScatter& IndexMap::ghost_scatter() const
+{
+  if (!_ghost_scatter)
+  {
+    dolfin_error("IndexMap.cpp",
+                 "get ghost scatter",
+                 "Ghost scatter is built by set_local_to_global(), which has not been called");
+  }
+  return *_ghost_scatter;
+}
+#endif
+//-----------------------------------------------------------------------------
 const std::vector<int>& IndexMap::off_process_owner() const
 {
   return _off_process_owner;
@@ -18,6 +18,7 @@
 #ifndef __INDEX_MAP_H
 #define __INDEX_MAP_H
 
+#include <memory>
 #include <utility>
 #include <vector>
 #include <dolfin/common/MPI.h>
@@ -25,6 +26,8 @@
 namespace dolfin
 {
 
+  class GhostScatter;
+
   /// This class represents the distribution index arrays across
   /// processes. An index array is a contiguous collection of N+1
   /// indices [0, 1, . . ., N] that are distributed across processes M
@@ -76,7 +79,8 @@ namespace dolfin
     std::size_t local_to_global(std::size_t i) const;
 
     /// Set local_to_global map for unowned indices (beyond end of local
-    /// range). Computes and stores off-process owner array.
+    /// range). Computes and stores off-process owner array and the
+    /// ghost scatter. This function is collective
     void set_local_to_global(const std::vector<std::size_t>& indices);
 
     /// Get off process owner for unowned indices
@@ -85,6 +89,20 @@ namespace dolfin
     /// Get process owner of any global index
     int global_index_owner(std::size_t index) const;
 
+    /// Get processes that own unowned indices of this process, or
+    /// hold owned indices of this process as unowned indices
+    /// (sorted). Empty if set_local_to_global() has not been called.
+    const std::vector<int>& neighbours() const;
+
+    #ifdef HAS_MPI
+    /// Get scatter that updates the unowned entries of an array
+    /// (with one entry per index) with the values of the owning
+    /// processes, exchanging data with neighbours only. The scatter
+    /// is computed by set_local_to_global() and shared by all
+    /// callers; copy it to perform updates.
+    const GhostScatter& ghost_scatter() const;
+    #endif
+
     /// Get block size
     int block_size() const;
 
@@ -112,6 +130,10 @@ namespace dolfin
     // Block size
     int _block_size;
 
+    // Neighbourhood scatter for unowned entries (computed by
+    // set_local_to_global)
+    std::shared_ptr<const GhostScatter> _ghost_scatter;
+
   };
 
   // Function which may appear in a hot loop
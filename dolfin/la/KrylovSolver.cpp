@@ -15,6 +15,8 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
+#include <set>
+#include <string>
 #include <dolfin/common/Timer.h>
 #include <dolfin/parameter/GlobalParameters.h>
 #include <dolfin/parameter/Parameters.h>
@@ -42,6 +44,12 @@ Parameters KrylovSolver::default_parameters()
   p.add<bool>("error_on_nonconvergence");
   p.add<bool>("nonzero_initial_guess");
 
+  // Mixed precision iterative refinement (Eigen backend only)
+  std::set<std::string> allowed_precisions = {"double", "mixed"};
+  p.add("precision", allowed_precisions);
+  p.add<double>("inner_relative_tolerance");
+  p.add<int>("maximum_refinement_steps");
+
   return p;
 }
 //-----------------------------------------------------------------------------
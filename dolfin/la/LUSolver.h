@@ -71,6 +71,7 @@ namespace dolfin
       p.add("report", true);
       p.add("verbose", false);
       p.add("symmetric", false);
+      p.add("reuse_symbolic_factorisation", false);
       return p;
     }
 
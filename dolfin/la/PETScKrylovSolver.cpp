@@ -263,6 +263,19 @@ std::size_t PETScKrylovSolver::solve(PETScVector& x, const PETScVector& b,
                  M, b.size());
   }
 
+  // PETSc matrices store the scalar type that PETSc was configured
+  // with, so mixed precision solves are not supported
+  if (this->parameters["precision"].is_set())
+  {
+    const std::string precision = this->parameters["precision"];
+    if (precision == "mixed")
+    {
+      dolfin_error("PETScKrylovSolver.cpp",
+                   "unable to solve linear system with PETSc Krylov solver",
+                   "Mixed precision solves are only supported by the Eigen backend");
+    }
+  }
+
   // Write a message
   const bool report = this->parameters["report"].is_set() ? this->parameters["report"] : false;
   if (report and dolfin::MPI::rank(this->mpi_comm()) == 0)
@@ -57,6 +57,26 @@ namespace dolfin
 
     return 0;
   }
+
+  /// Callback function for PETSc get diagonal function
+  int usergetdiagonal(Mat A, Vec d)
+  {
+    // Wrap PETSc Vec as dolfin::PETScVector
+    PETScVector _d(d);
+
+    // Extract pointer to PETScLinearOperator
+    void* ctx = 0;
+    MatShellGetContext(A, &ctx);
+    PETScLinearOperator* _matA = ((PETScLinearOperator*) ctx);
+
+    // Call user-defined get_diagonal function through wrapper
+    dolfin_assert(_matA);
+    GenericLinearOperator* wrapper = _matA->wrapper();
+    dolfin_assert(wrapper);
+    wrapper->get_diagonal(_d);
+
+    return 0;
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -154,6 +174,11 @@ void PETScLinearOperator::init_layout(const GenericVector& x,
   // Set matrix mult function
   ierr = MatShellSetOperation(_matA, MATOP_MULT, (void (*)()) usermult);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatShellSetOperation");
+
+  // Set matrix get diagonal function (used by Jacobi preconditioner)
+  ierr = MatShellSetOperation(_matA, MATOP_GET_DIAGONAL,
+                              (void (*)()) usergetdiagonal);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatShellSetOperation");
 }
 //-----------------------------------------------------------------------------
 
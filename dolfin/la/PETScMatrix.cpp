@@ -34,6 +34,7 @@
 #include <dolfin/log/log.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/MPI.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "PETScFactory.h"
 #include "PETScVector.h"
 #include "SparsityPattern.h"
@@ -48,6 +49,52 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Convert number of nonzeros per row to number of nonzero blocks
+  // per block row
+  std::vector<PetscInt>
+  num_nonzero_blocks(const std::vector<std::size_t>& num_nonzeros,
+                     std::size_t block_size)
+  {
+    std::vector<PetscInt> _num_nonzeros(num_nonzeros.size()/block_size);
+    for (std::size_t i = 0; i < _num_nonzeros.size(); ++i)
+    {
+      _num_nonzeros[i]
+        = dolfin_ceil_div(num_nonzeros[block_size*i], block_size);
+    }
+    return _num_nonzeros;
+  }
+
+  // Compute block indices of element dofs of a vector-valued space,
+  // which are ordered by component ([dofs of component 0, dofs of
+  // component 1, ...]). Returns false if the dofs do not have this
+  // structure.
+  bool block_indices(std::size_t m, const dolfin::la_index* dofs,
+                     std::size_t block_size,
+                     std::vector<PetscInt>& block_dofs)
+  {
+    if (m % block_size != 0)
+      return false;
+
+    const std::size_t num_blocks = m/block_size;
+    block_dofs.resize(num_blocks);
+    for (std::size_t k = 0; k < num_blocks; ++k)
+    {
+      const dolfin::la_index dof = dofs[k];
+      if (dof % block_size != 0)
+        return false;
+      for (std::size_t c = 1; c < block_size; ++c)
+      {
+        if (dofs[c*num_blocks + k] != dof + (dolfin::la_index) c)
+          return false;
+      }
+      block_dofs[k] = dof/block_size;
+    }
+    return true;
+  }
+}
+
 const std::map<std::string, NormType> PETScMatrix::norm_types
 = { {"l1",        NORM_1},
     {"linf",      NORM_INFINITY},
@@ -58,19 +105,22 @@ PETScMatrix::PETScMatrix() : PETScMatrix(MPI_COMM_WORLD)
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-PETScMatrix::PETScMatrix(MPI_Comm comm) : PETScBaseMatrix()
+PETScMatrix::PETScMatrix(MPI_Comm comm) : PETScBaseMatrix(),
+                                           _block_insertion(false)
 {
   // Create uninitialised matrix
   PetscErrorCode ierr = MatCreate(comm, &_matA);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatCreate");
 }
 //-----------------------------------------------------------------------------
-PETScMatrix::PETScMatrix(Mat A) : PETScBaseMatrix(A)
+PETScMatrix::PETScMatrix(Mat A) : PETScBaseMatrix(A),
+                                  _block_insertion(false)
 {
   // Reference count to A is incremented in base class
 }
 //-----------------------------------------------------------------------------
-PETScMatrix::PETScMatrix(const PETScMatrix& A) : PETScBaseMatrix()
+PETScMatrix::PETScMatrix(const PETScMatrix& A) : PETScBaseMatrix(),
+  _block_insertion(A._block_insertion)
 {
   dolfin_assert(A.mat());
   if (!A.empty())
@@ -137,32 +187,78 @@ void PETScMatrix::init(const TensorLayout& tensor_layout)
   ierr = MatSetSizes(_matA, m, n, M, N);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetSizes");
 
+  // Use block (BAIJ) storage if requested. Blocks require a blocked
+  // sparsity pattern.
+  const std::string block_storage
+    = dolfin::parameters["matrix_block_storage"];
+  const bool blocked_pattern = block_size > 1
+    && (int) sparsity_pattern->block_size() == block_size;
+  if (block_storage == "block" && blocked_pattern)
+  {
+    ierr = MatSetType(_matA, MATBAIJ);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetType");
+  }
+
   // Apply PETSc options from the options database to the matrix (this
   // includes changing the matrix type to one specified by the user)
   ierr = MatSetFromOptions(_matA);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetFromOptions");
 
-  // Build data to initialixe sparsity pattern (modify for block size)
-  std::vector<PetscInt> _num_nonzeros_diagonal(num_nonzeros_diagonal.size()/block_size),
-    _num_nonzeros_off_diagonal(num_nonzeros_off_diagonal.size()/block_size);
-
-  for (std::size_t i = 0; i < _num_nonzeros_diagonal.size(); ++i)
+  // Check if matrix uses (symmetric) block storage
+  PetscBool is_baij = PETSC_FALSE, is_sbaij = PETSC_FALSE;
+  ierr = PetscObjectTypeCompareAny((PetscObject)_matA, &is_baij, MATBAIJ,
+                                   MATSEQBAIJ, MATMPIBAIJ, "");
+  if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectTypeCompareAny");
+  ierr = PetscObjectTypeCompareAny((PetscObject)_matA, &is_sbaij, MATSBAIJ,
+                                   MATSEQSBAIJ, MATMPISBAIJ, "");
+  if (ierr != 0) petsc_error(ierr, __FILE__, "PetscObjectTypeCompareAny");
+
+  // Symmetric block storage (SBAIJ) is only valid for symmetric
+  // forms, so it is never chosen here. It can be requested for a
+  // matrix through the options database (with the options prefix of
+  // the matrix), and then needs square blocks and a blocked sparsity
+  // pattern.
+  if (is_sbaij && (M != N || row_range != col_range
+                   || (block_size > 1 && !blocked_pattern)))
   {
-    _num_nonzeros_diagonal[i]
-      = dolfin_ceil_div(num_nonzeros_diagonal[block_size*i], block_size);
+    dolfin_error("PETScMatrix.cpp",
+                 "init PETSc matrix",
+                 "Symmetric block storage requires a square matrix with "
+                 "equal row and column layouts and a blocked sparsity "
+                 "pattern (set parameter \"matrix_block_storage\" to "
+                 "\"block\")");
   }
-  for (std::size_t i = 0; i < _num_nonzeros_off_diagonal.size(); ++i)
+
+  // Build data to initialixe sparsity pattern (modify for block size)
+  const std::vector<PetscInt> _num_nonzeros_diagonal
+    = num_nonzero_blocks(num_nonzeros_diagonal, block_size);
+  const std::vector<PetscInt> _num_nonzeros_off_diagonal
+    = num_nonzero_blocks(num_nonzeros_off_diagonal, block_size);
+
+  // Symmetric storage is allocated for the upper triangle only
+  std::vector<PetscInt> _num_nonzeros_diagonal_upper,
+    _num_nonzeros_off_diagonal_upper;
+  if (is_sbaij)
   {
-    _num_nonzeros_off_diagonal[i]
-      = dolfin_ceil_div(num_nonzeros_off_diagonal[block_size*i], block_size);
+    sparsity_pattern->num_nonzeros_upper(num_nonzeros_diagonal,
+                                         num_nonzeros_off_diagonal);
+    _num_nonzeros_diagonal_upper
+      = num_nonzero_blocks(num_nonzeros_diagonal, block_size);
+    _num_nonzeros_off_diagonal_upper
+      = num_nonzero_blocks(num_nonzeros_off_diagonal, block_size);
   }
 
   // Allocate space (using data from sparsity pattern)
   ierr = MatXAIJSetPreallocation(_matA, block_size,
                                  _num_nonzeros_diagonal.data(),
-                                 _num_nonzeros_off_diagonal.data(), NULL, NULL);
+                                 _num_nonzeros_off_diagonal.data(),
+                                 is_sbaij ? _num_nonzeros_diagonal_upper.data() : NULL,
+                                 is_sbaij ? _num_nonzeros_off_diagonal_upper.data() : NULL);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatXIJSetPreallocation");
 
+  // Insert element matrices by blocks for block storage
+  _block_insertion = (is_baij || is_sbaij) && blocked_pattern;
+
 
   // Create pointers to PETSc IndexSet for local-to-globa map
   ISLocalToGlobalMapping petsc_local_to_global0, petsc_local_to_global1;
@@ -215,6 +311,14 @@ void PETScMatrix::init(const TensorLayout& tensor_layout)
   // Keep nonzero structure after calling MatZeroRows
   ierr = MatSetOption(_matA, MAT_KEEP_NONZERO_PATTERN, PETSC_TRUE);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetOption");
+
+  // Ignore entries below the diagonal for symmetric storage, such
+  // that full element matrices can be added
+  if (is_sbaij)
+  {
+    ierr = MatSetOption(_matA, MAT_IGNORE_LOWER_TRIANGULAR, PETSC_TRUE);
+    if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetOption");
+  }
 }
 //-----------------------------------------------------------------------------
 bool PETScMatrix::empty() const
@@ -269,11 +373,51 @@ void PETScMatrix::add_local(const double* block,
                             std::size_t n, const dolfin::la_index* cols)
 {
   dolfin_assert(_matA);
+
+  // Add by blocks if possible
+  if (_block_insertion && add_local_blocked(block, m, rows, n, cols))
+    return;
+
   PetscErrorCode ierr = MatSetValuesLocal(_matA, m, rows, n, cols, block,
                                           ADD_VALUES);
   if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetValuesLocal");
 }
 //-----------------------------------------------------------------------------
+bool PETScMatrix::add_local_blocked(const double* block,
+                                    std::size_t m, const dolfin::la_index* rows,
+                                    std::size_t n, const dolfin::la_index* cols)
+{
+  PetscInt bs = 1;
+  PetscErrorCode ierr = MatGetBlockSize(_matA, &bs);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatGetBlockSize");
+
+  // Get block indices
+  std::vector<PetscInt> block_rows, block_cols;
+  if (!block_indices(m, rows, bs, block_rows)
+      || !block_indices(n, cols, bs, block_cols))
+  {
+    return false;
+  }
+
+  // Reorder values from component ordering to block ordering (row
+  // major blocks)
+  const std::size_t mb = block_rows.size();
+  const std::size_t nb = block_cols.size();
+  std::vector<double> values(m*n);
+  for (std::size_t i = 0; i < m; ++i)
+  {
+    const std::size_t _i = (i % mb)*bs + i/mb;
+    for (std::size_t j = 0; j < n; ++j)
+      values[_i*n + (j % nb)*bs + j/nb] = block[i*n + j];
+  }
+
+  ierr = MatSetValuesBlockedLocal(_matA, mb, block_rows.data(),
+                                  nb, block_cols.data(), values.data(),
+                                  ADD_VALUES);
+  if (ierr != 0) petsc_error(ierr, __FILE__, "MatSetValuesBlockedLocal");
+  return true;
+}
+//-----------------------------------------------------------------------------
 void PETScMatrix::axpy(double a, const GenericMatrix& A,
                        bool same_nonzero_pattern)
 {
@@ -669,6 +813,7 @@ const PETScMatrix& PETScMatrix::operator= (const PETScMatrix& A)
     // Duplicate with the same pattern as A.A
     PetscErrorCode ierr = MatDuplicate(A.mat(), MAT_COPY_VALUES, &_matA);
     if (ierr != 0) petsc_error(ierr, __FILE__, "MatDuplicate");
+    _block_insertion = A._block_insertion;
   }
   return *this;
 }
@@ -54,6 +54,16 @@ namespace dolfin
   /// The interface is intentionally simple. For advanced usage,
   /// access the PETSc Mat pointer using the function mat() and
   /// use the standard PETSc interface.
+  ///
+  /// The matrix is created with block (BAIJ) storage if the global
+  /// parameter "matrix_block_storage" is "block" and the sparsity
+  /// pattern is blocked. Element matrices of vector-valued spaces are
+  /// then added by blocks in add_local(). Symmetric block (SBAIJ)
+  /// storage is only valid for symmetric forms and is requested per
+  /// matrix through the PETSc options database, e.g. by setting the
+  /// options prefix "K_" and the option "K_mat_type sbaij". Entries
+  /// below the diagonal are then ignored, so boundary conditions
+  /// should be applied symmetrically (e.g. using assemble_system).
 
   class PETScMatrix : public GenericMatrix, public PETScBaseMatrix
   {
@@ -239,12 +249,22 @@ namespace dolfin
 
   private:
 
+    // Add element matrix of a vector-valued space using block
+    // indices. Returns false if the element dofs do not form blocks.
+    bool add_local_blocked(const double* block,
+                           std::size_t m, const dolfin::la_index* rows,
+                           std::size_t n, const dolfin::la_index* cols);
+
     // Create PETSc nullspace object
     MatNullSpace create_petsc_nullspace(const VectorSpaceBasis& nullspace) const;
 
     // PETSc norm types
     static const std::map<std::string, NormType> norm_types;
 
+    // True if values are added by blocks (BAIJ and SBAIJ matrices
+    // with block size larger than one)
+    bool _block_insertion;
+
   };
 
 }
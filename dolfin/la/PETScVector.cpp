@@ -23,6 +23,7 @@
 
 #ifdef HAS_PETSC
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstring>
@@ -31,6 +32,8 @@
 #include <dolfin/common/Array.h>
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
+#include "GhostScatter.h"
 #include "SparsityPattern.h"
 #include "PETScVector.h"
 #include "PETScFactory.h"
@@ -88,6 +91,12 @@ PETScVector::PETScVector(const PETScVector& v) : _x(nullptr)
   ierr = VecCopy(v._x, _x);
   CHECK_ERROR("VecCopy");
 
+  // Copy ghost scatter (communication pattern is shared)
+  #ifdef HAS_MPI
+  if (v._ghost_scatter)
+    _ghost_scatter.reset(new GhostScatter(*v._ghost_scatter));
+  #endif
+
   // Update ghost values
   update_ghost_values();
 }
@@ -122,6 +131,32 @@ void PETScVector::init(std::pair<std::size_t, std::size_t> range,
   _init(range, local_to_global_map, ghost_indices);
 }
 //-----------------------------------------------------------------------------
+void PETScVector::init(const TensorLayout& tensor_layout)
+{
+  GenericVector::init(tensor_layout);
+
+  // Update ghost entries with the neighbourhood scatter of the index
+  // map, which is shared by all vectors with the same layout
+  #ifdef HAS_MPI
+  const std::string ghost_update
+    = dolfin::parameters["ghost_update_communication"];
+  if (tensor_layout.is_ghosted() == TensorLayout::Ghosts::GHOSTED
+      and ghost_update == "neighbourhood")
+  {
+    PetscErrorCode ierr;
+    VecType vec_type = nullptr;
+    ierr = VecGetType(_x, &vec_type);
+    CHECK_ERROR("VecGetType");
+    if (strcmp(vec_type, VECMPI) == 0)
+    {
+      dolfin_assert(tensor_layout.index_map(0));
+      _ghost_scatter.reset(new GhostScatter(tensor_layout.index_map(0)
+                                            ->ghost_scatter()));
+    }
+  }
+  #endif
+}
+//-----------------------------------------------------------------------------
 void PETScVector::get_local(std::vector<double>& values) const
 {
   dolfin_assert(_x);
@@ -423,20 +458,80 @@ const PETScVector& PETScVector::operator= (double a)
 }
 //-----------------------------------------------------------------------------
 void PETScVector::update_ghost_values()
+{
+  update_ghost_values_begin();
+  update_ghost_values_end();
+}
+//-----------------------------------------------------------------------------
+void PETScVector::update_ghost_values_begin()
 {
   dolfin_assert(_x);
   PetscErrorCode ierr;
 
+  #ifdef HAS_MPI
+  if (_ghost_scatter)
+  {
+    // Send owned values to neighbours
+    const PetscScalar* x = nullptr;
+    ierr = VecGetArrayRead(_x, &x);
+    CHECK_ERROR("VecGetArrayRead");
+    _ghost_scatter->update_begin(x);
+    ierr = VecRestoreArrayRead(_x, &x);
+    CHECK_ERROR("VecRestoreArrayRead");
+    return;
+  }
+  #endif
+
   // Check of vector is ghosted
   Vec xg;
   ierr = VecGhostGetLocalForm(_x, &xg);
   CHECK_ERROR("VecGhostGetLocalForm");
 
-  // If ghosted, update
+  // If ghosted, start update
   if (xg)
   {
     ierr = VecGhostUpdateBegin(_x, INSERT_VALUES, SCATTER_FORWARD);
     CHECK_ERROR("VecGhostUpdateBegin");
+  }
+
+  ierr = VecGhostRestoreLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostRestoreLocalForm");
+}
+//-----------------------------------------------------------------------------
+void PETScVector::update_ghost_values_end()
+{
+  dolfin_assert(_x);
+  PetscErrorCode ierr;
+
+  // Check of vector is ghosted
+  Vec xg;
+  ierr = VecGhostGetLocalForm(_x, &xg);
+  CHECK_ERROR("VecGhostGetLocalForm");
+
+  #ifdef HAS_MPI
+  if (_ghost_scatter)
+  {
+    // Complete exchange, and write received values into ghost
+    // entries of local form
+    PetscScalar* x = nullptr;
+    if (xg)
+    {
+      ierr = VecGetArray(xg, &x);
+      CHECK_ERROR("VecGetArray");
+    }
+    dolfin_assert(x or _ghost_scatter->num_ghosts() == 0);
+    _ghost_scatter->update_end(x);
+    if (xg)
+    {
+      ierr = VecRestoreArray(xg, &x);
+      CHECK_ERROR("VecRestoreArray");
+    }
+  }
+  else
+  #endif
+  if (xg)
+  {
+    // If ghosted, complete update
     ierr = VecGhostUpdateEnd(_x, INSERT_VALUES, SCATTER_FORWARD);
     CHECK_ERROR("VecGhostUpdateEnd");
   }
@@ -867,6 +962,9 @@ void PETScVector::reset(Vec vec)
   ierr = VecDestroy(&_x);
   CHECK_ERROR("VecDestroy");
 
+  // Layout of new Vec may differ, so fall back to PETSc scatters
+  _ghost_scatter.reset();
+
   // Store new Vec object and increment reference count
   _x = vec;
   ierr = PetscObjectReference((PetscObject)_x);
@@ -905,6 +1003,7 @@ void PETScVector::_init(std::pair<std::size_t, std::size_t> range,
 
   // Add ghost points if Vec type is MPI (throw an error if Vec is not
   // VECMPI and ghost entry vector is not empty)
+  _ghost_scatter.reset();
   if (strcmp(vec_type, VECMPI) == 0)
   {
     ierr = VecMPISetGhost(_x, ghost_indices.size(), ghost_indices.data());
@@ -45,6 +45,7 @@
 namespace dolfin
 {
 
+  class GhostScatter;
   class SparsityPattern;
   template<typename T> class Array;
 
@@ -115,8 +116,12 @@ namespace dolfin
                       const std::vector<std::size_t>& local_to_global_map,
                       const std::vector<la_index>& ghost_indices);
 
-    // Bring init function from GenericVector into scope
-    using GenericVector::init;
+    /// Initialize vector with given layout. If the global parameter
+    /// "ghost_update_communication" is "neighbourhood", ghosted
+    /// vectors update their ghost entries with the neighbourhood
+    /// scatter of the layout's index map (see
+    /// IndexMap::ghost_scatter).
+    virtual void init(const TensorLayout& tensor_layout);
 
     /// Return true if vector is empty
     virtual bool empty() const;
@@ -237,6 +242,16 @@ namespace dolfin
     /// Update values shared from remote processes
     virtual void update_ghost_values();
 
+    /// Start update of values shared from remote processes. Owned
+    /// entries may be read, but not modified, until
+    /// update_ghost_values_end() is called, and ghost entries must
+    /// not be accessed. This function is collective.
+    void update_ghost_values_begin();
+
+    /// Complete update of values shared from remote processes started
+    /// by update_ghost_values_begin()
+    void update_ghost_values_end();
+
     //--- Special functions ---
 
     /// Return linear algebra backend factory
@@ -276,6 +291,10 @@ namespace dolfin
     // PETSc Vec pointer
     Vec _x;
 
+    // Neighbourhood scatter for ghost updates (null if the vector is
+    // not ghosted or if PETSc scatters are used)
+    std::unique_ptr<GhostScatter> _ghost_scatter;
+
     // PETSc norm types
     static const std::map<std::string, NormType> norm_types;
 
@@ -23,6 +23,11 @@
 // Last changed: 2014-11-26
 
 #include <algorithm>
+#include <numeric>
+
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
 
 #include <dolfin/common/MPI.h>
 #include <dolfin/log/LogStream.h>
@@ -33,7 +38,8 @@ using namespace dolfin;
 
 //-----------------------------------------------------------------------------
 SparsityPattern::SparsityPattern(MPI_Comm comm, std::size_t primary_dim)
-  : _primary_dim(primary_dim), _mpi_comm(comm)
+  : _primary_dim(primary_dim), _mpi_comm(comm), _block_size(1),
+    _buffers(1), _peak_memory_usage(0)
 {
   // Do nothing
 }
@@ -41,25 +47,41 @@ SparsityPattern::SparsityPattern(MPI_Comm comm, std::size_t primary_dim)
 SparsityPattern::SparsityPattern(MPI_Comm comm,
   const std::vector<std::shared_ptr<const IndexMap>> index_maps,
   std::size_t primary_dim)
-  : _primary_dim(primary_dim), _mpi_comm(comm)
+  : _primary_dim(primary_dim), _mpi_comm(comm), _block_size(1),
+    _buffers(1), _peak_memory_usage(0)
 {
   init(index_maps);
 }
 //-----------------------------------------------------------------------------
-void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> index_maps)
+void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> index_maps,
+                           std::size_t block_size)
 {
   // Only rank 2 sparsity patterns are supported
   dolfin_assert(index_maps.size() == 2);
 
   _index_maps = index_maps;
 
+  // Check block size
+  if (block_size == 0
+      || (block_size > 1
+          && ((std::size_t) index_maps[0]->block_size() != block_size
+              || (std::size_t) index_maps[1]->block_size() != block_size)))
+  {
+    dolfin_error("SparsityPattern.cpp",
+                 "initialize sparsity pattern",
+                 "Block size %d does not match block size of index maps",
+                 block_size);
+  }
+  _block_size = block_size;
+
   const std::size_t _primary_dim = primary_dim();
 
   // Clear sparsity pattern data
-  diagonal.clear();
-  off_diagonal.clear();
-  non_local.clear();
+  diagonal = CSR();
+  off_diagonal = CSR();
   full_rows.clear();
+  _buffers.assign(_buffers.size(), InsertBuffer());
+  _peak_memory_usage = 0;
 
   // Check that primary dimension is valid
   if (_primary_dim > 1)
@@ -79,14 +101,15 @@ void SparsityPattern::init(const std::vector<std::shared_ptr<const IndexMap>> in
     = index_maps[primary_codim]->size(IndexMap::MapSize::GLOBAL);
 
   // Resize diagonal block
-  diagonal.resize(local_size0);
+  dolfin_assert(local_size0 % _block_size == 0);
+  diagonal.offsets.assign(local_size0/_block_size + 1, 0);
 
   // Resize off-diagonal block (only needed when local range != global
   // range)
   if (global_size1 > local_size1)
   {
     dolfin_assert(_mpi_comm.size() > 1);
-    off_diagonal.resize(local_size0);
+    off_diagonal.offsets.assign(local_size0/_block_size + 1, 0);
   }
   else
   {
@@ -186,6 +209,18 @@ void SparsityPattern::insert_entries(
   const bool has_full_rows = full_rows.size() > 0;
   const auto full_rows_end = full_rows.end();
 
+  // Insertion buffer for this thread
+  InsertBuffer& _buffer = buffer();
+
+  // For blocked storage, insert the first entry of each block only
+  // and store block indices
+  const std::size_t bs = _block_size;
+  if (bs > 1)
+  {
+    condense(map_i, _buffer.block_indices0);
+    condense(map_j, _buffer.block_indices1);
+  }
+
   // Programmers' note:
   // We use the lower case index i/j to denote the indices before calls to
   // primary_dim_map/primary_codim_map.
@@ -202,9 +237,12 @@ void SparsityPattern::insert_entries(
     // Sequential mode, do simple insertion if not full row
     for (const auto &i_index : map_i)
     {
-      dolfin_assert(i_index < (dolfin::la_index) diagonal.size());
+      dolfin_assert(i_index/bs < diagonal.size());
       if (!has_full_rows || full_rows.find(i_index) == full_rows_end)
-        diagonal[i_index].insert(map_j.begin(), map_j.end());
+      {
+        for (const auto &j_index : map_j)
+          _buffer.diagonal.push_back({i_index/bs, j_index/bs});
+      }
     }
   }
   else
@@ -230,13 +268,13 @@ void SparsityPattern::insert_entries(
           if ((dolfin::la_index) local_range1.first <= J
               && J < (dolfin::la_index) local_range1.second)
           {
-            dolfin_assert(I < (dolfin::la_index) diagonal.size());
-            diagonal[I].insert(J);
+            dolfin_assert(I/bs < diagonal.size());
+            _buffer.diagonal.push_back({I/bs, J/bs});
           }
           else
           {
-            dolfin_assert(I < (dolfin::la_index) off_diagonal.size());
-            off_diagonal[I].insert(J);
+            dolfin_assert(I/bs < off_diagonal.size());
+            _buffer.off_diagonal.push_back({I/bs, J/bs});
           }
         }
       }
@@ -247,17 +285,131 @@ void SparsityPattern::insert_entries(
         {
           const auto J = primary_codim_map(j_index, index_map1);
           // Store indices
-          non_local.push_back(I);
-          non_local.push_back(J);
+          _buffer.non_local.push_back(I);
+          _buffer.non_local.push_back(J);
         }
       }
     }
   }
+
+  // Bound size of buffers by removing duplicate entries
+  compact(_buffer.diagonal, _buffer.diagonal_compaction_size);
+  compact(_buffer.off_diagonal, _buffer.off_diagonal_compaction_size);
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::insert_rows_local_global(
+  const std::vector<std::size_t>& offsets,
+  const std::vector<std::size_t>& columns)
+{
+  const std::size_t _primary_dim = primary_dim();
+  const std::size_t primary_codim = (_primary_dim + 1) % 2;
+  const auto local_range1 = _index_maps[primary_codim]->local_range();
+  dolfin_assert(!offsets.empty());
+  const std::size_t num_rows = offsets.size() - 1;
+  const std::size_t bs = _block_size;
+  dolfin_assert(num_rows <= diagonal.size()*bs);
+
+  // Entries can be stored directly if nothing has been inserted yet
+  // and the pattern is not blocked, otherwise they are inserted
+  // through the buffer of the calling thread
+  bool empty = diagonal.columns.empty() && off_diagonal.columns.empty();
+  for (const auto& b : _buffers)
+    empty = empty && b.diagonal.empty() && b.off_diagonal.empty();
+  if (!empty || full_rows.size() > 0 || bs > 1)
+  {
+    // For blocked storage, the rows of a block have the same pattern
+    // and only the first row of each block is inserted
+    InsertBuffer& _buffer = buffer();
+    for (std::size_t i = 0; i < num_rows; i += bs)
+    {
+      if (full_rows.find(i) != full_rows.end())
+        continue;
+      for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+      {
+        const std::size_t J = columns[k];
+        if (local_range1.first <= J && J < local_range1.second)
+          _buffer.diagonal.push_back({i/bs, J/bs});
+        else
+        {
+          dolfin_assert(off_diagonal.size() > 0);
+          _buffer.off_diagonal.push_back({i/bs, J/bs});
+        }
+      }
+    }
+
+    // Merge duplicate block entries
+    compact(_buffer.diagonal, _buffer.diagonal_compaction_size);
+    compact(_buffer.off_diagonal, _buffer.off_diagonal_compaction_size);
+    return;
+  }
+
+  // Count entries in diagonal and off-diagonal blocks
+  const std::size_t num_local_rows = diagonal.size();
+  std::vector<std::size_t> diagonal_offsets(num_local_rows + 1, 0);
+  std::vector<std::size_t> off_diagonal_offsets;
+  if (off_diagonal.size() > 0)
+    off_diagonal_offsets.assign(num_local_rows + 1, 0);
+  for (std::size_t i = 0; i < num_rows; ++i)
+  {
+    for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+    {
+      const std::size_t J = columns[k];
+      if (local_range1.first <= J && J < local_range1.second)
+        ++diagonal_offsets[i + 1];
+      else
+      {
+        dolfin_assert(!off_diagonal_offsets.empty());
+        ++off_diagonal_offsets[i + 1];
+      }
+    }
+  }
+  std::partial_sum(diagonal_offsets.begin(), diagonal_offsets.end(),
+                   diagonal_offsets.begin());
+  std::partial_sum(off_diagonal_offsets.begin(), off_diagonal_offsets.end(),
+                   off_diagonal_offsets.begin());
+
+  // Fill blocks and sort rows
+  diagonal.columns.resize(diagonal_offsets.back());
+  if (!off_diagonal_offsets.empty())
+    off_diagonal.columns.resize(off_diagonal_offsets.back());
+  for (std::size_t i = 0; i < num_rows; ++i)
+  {
+    std::size_t pos0 = diagonal_offsets[i];
+    std::size_t pos1 = off_diagonal_offsets.empty() ? 0
+      : off_diagonal_offsets[i];
+    for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+    {
+      const std::size_t J = columns[k];
+      if (local_range1.first <= J && J < local_range1.second)
+        diagonal.columns[pos0++] = J;
+      else
+        off_diagonal.columns[pos1++] = J;
+    }
+    std::sort(diagonal.columns.begin() + diagonal_offsets[i],
+              diagonal.columns.begin() + pos0);
+    if (!off_diagonal_offsets.empty())
+    {
+      std::sort(off_diagonal.columns.begin() + off_diagonal_offsets[i],
+                off_diagonal.columns.begin() + pos1);
+    }
+  }
+  diagonal.offsets.swap(diagonal_offsets);
+  if (!off_diagonal_offsets.empty())
+    off_diagonal.offsets.swap(off_diagonal_offsets);
+
+  _peak_memory_usage = std::max(_peak_memory_usage, memory_usage());
 }
 //-----------------------------------------------------------------------------
 void SparsityPattern::insert_full_rows_local(
   const std::vector<std::size_t>& rows)
 {
+  if (_block_size > 1 && !rows.empty())
+  {
+    dolfin_error("SparsityPattern.cpp",
+                 "insert full rows in sparsity pattern",
+                 "Full rows are not supported by blocked sparsity patterns");
+  }
+
   const std::size_t ghosted_size0 =
     _index_maps[_primary_dim]->size(IndexMap::MapSize::ALL);
   full_rows.set().reserve(rows.size());
@@ -268,6 +420,13 @@ void SparsityPattern::insert_full_rows_local(
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::set_num_threads(std::size_t num_threads)
+{
+  // Never remove buffers, which may hold entries
+  if (num_threads > _buffers.size())
+    _buffers.resize(num_threads);
+}
+//-----------------------------------------------------------------------------
 std::size_t SparsityPattern::rank() const
 {
   return 2;
@@ -285,10 +444,8 @@ std::size_t SparsityPattern::num_nonzeros() const
   std::size_t nz = 0;
 
   // Contribution from diagonal and off-diagonal
-  for (const auto& slice : diagonal)
-    nz += slice.size();
-  for (const auto& slice : off_diagonal)
-    nz += slice.size();
+  nz += diagonal.columns.size()*_block_size*_block_size;
+  nz += off_diagonal.columns.size()*_block_size*_block_size;
 
   // Contribution from full rows
   const std::size_t local_size0 =
@@ -308,8 +465,9 @@ void SparsityPattern::num_nonzeros_diagonal(std::vector<std::size_t>& num_nonzer
   num_nonzeros.resize(diagonal.size());
 
   // Get number of nonzeros per generalised row
-  for (auto slice = diagonal.begin(); slice != diagonal.end(); ++slice)
-    num_nonzeros[slice - diagonal.begin()] = slice->size();
+  for (std::size_t i = 0; i < diagonal.size(); ++i)
+    num_nonzeros[i] = diagonal.size(i);
+  expand(num_nonzeros);
 
   // Get number of nonzeros per full row
   if (full_rows.size() > 0)
@@ -330,12 +488,13 @@ void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_no
   num_nonzeros.resize(off_diagonal.size());
 
   // Return if there is no off-diagonal
-  if (off_diagonal.empty())
+  if (off_diagonal.size() == 0)
     return;
 
   // Compute number of nonzeros per generalised row
-  for (auto slice = off_diagonal.begin(); slice != off_diagonal.end(); ++slice)
-    num_nonzeros[slice - off_diagonal.begin()] = slice->size();
+  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
+    num_nonzeros[i] = off_diagonal.size(i);
+  expand(num_nonzeros);
 
   // Get number of nonzeros per full row
   if (full_rows.size() > 0)
@@ -355,7 +514,7 @@ void SparsityPattern::num_nonzeros_off_diagonal(std::vector<std::size_t>& num_no
 void SparsityPattern::num_local_nonzeros(std::vector<std::size_t>& num_nonzeros) const
 {
   num_nonzeros_diagonal(num_nonzeros);
-  if (!off_diagonal.empty())
+  if (off_diagonal.size() > 0)
   {
     std::vector<std::size_t> tmp;
     num_nonzeros_off_diagonal(tmp);
@@ -365,6 +524,45 @@ void SparsityPattern::num_local_nonzeros(std::vector<std::size_t>& num_nonzeros)
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::num_nonzeros_upper(
+  std::vector<std::size_t>& num_nonzeros_diagonal,
+  std::vector<std::size_t>& num_nonzeros_off_diagonal) const
+{
+  dolfin_assert(_primary_dim == 0);
+
+  // Start from full counts (used for full rows)
+  this->num_nonzeros_diagonal(num_nonzeros_diagonal);
+  this->num_nonzeros_off_diagonal(num_nonzeros_off_diagonal);
+
+  // Global (block) index of first local row
+  const std::size_t offset0 = _index_maps[0]->local_range().first/_block_size;
+
+  // Count (block) columns with global index not less than the row
+  // index
+  const std::size_t bs = _block_size;
+  for (std::size_t i = 0; i < diagonal.size(); ++i)
+  {
+    if (full_rows.find(i) != full_rows.end())
+      continue;
+
+    const std::size_t I = offset0 + i;
+    const auto upper = [I](const CSR& block, std::size_t i)
+      {
+        const auto row_end = block.columns.begin() + block.offsets[i + 1];
+        return (std::size_t) (row_end
+          - std::lower_bound(block.columns.begin() + block.offsets[i],
+                             row_end, I));
+      };
+
+    for (std::size_t c = 0; c < bs; ++c)
+    {
+      num_nonzeros_diagonal[bs*i + c] = bs*upper(diagonal, i);
+      if (off_diagonal.size() > 0)
+        num_nonzeros_off_diagonal[bs*i + c] = bs*upper(off_diagonal, i);
+    }
+  }
+}
+//-----------------------------------------------------------------------------
 void SparsityPattern::apply()
 {
   const std::size_t _primary_dim = primary_dim();
@@ -383,15 +581,14 @@ void SparsityPattern::apply()
   const std::size_t num_processes = _mpi_comm.size();
   const std::size_t proc_number = _mpi_comm.rank();
 
-  // Print some useful information
-  if (get_log_level() <= DBG)
-    info_statistics();
+  // Entries received from other processes are inserted through the
+  // first buffer
+  InsertBuffer& _buffer = _buffers[0];
 
   // Communicate non-local blocks if any
   if (_mpi_comm.size() > 1)
   {
     // Figure out correct process for each non-local entry
-    dolfin_assert(non_local.size() % 2 == 0);
     std::vector<std::vector<std::size_t>> non_local_send(num_processes);
 
     const std::vector<int>& off_process_owner
@@ -400,6 +597,12 @@ void SparsityPattern::apply()
     const std::vector<std::size_t>& local_to_global
       = _index_maps[_primary_dim]->local_to_global_unowned();
 
+    // Collect non-local entries from all insertion buffers
+    std::vector<std::size_t> non_local;
+    for (const auto& b : _buffers)
+      non_local.insert(non_local.end(), b.non_local.begin(), b.non_local.end());
+    dolfin_assert(non_local.size() % 2 == 0);
+
     std::size_t dim_block_size = _index_maps[_primary_dim]->block_size();
     for (std::size_t i = 0; i < non_local.size(); i += 2)
     {
@@ -460,46 +663,64 @@ void SparsityPattern::apply()
                      local_range0.second);
       }
 
-      // Get local I index
-      const std::size_t i_index = I - offset0;
+      // Get local I index (block index for blocked storage)
+      const std::size_t i_index = (I - offset0)/_block_size;
 
       // Insert in diagonal or off-diagonal block
       if (local_range1.first <= J &&
           J < local_range1.second)
       {
         dolfin_assert(i_index < diagonal.size());
-        diagonal[i_index].insert(J);
+        _buffer.diagonal.push_back({i_index, J/_block_size});
       }
       else
       {
         dolfin_assert(i_index < off_diagonal.size());
-        off_diagonal[i_index].insert(J);
+        _buffer.off_diagonal.push_back({i_index, J/_block_size});
       }
     }
   }
 
   // Clear non-local entries
-  non_local.clear();
+  for (auto& b : _buffers)
+    std::vector<std::size_t>().swap(b.non_local);
+
+  // Merge inserted entries into compressed row storage
+  merge(false);
+  if (off_diagonal.size() > 0)
+    merge(true);
+
+  log(TRACE, "Sparsity pattern has %d nonzeros, peak memory usage %.1f MB.",
+      num_nonzeros(), _peak_memory_usage/(1024.0*1024.0));
+
+  // Print some useful information
+  if (get_log_level() <= DBG)
+    info_statistics();
 }
 //-----------------------------------------------------------------------------
 std::string SparsityPattern::str(bool verbose) const
 {
-  // Print each row
+  // Print each row (block row for blocked storage)
   std::stringstream s;
   for (std::size_t i = 0; i < diagonal.size(); i++)
   {
+    if (_block_size > 1)
+      s << "Block ";
     if (primary_dim() == 0)
       s << "Row " << i << ":";
     else
       s << "Col " << i << ":";
 
-    for (const auto& entry : diagonal[i])
-      s << " " << entry;
+    for (std::size_t k = diagonal.offsets[i]; k < diagonal.offsets[i + 1]; ++k)
+      s << " " << diagonal.columns[k];
 
-    if (!off_diagonal.empty())
+    if (off_diagonal.size() > 0)
     {
-      for (const auto& entry : off_diagonal[i])
-        s << " " << entry;
+      for (std::size_t k = off_diagonal.offsets[i];
+           k < off_diagonal.offsets[i + 1]; ++k)
+      {
+        s << " " << off_diagonal.columns[k];
+      }
     }
 
     s << std::endl;
@@ -511,14 +732,17 @@ std::string SparsityPattern::str(bool verbose) const
 std::vector<std::vector<std::size_t>>
 SparsityPattern::diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t>> v(diagonal.size());
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), diagonal[i].begin(), diagonal[i].end());
-
-  if (type == Type::sorted)
+  // Rows are stored sorted, so the pattern is sorted for both types
+  const std::size_t bs = _block_size;
+  std::vector<std::vector<std::size_t>> v(diagonal.size()*bs);
+  for (std::size_t i = 0; i < v.size(); ++i)
   {
-    for (std::size_t i = 0; i < v.size(); ++i)
-      std::sort(v[i].begin(), v[i].end());
+    for (std::size_t k = diagonal.offsets[i/bs];
+         k < diagonal.offsets[i/bs + 1]; ++k)
+    {
+      for (std::size_t c = 0; c < bs; ++c)
+        v[i].push_back(bs*diagonal.columns[k] + c);
+    }
   }
 
   if (full_rows.size() > 0)
@@ -544,14 +768,17 @@ SparsityPattern::diagonal_pattern(Type type) const
 std::vector<std::vector<std::size_t>>
   SparsityPattern::off_diagonal_pattern(Type type) const
 {
-  std::vector<std::vector<std::size_t>> v(off_diagonal.size());
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    v[i].insert(v[i].begin(), off_diagonal[i].begin(), off_diagonal[i].end());
-
-  if (type == Type::sorted)
+  // Rows are stored sorted, so the pattern is sorted for both types
+  const std::size_t bs = _block_size;
+  std::vector<std::vector<std::size_t>> v(off_diagonal.size()*bs);
+  for (std::size_t i = 0; i < v.size(); ++i)
   {
-    for (std::size_t i = 0; i < v.size(); ++i)
-      std::sort(v[i].begin(), v[i].end());
+    for (std::size_t k = off_diagonal.offsets[i/bs];
+         k < off_diagonal.offsets[i/bs + 1]; ++k)
+    {
+      for (std::size_t c = 0; c < bs; ++c)
+        v[i].push_back(bs*off_diagonal.columns[k] + c);
+    }
   }
 
   if (full_rows.size() > 0)
@@ -580,17 +807,17 @@ std::vector<std::vector<std::size_t>>
 void SparsityPattern::info_statistics() const
 {
   // Count nonzeros in diagonal block
-  std::size_t num_nonzeros_diagonal = 0;
-  for (std::size_t i = 0; i < diagonal.size(); ++i)
-    num_nonzeros_diagonal += diagonal[i].size();
+  const std::size_t bs2 = _block_size*_block_size;
+  const std::size_t num_nonzeros_diagonal = diagonal.columns.size()*bs2;
 
   // Count nonzeros in off-diagonal block
-  std::size_t num_nonzeros_off_diagonal = 0;
-  for (std::size_t i = 0; i < off_diagonal.size(); ++i)
-    num_nonzeros_off_diagonal += off_diagonal[i].size();
+  const std::size_t num_nonzeros_off_diagonal
+    = off_diagonal.columns.size()*bs2;
 
   // Count nonzeros in non-local block
-  const std::size_t num_nonzeros_non_local = non_local.size()/2;
+  std::size_t num_nonzeros_non_local = 0;
+  for (const auto& b : _buffers)
+    num_nonzeros_non_local += b.non_local.size()/2;
 
   // Count total number of nonzeros
   const std::size_t num_nonzeros_total = num_nonzeros_diagonal
@@ -618,3 +845,146 @@ void SparsityPattern::info_statistics() const
   }
 }
 //-----------------------------------------------------------------------------
+void SparsityPattern::condense(ArrayView<const dolfin::la_index>& indices,
+                               std::vector<dolfin::la_index>& block_indices) const
+{
+  const dolfin::la_index bs = _block_size;
+  block_indices.resize(indices.size());
+  for (std::size_t k = 0; k < indices.size(); ++k)
+    block_indices[k] = indices[k] - indices[k] % bs;
+  std::sort(block_indices.begin(), block_indices.end());
+  block_indices.erase(std::unique(block_indices.begin(), block_indices.end()),
+                      block_indices.end());
+  indices.set(block_indices);
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::expand(std::vector<std::size_t>& num_nonzeros) const
+{
+  const std::size_t bs = _block_size;
+  if (bs == 1)
+    return;
+
+  std::vector<std::size_t> _num_nonzeros(bs*num_nonzeros.size());
+  for (std::size_t i = 0; i < _num_nonzeros.size(); ++i)
+    _num_nonzeros[i] = bs*num_nonzeros[i/bs];
+  num_nonzeros.swap(_num_nonzeros);
+}
+//-----------------------------------------------------------------------------
+SparsityPattern::InsertBuffer& SparsityPattern::buffer()
+{
+  #ifdef HAS_OPENMP
+  const std::size_t thread = omp_get_thread_num();
+  #else
+  const std::size_t thread = 0;
+  #endif
+  dolfin_assert(thread < _buffers.size());
+  return _buffers[thread];
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::compact(
+  std::vector<std::pair<std::size_t, std::size_t>>& pairs,
+  std::size_t& compaction_size)
+{
+  // Minimum number of buffered pairs before duplicates are removed
+  const std::size_t min_compaction_size = 1 << 20;
+  if (pairs.size() < std::max(compaction_size, min_compaction_size))
+    return;
+
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  // Compact again when the number of pairs has doubled
+  compaction_size = 2*pairs.size();
+}
+//-----------------------------------------------------------------------------
+void SparsityPattern::merge(bool off_diagonal_block)
+{
+  CSR& block = off_diagonal_block ? off_diagonal : diagonal;
+  const std::size_t num_rows = block.size();
+
+  // First pass: count entries in each row, including duplicates
+  std::vector<std::size_t> offsets(num_rows + 1, 0);
+  for (std::size_t i = 0; i < num_rows; ++i)
+    offsets[i + 1] = block.size(i);
+  for (const auto& b : _buffers)
+  {
+    for (const auto& entry : off_diagonal_block ? b.off_diagonal : b.diagonal)
+    {
+      dolfin_assert(entry.first < num_rows);
+      ++offsets[entry.first + 1];
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  // Second pass: copy stored and buffered entries into rows
+  std::vector<std::size_t> columns(offsets.back());
+  {
+    std::vector<std::size_t> position(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < num_rows; ++i)
+    {
+      for (std::size_t k = block.offsets[i]; k < block.offsets[i + 1]; ++k)
+        columns[position[i]++] = block.columns[k];
+    }
+    for (const auto& b : _buffers)
+    {
+      for (const auto& entry : off_diagonal_block ? b.off_diagonal : b.diagonal)
+        columns[position[entry.first]++] = entry.second;
+    }
+
+    // Memory peaks here, with old and new storage allocated
+    const std::size_t merge_memory
+      = (offsets.capacity() + columns.capacity() + position.capacity())
+      *sizeof(std::size_t);
+    _peak_memory_usage = std::max(_peak_memory_usage,
+                                  memory_usage() + merge_memory);
+  }
+
+  // Release buffers and old storage
+  for (auto& b : _buffers)
+  {
+    std::vector<std::pair<std::size_t, std::size_t>>().swap(
+      off_diagonal_block ? b.off_diagonal : b.diagonal);
+    if (off_diagonal_block)
+      b.off_diagonal_compaction_size = 0;
+    else
+      b.diagonal_compaction_size = 0;
+  }
+  std::vector<std::size_t>().swap(block.columns);
+
+  // Sort each row and remove duplicates, compacting the storage in
+  // place (rows only move towards the front)
+  std::size_t num_entries = 0;
+  for (std::size_t i = 0; i < num_rows; ++i)
+  {
+    const auto row_begin = columns.begin() + offsets[i];
+    const auto row_end = columns.begin() + offsets[i + 1];
+    std::sort(row_begin, row_end);
+    const auto unique_end = std::unique(row_begin, row_end);
+
+    offsets[i] = num_entries;
+    num_entries = std::copy(row_begin, unique_end,
+                            columns.begin() + num_entries) - columns.begin();
+  }
+  offsets[num_rows] = num_entries;
+  columns.resize(num_entries);
+  columns.shrink_to_fit();
+
+  block.offsets.swap(offsets);
+  block.columns.swap(columns);
+}
+//-----------------------------------------------------------------------------
+std::size_t SparsityPattern::memory_usage() const
+{
+  std::size_t bytes = (diagonal.offsets.capacity()
+                       + diagonal.columns.capacity()
+                       + off_diagonal.offsets.capacity()
+                       + off_diagonal.columns.capacity())*sizeof(std::size_t);
+  for (const auto& b : _buffers)
+  {
+    bytes += (b.diagonal.capacity() + b.off_diagonal.capacity())
+      *sizeof(std::pair<std::size_t, std::size_t>);
+    bytes += b.non_local.capacity()*sizeof(std::size_t);
+  }
+  return bytes;
+}
+//-----------------------------------------------------------------------------
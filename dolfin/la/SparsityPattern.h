@@ -41,6 +41,20 @@ namespace dolfin
 
   /// This class implements a sparsity pattern data structure.  It is
   /// used by most linear algebra backends.
+  ///
+  /// Inserted entries are collected as (row, column) pairs in
+  /// insertion buffers, one per thread, and are sorted and merged
+  /// into compressed row storage when apply() is called. The
+  /// sparsity pattern must therefore be finalised with apply()
+  /// before it is queried.
+  ///
+  /// The pattern may be stored in blocks of size block_size x
+  /// block_size (see init()), e.g. for vector-valued Lagrange spaces
+  /// where all components of a node couple to the same nodes. An
+  /// inserted entry then marks the whole block that contains it as
+  /// nonzero, and only one index is stored per block. The functions
+  /// that query the pattern return the entries of the expanded
+  /// (scalar) pattern.
 
   class SparsityPattern
   {
@@ -63,8 +77,13 @@ namespace dolfin
                     std::vector<std::shared_ptr<const IndexMap>> index_maps,
                     std::size_t primary_dim);
 
-    /// Initialize sparsity pattern for a generic tensor
-    void init(std::vector<std::shared_ptr<const IndexMap>> index_maps);
+    /// Initialize sparsity pattern for a generic tensor. If
+    /// block_size is larger than one, the pattern is stored in blocks
+    /// of size block_size x block_size. The block size must then
+    /// equal the block size of the index maps, and no full rows may
+    /// be inserted.
+    void init(std::vector<std::shared_ptr<const IndexMap>> index_maps,
+              std::size_t block_size=1);
 
     /// Insert a global entry - will be fixed by apply()
     void insert_global(dolfin::la_index i, dolfin::la_index j);
@@ -82,12 +101,27 @@ namespace dolfin
     void insert_local_global(
         const std::vector<ArrayView<const dolfin::la_index>>& entries);
 
+    /// Insert rows (or columns, according to primary dimension) in
+    /// compressed row storage. Entries of row i, using local
+    /// (process-wise) indices for the primary dimension, have global
+    /// indices columns[offsets[i]] to columns[offsets[i + 1]] for
+    /// the co-dimension. Only owned rows may be inserted, and
+    /// columns must be unique within each row.
+    void insert_rows_local_global(const std::vector<std::size_t>& offsets,
+                                  const std::vector<std::size_t>& columns);
+
     /// Insert full rows (or columns, according to primary dimension)
     /// using local (process-wise) indices. This must be called before
-    /// any other sparse insertion occurs to avoid quadratic
-    /// complexity of dense rows insertion
+    /// any other sparse insertion occurs to avoid storing the
+    /// entries of dense rows
     void insert_full_rows_local(const std::vector<std::size_t>& rows);
 
+    /// Set number of threads that may insert entries concurrently.
+    /// Thread i inserts into insertion buffer i, so the insertion
+    /// functions may be called from within an OpenMP parallel region
+    /// with at most num_threads threads.
+    void set_num_threads(std::size_t num_threads);
+
     /// Return rank
     std::size_t rank() const;
 
@@ -96,6 +130,11 @@ namespace dolfin
     std::size_t primary_dim() const
     { return _primary_dim; }
 
+    /// Return block size of the pattern storage (1 if the pattern is
+    /// stored per entry)
+    std::size_t block_size() const
+    { return _block_size; }
+
     /// Return local range for dimension dim
     std::pair<std::size_t, std::size_t> local_range(std::size_t dim) const;
 
@@ -119,9 +158,24 @@ namespace dolfin
     /// dimension 0
     void num_local_nonzeros(std::vector<std::size_t>& num_nonzeros) const;
 
-    /// Finalize sparsity pattern
+    /// Fill arrays with number of nonzeros per local row in the upper
+    /// triangular part (including the diagonal) of the diagonal and
+    /// off-diagonal blocks, as needed by symmetric matrix
+    /// storage. For a blocked pattern, the diagonal blocks of the
+    /// pattern are counted as upper triangular. Full rows are counted
+    /// in full.
+    void num_nonzeros_upper(std::vector<std::size_t>& num_nonzeros_diagonal,
+                            std::vector<std::size_t>& num_nonzeros_off_diagonal) const;
+
+    /// Finalize sparsity pattern (communicate off-process entries
+    /// and merge inserted entries into compressed row storage)
     void apply();
 
+    /// Return peak memory (in bytes) used by the sparsity pattern
+    /// storage and insertion buffers
+    std::size_t peak_memory_usage() const
+    { return _peak_memory_usage; }
+
     /// Return MPI communicator
     MPI_Comm mpi_comm() const
     { return _mpi_comm.comm(); }
@@ -153,6 +207,66 @@ namespace dolfin
     // Print some useful information
     void info_statistics() const;
 
+    // Replace indices by the sorted, unique first indices of the
+    // blocks that contain them (blocked storage)
+    void condense(ArrayView<const dolfin::la_index>& indices,
+                  std::vector<dolfin::la_index>& block_indices) const;
+
+    // Expand number of nonzeros per block row to number of nonzeros
+    // per row
+    void expand(std::vector<std::size_t>& num_nonzeros) const;
+
+    // Compressed row storage for a block of the sparsity pattern.
+    // The columns of row i are stored in columns[offsets[i]] to
+    // columns[offsets[i + 1]], sorted in increasing order.
+    struct CSR
+    {
+      std::vector<std::size_t> offsets;
+      std::vector<std::size_t> columns;
+
+      // Number of rows
+      std::size_t size() const
+      { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+      // Number of entries in row i
+      std::size_t size(std::size_t i) const
+      { return offsets[i + 1] - offsets[i]; }
+    };
+
+    // Buffer for entries inserted by one thread since the last
+    // call to apply()
+    struct InsertBuffer
+    {
+      // (row, column) pairs for diagonal and off-diagonal blocks
+      std::vector<std::pair<std::size_t, std::size_t>> diagonal;
+      std::vector<std::pair<std::size_t, std::size_t>> off_diagonal;
+
+      // Non-local entries stored as [i0, j0, i1, j1, ...]
+      std::vector<std::size_t> non_local;
+
+      // Work arrays for block indices (blocked storage)
+      std::vector<dolfin::la_index> block_indices0, block_indices1;
+
+      // Sizes at which the buffered pairs are next sorted and
+      // duplicates removed, to bound the buffer size
+      std::size_t diagonal_compaction_size;
+      std::size_t off_diagonal_compaction_size;
+    };
+
+    // Return insertion buffer of the calling thread
+    InsertBuffer& buffer();
+
+    // Sort pairs and remove duplicates if the buffer is large
+    static void compact(std::vector<std::pair<std::size_t, std::size_t>>& pairs,
+                        std::size_t& compaction_size);
+
+    // Merge buffered pairs for the diagonal (or off-diagonal) block
+    // into its compressed row storage
+    void merge(bool off_diagonal_block);
+
+    // Memory (bytes) currently used by storage and buffers
+    std::size_t memory_usage() const;
+
     // Primary sparsity pattern storage dimension (e.g., 0=row
     // partition, 1=column partition)
     const std::size_t _primary_dim;
@@ -163,19 +277,26 @@ namespace dolfin
     // IndexMaps for each dimension
     std::vector<std::shared_ptr<const IndexMap>> _index_maps;
 
-    // Sparsity patterns for diagonal and off-diagonal blocks
-    std::vector<set_type> diagonal;
-    std::vector<set_type> off_diagonal;
+    // Block size of storage. Rows and columns of the compressed row
+    // storage are block indices if larger than one.
+    std::size_t _block_size;
+
+    // Sparsity patterns for diagonal and off-diagonal blocks of the
+    // matrix. The off-diagonal block is empty if the local range is
+    // the global range.
+    CSR diagonal;
+    CSR off_diagonal;
 
     // List of full rows (or columns, according to primary dimension).
-    // Full rows are kept separately to circumvent quadratic scaling
-    // (caused by linear insertion time into dolfin::Set; std::set has
-    // logarithmic insertion, which would result in N log(N) overall
-    // complexity for dense rows)
+    // Full rows are kept separately to avoid storing the entries of
+    // dense rows
     set_type full_rows;
 
-    // Sparsity pattern for non-local entries stored as [i0, j0, i1, j1, ...]
-    std::vector<std::size_t> non_local;
+    // Insertion buffers, one per thread
+    std::vector<InsertBuffer> _buffers;
+
+    // Peak memory used by storage and buffers
+    std::size_t _peak_memory_usage;
 
   };
 
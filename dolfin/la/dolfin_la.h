@@ -45,6 +45,7 @@
 #include <dolfin/la/SparsityPattern.h>
 
 #include <dolfin/la/IndexMap.h>
+#include <dolfin/la/GhostScatter.h>
 
 #include <dolfin/la/GenericLinearAlgebraFactory.h>
 #include <dolfin/la/DefaultFactory.h>
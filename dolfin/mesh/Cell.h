@@ -298,7 +298,13 @@ namespace dolfin
       const std::size_t num_vertices = this->num_vertices();
       const unsigned int* vertices = this->entities(0);
 
-      if (geom_degree == 1)
+      if (geom.has_packed_coordinate_dofs())
+      {
+        const ArrayView<const double> x
+          = geom.packed_coordinate_dofs(index());
+        coordinates.assign(x.begin(), x.end());
+      }
+      else if (geom_degree == 1)
       {
         coordinates.resize(num_vertices*gdim);
         for (std::size_t i = 0; i < num_vertices; ++i)
@@ -334,6 +340,23 @@ namespace dolfin
 
     }
 
+    /// Get cell coordinate dofs without copying, if possible. If the
+    /// mesh geometry has packed coordinate dofs (see
+    /// MeshGeometry::init_packed_coordinate_dofs), a view into the
+    /// packed array is returned. Otherwise the coordinate dofs are
+    /// copied into coordinates, and a view of coordinates is
+    /// returned.
+    ArrayView<const double>
+      coordinate_dofs(std::vector<double>& coordinates) const
+    {
+      const MeshGeometry& geom = _mesh->geometry();
+      if (geom.has_packed_coordinate_dofs())
+        return geom.packed_coordinate_dofs(index());
+
+      get_coordinate_dofs(coordinates);
+      return ArrayView<const double>(coordinates.size(), coordinates.data());
+    }
+
     // FIXME: This function is part of a UFC transition
     /// Get cell vertex coordinates (not coordinate dofs)
     void get_vertex_coordinates(std::vector<double>& coordinates) const
@@ -254,6 +254,9 @@ void Mesh::order()
 
   // Clear any cell_orientations (as these depend on the ordering)
   _cell_orientations.clear();
+
+  // Clear packed coordinate dofs (these depend on the ordering)
+  _geometry.clear_packed_coordinate_dofs();
 }
 //-----------------------------------------------------------------------------
 bool Mesh::ordered() const
@@ -273,6 +276,11 @@ dolfin::Mesh Mesh::renumber_by_color() const
   return MeshRenumbering::renumber_by_color(*this, coloring_type);
 }
 //-----------------------------------------------------------------------------
+dolfin::Mesh Mesh::renumber_by_hilbert_curve() const
+{
+  return MeshRenumbering::renumber_by_hilbert_curve(*this);
+}
+//-----------------------------------------------------------------------------
 void Mesh::scale(double factor)
 {
   MeshTransformation::scale(*this, factor);
@@ -177,7 +177,9 @@ namespace dolfin
     std::size_t num_entities(std::size_t d) const
     { return _topology.size(d); }
 
-    /// Get vertex coordinates.
+    /// Get vertex coordinates. If the coordinates are modified
+    /// in-place, MeshGeometry::mark_modified() must be called
+    /// afterwards.
     ///
     /// @return std::vector<double>&
     ///         Coordinates of all vertices.
@@ -336,6 +338,12 @@ namespace dolfin
     /// @return Mesh
     Mesh renumber_by_color() const;
 
+    /// Renumber cells and vertices along a Hilbert space-filling
+    /// curve to improve locality (see
+    /// MeshRenumbering::renumber_by_hilbert_curve).
+    /// @return Mesh
+    Mesh renumber_by_hilbert_curve() const;
+
     /// Scale mesh coordinates with given factor.
     ///
     /// *Arguments*
@@ -125,6 +125,37 @@ void MeshConnectivity::set(std::size_t entity, std::size_t* connections)
             _connections.begin() + index_to_position[entity]);
 }
 //-----------------------------------------------------------------------------
+void MeshConnectivity::set(std::vector<unsigned int>&& connections,
+                           std::size_t num_connections)
+{
+  dolfin_assert(num_connections > 0);
+  dolfin_assert(connections.size() % num_connections == 0);
+
+  // Clear old data if any
+  clear();
+
+  // Initialize offsets
+  const std::size_t num_entities = connections.size()/num_connections;
+  index_to_position.resize(num_entities + 1);
+  for (std::size_t e = 0; e < index_to_position.size(); e++)
+    index_to_position[e] = e*num_connections;
+
+  _connections = std::move(connections);
+}
+//-----------------------------------------------------------------------------
+void MeshConnectivity::set(std::vector<unsigned int>&& connections,
+                           std::vector<unsigned int>&& offsets)
+{
+  dolfin_assert(!offsets.empty());
+  dolfin_assert(offsets.back() == connections.size());
+
+  // Clear old data if any
+  clear();
+
+  index_to_position = std::move(offsets);
+  _connections = std::move(connections);
+}
+//-----------------------------------------------------------------------------
 std::size_t MeshConnectivity::hash() const
 {
   // Compute local hash key
@@ -148,6 +148,19 @@ namespace dolfin
       _connections.shrink_to_fit();
     }
 
+    /// Set all connections for all entities from a flattened array
+    /// with num_connections connections for each entity. The array
+    /// is moved into the connectivity.
+    void set(std::vector<unsigned int>&& connections,
+             std::size_t num_connections);
+
+    /// Set all connections for all entities from a flattened array
+    /// in compressed row format, where the connections of entity e
+    /// are connections[offsets[e]], ..., connections[offsets[e + 1]
+    /// - 1]. The arrays are moved into the connectivity.
+    void set(std::vector<unsigned int>&& connections,
+             std::vector<unsigned int>&& offsets);
+
     /// Set global number of connections for all local entities
     void
       set_global_size(const std::vector<unsigned int>& num_global_connections)
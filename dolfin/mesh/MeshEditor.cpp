@@ -269,6 +269,9 @@ void MeshEditor::close(bool order)
   if (order && !_mesh->ordered())
     _mesh->order();
 
+  // Cells have been added since the topology was initialised
+  _mesh->_topology.mark_modified();
+
   // Clear data
   clear();
 }
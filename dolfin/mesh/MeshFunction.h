@@ -28,7 +28,6 @@
 #include <vector>
 
 #include <memory>
-#include <unordered_set>
 #include <dolfin/common/Hierarchical.h>
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/NoDeleter.h>
@@ -448,11 +447,11 @@ namespace dolfin
     set_all(std::numeric_limits<T>::max());
 
     // Iterate over all values
-    std::unordered_set<std::size_t> entities_values_set;
-    typename std::map<std::pair<std::size_t, std::size_t>, T>::const_iterator it;
-    const std::map<std::pair<std::size_t, std::size_t>, T>& values
-      = mesh_value_collection.values();
-    for (it = values.begin(); it != values.end(); ++it)
+    std::vector<bool> entity_is_set(_size, false);
+    std::size_t num_entities_set = 0;
+    const std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>&
+      values = mesh_value_collection.values();
+    for (auto it = values.begin(); it != values.end(); ++it)
     {
       // Get value collection entry data
       const std::size_t cell_index = it->first.first;
@@ -476,12 +475,16 @@ namespace dolfin
       dolfin_assert(entity_index < _size);
       _values[entity_index] = value;
 
-      // Add entity index to set (used to check that all values are set)
-      entities_values_set.insert(entity_index);
+      // Count entities set (used to check that all values are set)
+      if (!entity_is_set[entity_index])
+      {
+        entity_is_set[entity_index] = true;
+        ++num_entities_set;
+      }
     }
 
     // Check that all values have been set, if not issue a debug message
-    if (entities_values_set.size() != _size)
+    if (num_entities_set != _size)
       dolfin_debug("Mesh value collection does not contain all values for all entities");
 
     return *this;
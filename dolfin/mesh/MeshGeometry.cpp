@@ -26,16 +26,21 @@
 
 #include <dolfin/log/log.h>
 #include "MeshGeometry.h"
+#include "MeshTopology.h"
 
 using namespace dolfin;
 
 //-----------------------------------------------------------------------------
-MeshGeometry::MeshGeometry() : _dim(0), _degree(1)
+MeshGeometry::MeshGeometry() : _dim(0), _degree(1), _packed_cell_size(0),
+                               _packed_modification_count(0),
+                               _modification_count(0)
 {
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-MeshGeometry::MeshGeometry(const MeshGeometry& geometry) : _dim(0)
+MeshGeometry::MeshGeometry(const MeshGeometry& geometry)
+  : _dim(0), _packed_cell_size(0), _packed_modification_count(0),
+    _modification_count(0)
 {
   *this = geometry;
 }
@@ -53,6 +58,17 @@ const MeshGeometry& MeshGeometry::operator= (const MeshGeometry& geometry)
   // Copy remaining data
   coordinates = geometry.coordinates;
   entity_offsets = geometry.entity_offsets;
+  ++_modification_count;
+
+  // Copy packed coordinate dofs if valid
+  if (geometry.has_packed_coordinate_dofs())
+  {
+    _packed_coordinate_dofs = geometry._packed_coordinate_dofs;
+    _packed_cell_size = geometry._packed_cell_size;
+    _packed_modification_count = _modification_count;
+  }
+  else
+    clear_packed_coordinate_dofs();
 
   return *this;
 }
@@ -110,12 +126,54 @@ void MeshGeometry::init_entities(const std::vector<std::size_t>& num_entities)
     }
   }
   coordinates.resize(_dim*offset);
+  ++_modification_count;
 }
 //-----------------------------------------------------------------------------
 void MeshGeometry::set(std::size_t local_index,
                        const double* x)
 {
   std::copy(x, x +_dim, coordinates.begin() + local_index*_dim);
+  ++_modification_count;
+}
+//-----------------------------------------------------------------------------
+void MeshGeometry::init_packed_coordinate_dofs(const MeshTopology& topology)
+{
+  if (_degree != 1)
+  {
+    dolfin_error("MeshGeometry.cpp",
+                 "pack coordinate dofs",
+                 "Packed coordinate dofs are only supported for affine (degree 1) geometry");
+  }
+
+  const std::size_t tdim = topology.dim();
+  const MeshConnectivity& cell_vertices = topology(tdim, 0);
+  if (cell_vertices.empty())
+  {
+    dolfin_error("MeshGeometry.cpp",
+                 "pack coordinate dofs",
+                 "Cell-vertex connectivity has not been computed");
+  }
+
+  // Number of vertices per cell (the same for all cells)
+  const std::size_t num_cells = topology.size(tdim);
+  const std::size_t num_cell_vertices = cell_vertices.size(0);
+  const std::vector<unsigned int>& vertices = cell_vertices();
+
+  // Copy vertex coordinates cell by cell
+  std::vector<double> packed(num_cells*num_cell_vertices*_dim);
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+  {
+    std::copy(coordinates.begin() + vertices[i]*_dim,
+              coordinates.begin() + (vertices[i] + 1)*_dim,
+              packed.begin() + i*_dim);
+  }
+
+  _packed_coordinate_dofs.swap(packed);
+  _packed_cell_size = num_cell_vertices*_dim;
+  _packed_modification_count = _modification_count;
+
+  log(TRACE, "Packed coordinate dofs of %d cells (%g MB).", num_cells,
+      packed_coordinate_dofs_memory()/1.0e6);
 }
 //-----------------------------------------------------------------------------
 std::size_t MeshGeometry::hash() const
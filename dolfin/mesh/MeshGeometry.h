@@ -25,12 +25,14 @@
 
 #include <string>
 #include <vector>
+#include <dolfin/common/ArrayView.h>
 #include <dolfin/geometry/Point.h>
 #include <dolfin/log/log.h>
 
 namespace dolfin
 {
   class Function;
+  class MeshTopology;
 
   /// MeshGeometry stores the geometry imposed on a mesh.
 
@@ -110,7 +112,9 @@ namespace dolfin
       return &coordinates[n*_dim];
     }
 
-    /// Return array of values for all coordinates
+    /// Return array of values for all coordinates. If the
+    /// coordinates are modified through the returned array,
+    /// mark_modified() must be called afterwards.
     std::vector<double>& x()
     { return coordinates; }
 
@@ -163,6 +167,59 @@ namespace dolfin
     /// Set value of coordinate
     void set(std::size_t local_index, const double* x);
 
+    /// Build a cell-major copy of the coordinate dofs of all cells
+    /// (affine geometry only), so that the coordinate dofs of a cell
+    /// can be accessed without gathering them from the vertex
+    /// coordinates. The packed array is valid until the modification
+    /// count changes, and must then be rebuilt. See
+    /// packed_coordinate_dofs_memory() for the memory used.
+    ///
+    /// *Arguments*
+    ///     topology (_MeshTopology_)
+    ///         Topology of the mesh (cell-vertex connectivity must
+    ///         have been computed)
+    void init_packed_coordinate_dofs(const MeshTopology& topology);
+
+    /// Clear packed coordinate dofs
+    void clear_packed_coordinate_dofs()
+    {
+      std::vector<double>().swap(_packed_coordinate_dofs);
+      _packed_cell_size = 0;
+    }
+
+    /// Return true if packed coordinate dofs are available and the
+    /// coordinates have not been modified since they were built
+    bool has_packed_coordinate_dofs() const
+    {
+      return _packed_cell_size > 0
+        && _packed_modification_count == _modification_count;
+    }
+
+    /// Return packed coordinate dofs of cell with given local index
+    ArrayView<const double> packed_coordinate_dofs(std::size_t cell_index) const
+    {
+      dolfin_assert((cell_index + 1)*_packed_cell_size
+                    <= _packed_coordinate_dofs.size());
+      return ArrayView<const double>(_packed_cell_size,
+                                     &_packed_coordinate_dofs[cell_index*_packed_cell_size]);
+    }
+
+    /// Return memory used by packed coordinate dofs (in bytes)
+    std::size_t packed_coordinate_dofs_memory() const
+    { return _packed_coordinate_dofs.capacity()*sizeof(double); }
+
+    /// Return counter that is incremented whenever the coordinates
+    /// are modified (by set(), init_entities(), assignment and
+    /// mark_modified()). Data computed from the coordinates can
+    /// store the counter and compare it to detect mesh motion.
+    std::size_t modification_count() const
+    { return _modification_count; }
+
+    /// Increment the modification count. Must be called after
+    /// modifying the coordinates in-place through x().
+    void mark_modified()
+    { ++_modification_count; }
+
     /// Hash of coordinate values
     ///
     /// *Returns*
@@ -188,6 +245,16 @@ namespace dolfin
     // Coordinates for all points stored as a contiguous array
     std::vector<double> coordinates;
 
+    // Coordinate dofs stored cell by cell (optional), number of
+    // values per cell (zero if not built) and modification count
+    // when built
+    std::vector<double> _packed_coordinate_dofs;
+    std::size_t _packed_cell_size;
+    std::size_t _packed_modification_count;
+
+    // Incremented when the coordinates are modified
+    std::size_t _modification_count;
+
   };
 
 }
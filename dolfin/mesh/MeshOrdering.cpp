@@ -49,6 +49,9 @@ void MeshOrdering::order(Mesh& mesh)
   // Iterate over all cells and order the mesh entities locally
   for (CellIterator cell(mesh, "all"); !cell.end(); ++cell)
     cell->order(local_to_global_vertex_indices);
+
+  // Connectivity has been reordered in-place
+  mesh.topology().mark_modified();
 }
 //-----------------------------------------------------------------------------
 bool MeshOrdering::ordered(const Mesh& mesh)
@@ -49,6 +49,7 @@
 #include "MeshEntity.h"
 #include "MeshEntityIterator.h"
 #include "MeshFunction.h"
+#include "MeshRenumbering.h"
 #include "MeshTopology.h"
 #include "MeshValueCollection.h"
 #include "Vertex.h"
@@ -89,6 +90,11 @@ void MeshPartitioning::build_distributed_mesh(Mesh& mesh)
     // Build distributed mesh
     build_distributed_mesh(mesh, local_mesh_data, parameters["ghost_mode"]);
   }
+  else if (parameters["reorder_mesh_hilbert"])
+  {
+    // Serial meshes are not redistributed, so renumber directly
+    mesh = MeshRenumbering::renumber_by_hilbert_curve(mesh);
+  }
 }
 //-----------------------------------------------------------------------------
 void MeshPartitioning::build_distributed_mesh(Mesh& mesh,
@@ -106,6 +112,11 @@ void MeshPartitioning::build_distributed_mesh(Mesh& mesh,
     // Build distributed mesh
     build_distributed_mesh(mesh, local_mesh_data, ghost_mode);
   }
+  else if (parameters["reorder_mesh_hilbert"])
+  {
+    // Serial meshes are not redistributed, so renumber directly
+    mesh = MeshRenumbering::renumber_by_hilbert_curve(mesh);
+  }
 }
 //-----------------------------------------------------------------------------
 void MeshPartitioning::build_distributed_mesh(Mesh& mesh,
@@ -326,6 +337,15 @@ void MeshPartitioning::build(Mesh& mesh, const LocalMeshData& mesh_data,
                       vertex_coordinates, vertex_global_to_local,
                       shared_vertices);
 
+  if (parameters["reorder_mesh_hilbert"])
+  {
+    reorder_hilbert(num_regular_cells, num_regular_vertices,
+                    new_cell_vertices, new_global_cell_indices,
+                    new_cell_partition, shared_cells, vertex_indices,
+                    vertex_global_to_local, vertex_coordinates,
+                    shared_vertices);
+  }
+
   timer.stop();
 
   // Build lcoal mesh from new_mesh_data
@@ -498,6 +518,119 @@ MeshPartitioning::reorder_vertices_gps(MPI_Comm mpi_comm,
     reordered_vertex_indices[i] = vertex_indices[i];
 }
 //-----------------------------------------------------------------------------
+void MeshPartitioning::reorder_hilbert(
+  const std::int32_t num_regular_cells,
+  const std::int32_t num_regular_vertices,
+  boost::multi_array<std::int64_t, 2>& cell_vertices,
+  std::vector<std::int64_t>& global_cell_indices,
+  std::vector<int>& cell_partition,
+  std::map<std::int32_t, std::set<unsigned int>>& shared_cells,
+  std::vector<std::int64_t>& vertex_indices,
+  std::map<std::int64_t, std::int32_t>& vertex_global_to_local,
+  boost::multi_array<double, 2>& vertex_coordinates,
+  std::map<std::int32_t, std::set<unsigned int>>& shared_vertices)
+{
+  log(PROGRESS, "Re-order cells and vertices along Hilbert curve");
+  Timer timer("Reorder mesh along Hilbert curve");
+
+  const std::size_t num_cell_vertices = cell_vertices.shape()[1];
+  const std::size_t gdim = vertex_coordinates.shape()[1];
+
+  // Local vertex indices of regular cells
+  std::vector<std::int32_t> local_cell_vertices(num_regular_cells
+                                                *num_cell_vertices);
+  for (std::int32_t c = 0; c < num_regular_cells; ++c)
+  {
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+    {
+      auto v = vertex_global_to_local.find(cell_vertices[c][i]);
+      dolfin_assert(v != vertex_global_to_local.end());
+      local_cell_vertices[c*num_cell_vertices + i] = v->second;
+    }
+  }
+
+  // Compute midpoints of regular cells and their order along the
+  // curve
+  std::vector<double> midpoints(num_regular_cells*gdim, 0.0);
+  for (std::int32_t c = 0; c < num_regular_cells; ++c)
+  {
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+    {
+      const std::int32_t v = local_cell_vertices[c*num_cell_vertices + i];
+      for (std::size_t j = 0; j < gdim; ++j)
+        midpoints[c*gdim + j] += vertex_coordinates[v][j];
+    }
+    for (std::size_t j = 0; j < gdim; ++j)
+      midpoints[c*gdim + j] /= num_cell_vertices;
+  }
+  const std::vector<std::size_t> cell_order
+    = MeshRenumbering::compute_hilbert_order(midpoints, gdim);
+
+  // Number regular vertices by first appearance in reordered cells,
+  // followed by regular vertices that only appear in ghost cells
+  std::vector<std::int32_t> vertex_remap(vertex_indices.size(), -1);
+  std::int32_t counter = 0;
+  for (auto c : cell_order)
+  {
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+    {
+      const std::int32_t v = local_cell_vertices[c*num_cell_vertices + i];
+      if (v < num_regular_vertices and vertex_remap[v] == -1)
+        vertex_remap[v] = counter++;
+    }
+  }
+  for (std::int32_t v = 0; v < num_regular_vertices; ++v)
+  {
+    if (vertex_remap[v] == -1)
+      vertex_remap[v] = counter++;
+  }
+  dolfin_assert(counter == num_regular_vertices);
+  for (std::size_t v = num_regular_vertices; v < vertex_remap.size(); ++v)
+    vertex_remap[v] = v;
+
+  // Reorder regular cells
+  const boost::multi_array<std::int64_t, 2> old_cell_vertices = cell_vertices;
+  const std::vector<std::int64_t> old_global_cell_indices = global_cell_indices;
+  const std::vector<int> old_cell_partition = cell_partition;
+  std::vector<std::int32_t> cell_remap(num_regular_cells);
+  for (std::int32_t i = 0; i < num_regular_cells; ++i)
+  {
+    const std::size_t c = cell_order[i];
+    cell_remap[c] = i;
+    cell_vertices[i] = old_cell_vertices[c];
+    global_cell_indices[i] = old_global_cell_indices[c];
+    cell_partition[i] = old_cell_partition[c];
+  }
+
+  std::map<std::int32_t, std::set<unsigned int>> reordered_shared_cells;
+  for (auto& p : shared_cells)
+  {
+    const std::int32_t c = p.first;
+    if (c < num_regular_cells)
+      reordered_shared_cells.insert({cell_remap[c], p.second});
+    else
+      reordered_shared_cells.insert(p);
+  }
+  std::swap(shared_cells, reordered_shared_cells);
+
+  // Reorder vertices
+  const std::vector<std::int64_t> old_vertex_indices = vertex_indices;
+  const boost::multi_array<double, 2> old_vertex_coordinates
+    = vertex_coordinates;
+  for (std::size_t v = 0; v < vertex_remap.size(); ++v)
+  {
+    vertex_indices[vertex_remap[v]] = old_vertex_indices[v];
+    vertex_coordinates[vertex_remap[v]] = old_vertex_coordinates[v];
+  }
+  for (auto& p : vertex_global_to_local)
+    p.second = vertex_remap[p.second];
+
+  std::map<std::int32_t, std::set<unsigned int>> reordered_shared_vertices;
+  for (auto& p : shared_vertices)
+    reordered_shared_vertices.insert({vertex_remap[p.first], p.second});
+  std::swap(shared_vertices, reordered_shared_vertices);
+}
+//-----------------------------------------------------------------------------
 void MeshPartitioning::distribute_cell_layer(MPI_Comm mpi_comm,
   const int num_regular_cells,
   const std::int64_t num_global_vertices,
@@ -1187,8 +1320,8 @@ void MeshPartitioning::build_mesh_domains(Mesh& mesh,
     }
 
     // Get data from mesh value collection
-    const std::map<std::pair<std::size_t, std::size_t>, std::size_t>& values
-      = mvc.values();
+    const std::vector<std::pair<std::pair<std::size_t, std::size_t>,
+                                std::size_t>>& values = mvc.values();
 
     // Get map from mesh domains
     std::map<std::size_t, std::size_t>& markers = mesh.domains().markers(d);
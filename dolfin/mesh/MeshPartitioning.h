@@ -63,7 +63,9 @@ namespace dolfin
   {
   public:
 
-    /// Build a distributed mesh from a local mesh on process 0
+    /// Build a distributed mesh from a local mesh on process 0. In
+    /// serial, the mesh is only renumbered along a Hilbert curve if
+    /// the global parameter "reorder_mesh_hilbert" is set.
     static void build_distributed_mesh(Mesh& mesh);
 
     /// Build a distributed mesh from a local mesh on process 0, with
@@ -146,6 +148,21 @@ namespace dolfin
      std::vector<std::int64_t>& reordered_vertex_indices,
      std::map<std::int64_t, std::int32_t>& reordered_vertex_global_to_local);
 
+    // Reorder regular cells along a Hilbert curve through the cell
+    // midpoints, and number regular vertices in the order they are
+    // first visited by the reordered cells. Ghost cells and vertices
+    // keep their positions. All arguments are updated in place.
+    static void reorder_hilbert(const std::int32_t num_regular_cells,
+     const std::int32_t num_regular_vertices,
+     boost::multi_array<std::int64_t, 2>& cell_vertices,
+     std::vector<std::int64_t>& global_cell_indices,
+     std::vector<int>& cell_partition,
+     std::map<std::int32_t, std::set<unsigned int>>& shared_cells,
+     std::vector<std::int64_t>& vertex_indices,
+     std::map<std::int64_t, std::int32_t>& vertex_global_to_local,
+     boost::multi_array<double, 2>& vertex_coordinates,
+     std::map<std::int32_t, std::set<unsigned int>>& shared_vertices);
+
     // FIXME: Update, making clear exactly what is computed
     // This function takes the partition computed by the partitioner
     // (which tells us to which process each of the local cells stored in
@@ -272,6 +289,8 @@ namespace dolfin
 
     // Add local (to this process) data to domain marker
     std::vector<std::size_t> off_process_global_cell_entities;
+    std::vector<std::size_t> marker_cells, marker_entities;
+    std::vector<T> marker_values;
 
     // Build and populate a local map for global_entity_indices
     std::map<std::size_t, std::size_t> map_of_global_entity_indices;
@@ -291,7 +310,9 @@ namespace dolfin
         const std::size_t local_cell_index = data->second;
         const std::size_t entity_local_index = ldata[i].first.second;
         const T value = ldata[i].second;
-        markers.set_value(local_cell_index, entity_local_index, value);
+        marker_cells.push_back(local_cell_index);
+        marker_entities.push_back(entity_local_index);
+        marker_values.push_back(value);
 
         // If shared with other processes, add to off process list
         if (sharing_map.find(local_cell_index) != sharing_map.end())
@@ -370,9 +391,15 @@ namespace dolfin
       const std::size_t local_entity_index = received_data0[2*i + 1];
       const T value = received_data1[i];
       dolfin_assert(local_cell_entity < mesh.num_cells());
-      markers.set_value(local_cell_entity, local_entity_index, value);
+      marker_cells.push_back(local_cell_entity);
+      marker_entities.push_back(local_entity_index);
+      marker_values.push_back(value);
     }
 
+    // Set local and received values, received values taking
+    // precedence
+    markers.set_values(marker_cells, marker_entities, marker_values);
+
   }
   //---------------------------------------------------------------------------
 
@@ -18,12 +18,16 @@
 // Modified by Garth N. Wells, 2011.
 //
 // First added:  2010-11-27
-// Last changed: 2014-02-06
+// Last changed: 2018-10-16
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 #include <dolfin/log/log.h>
+#include <dolfin/common/MPI.h>
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/utils.h>
 #include "Cell.h"
@@ -35,6 +39,55 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Compute position of integer coordinates X (with b bits each)
+  // along the Hilbert curve in dimension n, using the transpose
+  // algorithm of J. Skilling, "Programming the Hilbert curve", AIP
+  // Conference Proceedings 707 (2004)
+  std::uint64_t hilbert_key(std::array<std::uint32_t, 3> X, int b, int n)
+  {
+    const std::uint32_t M = 1u << (b - 1);
+
+    // Inverse undo excess work
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      const std::uint32_t P = Q - 1;
+      for (int i = 0; i < n; ++i)
+      {
+        if (X[i] & Q)
+          X[0] ^= P;
+        else
+        {
+          const std::uint32_t t = (X[0] ^ X[i]) & P;
+          X[0] ^= t;
+          X[i] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for (int i = 1; i < n; ++i)
+      X[i] ^= X[i - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+      if (X[n - 1] & Q)
+        t ^= Q - 1;
+    }
+    for (int i = 0; i < n; ++i)
+      X[i] ^= t;
+
+    // Interleave bits of transposed key
+    std::uint64_t key = 0;
+    for (int bit = b - 1; bit >= 0; --bit)
+      for (int i = 0; i < n; ++i)
+        key = (key << 1) | ((X[i] >> bit) & 1);
+
+    return key;
+  }
+}
+
 //-----------------------------------------------------------------------------
 dolfin::Mesh MeshRenumbering::renumber_by_color(const Mesh& mesh,
                                  const std::vector<std::size_t> coloring_type)
@@ -266,3 +319,147 @@ void MeshRenumbering::compute_renumbering(const Mesh& mesh,
   }
 }
 //-----------------------------------------------------------------------------
+dolfin::Mesh MeshRenumbering::renumber_by_hilbert_curve(const Mesh& mesh)
+{
+  Timer timer("Renumber mesh along Hilbert curve");
+
+  if (MPI::size(mesh.mpi_comm()) > 1)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "renumber mesh along Hilbert curve",
+                 "Distributed meshes are renumbered during construction (set parameter \"reorder_mesh_hilbert\")");
+  }
+
+  if (mesh.geometry().degree() != 1)
+  {
+    dolfin_error("MeshRenumbering.cpp",
+                 "renumber mesh along Hilbert curve",
+                 "Only affine meshes are supported");
+  }
+
+  const std::size_t tdim = mesh.topology().dim();
+  const std::size_t gdim = mesh.geometry().dim();
+  const std::size_t num_vertices = mesh.num_vertices();
+  const std::size_t num_cells = mesh.num_cells();
+  const std::size_t num_cell_vertices = mesh.type().num_vertices();
+  const MeshConnectivity& cell_vertices = mesh.topology()(tdim, 0);
+  const std::vector<double>& x = mesh.geometry().x();
+
+  // Compute cell midpoints and their order along the curve
+  std::vector<double> midpoints(num_cells*gdim, 0.0);
+  for (std::size_t c = 0; c < num_cells; ++c)
+  {
+    const unsigned int* vertices = cell_vertices(c);
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+      for (std::size_t j = 0; j < gdim; ++j)
+        midpoints[c*gdim + j] += x[vertices[i]*gdim + j];
+    for (std::size_t j = 0; j < gdim; ++j)
+      midpoints[c*gdim + j] /= num_cell_vertices;
+  }
+  const std::vector<std::size_t> cell_order
+    = compute_hilbert_order(midpoints, gdim);
+
+  // Number vertices by first appearance in renumbered cells
+  const std::size_t unset = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> new_vertex_indices(num_vertices, unset);
+  std::vector<std::size_t> vertex_order;
+  vertex_order.reserve(num_vertices);
+  for (auto c : cell_order)
+  {
+    const unsigned int* vertices = cell_vertices(c);
+    for (std::size_t i = 0; i < num_cell_vertices; ++i)
+    {
+      if (new_vertex_indices[vertices[i]] == unset)
+      {
+        new_vertex_indices[vertices[i]] = vertex_order.size();
+        vertex_order.push_back(vertices[i]);
+      }
+    }
+  }
+
+  // Vertices not attached to any cell are numbered last
+  for (std::size_t v = 0; v < num_vertices; ++v)
+  {
+    if (new_vertex_indices[v] == unset)
+    {
+      new_vertex_indices[v] = vertex_order.size();
+      vertex_order.push_back(v);
+    }
+  }
+
+  // Create new mesh
+  Mesh new_mesh(mesh.mpi_comm());
+  MeshEditor editor;
+  editor.open(new_mesh, mesh.type().cell_type(), tdim, gdim);
+
+  editor.init_vertices(num_vertices);
+  std::vector<double> p(gdim);
+  for (std::size_t i = 0; i < num_vertices; ++i)
+  {
+    std::copy(x.begin() + vertex_order[i]*gdim,
+              x.begin() + (vertex_order[i] + 1)*gdim, p.begin());
+    editor.add_vertex(i, p);
+  }
+
+  editor.init_cells(num_cells);
+  std::vector<std::size_t> cell(num_cell_vertices);
+  for (std::size_t i = 0; i < num_cells; ++i)
+  {
+    const unsigned int* vertices = cell_vertices(cell_order[i]);
+    for (std::size_t j = 0; j < num_cell_vertices; ++j)
+      cell[j] = new_vertex_indices[vertices[j]];
+    editor.add_cell(i, cell);
+  }
+
+  editor.close();
+
+  return new_mesh;
+}
+//-----------------------------------------------------------------------------
+std::vector<std::size_t>
+MeshRenumbering::compute_hilbert_order(const std::vector<double>& x,
+                                       std::size_t gdim)
+{
+  dolfin_assert(gdim >= 1 and gdim <= 3);
+  dolfin_assert(x.size() % gdim == 0);
+  const std::size_t num_points = x.size()/gdim;
+
+  // Compute bounding box of points
+  std::array<double, 3> xmin, xmax;
+  xmin.fill(std::numeric_limits<double>::max());
+  xmax.fill(std::numeric_limits<double>::lowest());
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    for (std::size_t j = 0; j < gdim; ++j)
+    {
+      xmin[j] = std::min(xmin[j], x[i*gdim + j]);
+      xmax[j] = std::max(xmax[j], x[i*gdim + j]);
+    }
+  }
+
+  // Use a common scale for all axes so that the curve is not
+  // distorted for elongated domains
+  double extent = 0.0;
+  for (std::size_t j = 0; j < gdim; ++j)
+    extent = std::max(extent, xmax[j] - xmin[j]);
+
+  // Map points to integer coordinates and compute keys
+  const int bits = 21;
+  const double scale = (extent > 0.0) ? ((1u << bits) - 1)/extent : 0.0;
+  std::vector<std::pair<std::uint64_t, std::size_t>> keys(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    std::array<std::uint32_t, 3> X = {{0, 0, 0}};
+    for (std::size_t j = 0; j < gdim; ++j)
+      X[j] = (x[i*gdim + j] - xmin[j])*scale;
+    keys[i] = {hilbert_key(X, bits, gdim), i};
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<std::size_t> order(num_points);
+  for (std::size_t i = 0; i < num_points; ++i)
+    order[i] = keys[i].second;
+
+  return order;
+}
+//-----------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 // First added:  2006-05-08
 // Last changed: 2014-07-02
 
+#include <atomic>
 #include <numeric>
 #include <sstream>
 #include <dolfin/log/log.h>
@@ -27,8 +28,17 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Last modification count given to any topology. Counts are taken
+  // from this shared counter, so that a topology that is copied,
+  // assigned or modified never has the count of a different state.
+  std::atomic<std::size_t> last_modification_count(0);
+}
+
 //-----------------------------------------------------------------------------
-MeshTopology::MeshTopology() : Variable("topology", "mesh topology")
+MeshTopology::MeshTopology() : Variable("topology", "mesh topology"),
+                               _modification_count(++last_modification_count)
 {
   // Do nothing
 }
@@ -40,7 +50,8 @@ MeshTopology::MeshTopology(const MeshTopology& topology)
     global_num_entities(topology.global_num_entities),
     _global_indices(topology._global_indices),
     _shared_entities(topology._shared_entities),
-    connectivity(topology.connectivity)
+    connectivity(topology.connectivity),
+    _modification_count(++last_modification_count)
 {
   // Do nothing
 }
@@ -63,6 +74,7 @@ MeshTopology& MeshTopology::operator= (const MeshTopology& topology)
   _shared_entities = topology._shared_entities;
   connectivity = topology.connectivity;
   _cell_owner = topology._cell_owner;
+  mark_modified();
 
   return *this;
 }
@@ -109,6 +121,7 @@ void MeshTopology::clear()
   _global_indices.clear();
   _shared_entities.clear();
   connectivity.clear();
+  mark_modified();
 }
 //-----------------------------------------------------------------------------
 void MeshTopology::clear(std::size_t d0, std::size_t d1)
@@ -116,6 +129,7 @@ void MeshTopology::clear(std::size_t d0, std::size_t d1)
   dolfin_assert(d0 < connectivity.size());
   dolfin_assert(d1 < connectivity[d0].size());
   connectivity[d0][d1].clear();
+  mark_modified();
 }
 //-----------------------------------------------------------------------------
 void MeshTopology::init(std::size_t dim)
@@ -141,7 +155,11 @@ void MeshTopology::init(std::size_t dim)
 void MeshTopology::init(std::size_t dim, std::size_t local_size,
                         std::size_t global_size)
 {
+  // Numbering entities of a dimension for the first time (when
+  // computing entities) adds data but does not modify the topology
   dolfin_assert(dim < num_entities.size());
+  if (dim == 0 || dim + 1 == num_entities.size() || num_entities[dim] != 0)
+    mark_modified();
   num_entities[dim] = local_size;
 
   dolfin_assert(dim < global_num_entities.size());
@@ -153,6 +171,11 @@ void MeshTopology::init(std::size_t dim, std::size_t local_size,
     shared_entities(0);
 }
 //-----------------------------------------------------------------------------
+void MeshTopology::mark_modified()
+{
+  _modification_count = ++last_modification_count;
+}
+//-----------------------------------------------------------------------------
 void MeshTopology::init_ghost(std::size_t dim, std::size_t index)
 {
   dolfin_assert(dim < ghost_offset_index.size());
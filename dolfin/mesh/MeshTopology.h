@@ -155,6 +155,20 @@ namespace dolfin
     /// Return hash based on the hash of cell-vertex connectivity
     size_t hash() const;
 
+    /// Return counter that changes whenever the topology is
+    /// modified (on init(), clear(), assignment and mark_modified()).
+    /// Copies get a new count. Unlike hash(), this is O(1) and can be
+    /// compared by data computed from the topology to detect that
+    /// the mesh has been rebuilt or reordered. Computing additional
+    /// connectivity does not change the counter.
+    std::size_t modification_count() const
+    { return _modification_count; }
+
+    /// Mark topology as modified. This must be called after
+    /// modifying connectivity in-place (e.g. by reordering
+    /// entities).
+    void mark_modified();
+
     /// Return informal string representation (pretty-print)
     std::string str(bool verbose) const;
 
@@ -199,6 +213,9 @@ namespace dolfin
     // Connectivity for pairs of topological dimensions
     std::vector<std::vector<MeshConnectivity> > connectivity;
 
+    // Changed whenever the topology is modified
+    std::size_t _modification_count;
+
   };
 
 }
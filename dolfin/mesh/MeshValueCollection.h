@@ -23,9 +23,10 @@
 #ifndef __MESH_VALUE_COLLECTION_H
 #define __MESH_VALUE_COLLECTION_H
 
-#include <map>
+#include <algorithm>
 #include <utility>
 #include <memory>
+#include <vector>
 #include <dolfin/common/NoDeleter.h>
 #include <dolfin/common/Variable.h>
 #include <dolfin/log/log.h>
@@ -45,6 +46,10 @@ namespace dolfin
   /// entities through the corresponding cell index and local entity
   /// number (relative to the cell), not by global entity index, which
   /// means that data may be stored robustly to file.
+  ///
+  /// Values are stored in an array of (cell index, local entity
+  /// index) keys and values, sorted by key. Inserting many values is
+  /// most efficient using the bulk set_values() functions.
 
   template <typename T>
   class MeshValueCollection : public Variable
@@ -171,6 +176,31 @@ namespace dolfin
     ///         an existing value.
     bool set_value(std::size_t entity_index, const T& value);
 
+    /// Set marker values for entities defined by cell indices and
+    /// local entity indices. Existing values are overwritten, and if
+    /// an entity appears more than once the last value is used.
+    ///
+    /// @param    cell_indices (std::vector<std::size_t>)
+    ///         The indices of the cells.
+    /// @param    local_entities (std::vector<std::size_t>)
+    ///         The local indices of the entities relative to the cells.
+    /// @param    values (std::vector<T>)
+    ///         The values of the markers.
+    void set_values(const std::vector<std::size_t>& cell_indices,
+                    const std::vector<std::size_t>& local_entities,
+                    const std::vector<T>& values);
+
+    /// Set marker values for given entity indices. Existing values
+    /// are overwritten, and if an entity appears more than once the
+    /// last value is used.
+    ///
+    /// @param    entity_indices (std::vector<std::size_t>)
+    ///         Indices of the entities.
+    /// @param    values (std::vector<T>)
+    ///         The values of the markers.
+    void set_values(const std::vector<std::size_t>& entity_indices,
+                    const std::vector<T>& values);
+
     /// Get marker value for given entity defined by a cell index and
     /// a local entity index
     ///
@@ -185,15 +215,11 @@ namespace dolfin
 
     /// Get all values
     ///
-    /// @return    std::map<std::pair<std::size_t, std::size_t>, T>
-    ///         A map from positions to values.
-    std::map<std::pair<std::size_t, std::size_t>, T>& values();
-
-    /// Get all values (const version)
-    ///
-    /// @return    std::map<std::pair<std::size_t, std::size_t>, T>
-    ///         A map from positions to values.
-    const std::map<std::pair<std::size_t, std::size_t>, T>& values() const;
+    /// @return    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>
+    ///         Positions (cell index, local entity index) and values,
+    ///         sorted by position.
+    const std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>&
+      values() const;
 
     /// Clear all values
     void clear();
@@ -209,14 +235,31 @@ namespace dolfin
 
   private:
 
+    // Add values of all entities of a mesh function
+    void add_mesh_function_values(const MeshFunction<T>& mesh_function);
+
+    // Return position (cell index, local entity index) of entity
+    std::pair<std::size_t, std::size_t> position(std::size_t entity_index);
+
+    // Insert values into sorted values, overwriting existing values
+    // (entries are sorted on return)
+    void insert_values(std::vector<std::pair<std::pair<std::size_t,
+                       std::size_t>, T>>& entries);
+
+    // Compare position of entry with position
+    static bool less_position(const std::pair<std::pair<std::size_t,
+                              std::size_t>, T>& entry,
+                              const std::pair<std::size_t, std::size_t>& pos)
+    { return entry.first < pos; }
+
     // Associated mesh
     std::shared_ptr<const Mesh> _mesh;
 
     // Topological dimension
     int _dim;
 
-    // The values
-    std::map<std::pair<std::size_t, std::size_t>, T> _values;
+    // The values, sorted by position
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>> _values;
 
   };
 
@@ -251,45 +294,7 @@ namespace dolfin
     : Variable("m", "unnamed MeshValueCollection"), _mesh(mesh_function.mesh()),
       _dim(mesh_function.dim())
   {
-    dolfin_assert(_mesh);
-    const std::size_t D = _mesh->topology().dim();
-
-    // Handle cells as a special case
-    if ((int) D == _dim)
-    {
-      for (std::size_t cell_index = 0; cell_index < mesh_function.size();
-           ++cell_index)
-      {
-        const std::pair<std::size_t, std::size_t> key(cell_index, 0);
-        _values.insert({key, mesh_function[cell_index]});
-      }
-    }
-    else
-    {
-      _mesh->init(_dim, D);
-      const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
-      dolfin_assert(!connectivity.empty());
-      for (std::size_t entity_index = 0; entity_index < mesh_function.size();
-           ++entity_index)
-      {
-        // Find the cell
-        dolfin_assert(connectivity.size(entity_index) > 0);
-        const MeshEntity entity(*_mesh, _dim, entity_index);
-        for (std::size_t i = 0; i < entity.num_entities(D) ; ++i)
-        {
-          // Create cell
-          const Cell cell(*_mesh, connectivity(entity_index)[i]);
-
-          // Find the local entity index
-          const std::size_t local_entity = cell.index(entity);
-
-          // Insert into map
-          const std::pair<std::size_t, std::size_t> key(cell.index(),
-                                                        local_entity);
-          _values.insert({key, mesh_function[entity_index]});
-        }
-      }
-    }
+    add_mesh_function_values(mesh_function);
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -309,48 +314,8 @@ namespace dolfin
   {
     _mesh = mesh_function.mesh();
     _dim = mesh_function.dim();
-
-    dolfin_assert(_mesh);
-    const std::size_t D = _mesh->topology().dim();
-
-    // FIXME: Use iterators
-
-    // Handle cells as a special case
-    if ((int) D == _dim)
-    {
-      for (std::size_t cell_index = 0; cell_index < mesh_function.size();
-           ++cell_index)
-      {
-        const std::pair<std::size_t, std::size_t> key(cell_index, 0);
-        _values.insert({key, mesh_function[cell_index]});
-      }
-    }
-    else
-    {
-      _mesh->init(_dim, D);
-      const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
-      dolfin_assert(!connectivity.empty());
-      for (std::size_t entity_index = 0; entity_index < mesh_function.size();
-           ++entity_index)
-      {
-        // Find the cell
-        dolfin_assert(connectivity.size(entity_index) > 0);
-        const MeshEntity entity(*_mesh, _dim, entity_index);
-        for (std::size_t i = 0; i < entity.num_entities(D) ; ++i)
-        {
-          // Create cell
-          const Cell cell(*_mesh, connectivity(entity_index)[i]);
-
-          // Find the local entity index
-          const std::size_t local_entity = cell.index(entity);
-
-          // Insert into map
-          const std::pair<std::size_t, std::size_t> key(cell.index(),
-                                                        local_entity);
-          _values.insert({key, mesh_function[entity_index]});
-        }
-      }
-    }
+    _values.clear();
+    add_mesh_function_values(mesh_function);
 
     return *this;
   }
@@ -424,16 +389,18 @@ namespace dolfin
                    "A mesh has not been associated with this MeshValueCollection");
     }
 
+    // If an item with same key already exists, update it
     const std::pair<std::size_t, std::size_t> pos(cell_index, local_entity);
-    std::pair<typename std::map<std::pair<std::size_t, std::size_t>, T>::iterator, bool>
-      it = _values.insert({pos, value});
-
-    // If an item with same key already exists the value has not been
-    // set and we need to update it
-    if (!it.second)
-      it.first->second = value;
+    auto it = std::lower_bound(_values.begin(), _values.end(), pos,
+                               less_position);
+    if (it != _values.end() && it->first == pos)
+    {
+      it->second = value;
+      return false;
+    }
 
-    return it.second;
+    _values.insert(it, {pos, value});
+    return true;
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -448,50 +415,58 @@ namespace dolfin
     }
 
     dolfin_assert(_dim >= 0);
-
-    // Special case when d = D
-    const std::size_t D = _mesh->topology().dim();
-    if (_dim == (int) D)
+    const std::pair<std::size_t, std::size_t> pos = position(entity_index);
+    return set_value(pos.first, pos.second, value);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::set_values(
+    const std::vector<std::size_t>& cell_indices,
+    const std::vector<std::size_t>& local_entities,
+    const std::vector<T>& values)
+  {
+    dolfin_assert(_dim >= 0);
+    if (!_mesh)
     {
-      // Set local entity index to zero when we mark a cell
-      const std::pair<std::size_t, std::size_t> pos(entity_index, 0);
-      std::pair<typename std::map<std::pair<std::size_t,
-        std::size_t>, T>::iterator, bool> it;
-      it = _values.insert({pos, value});
-
-      // If an item with same key already exists the value has not been
-      // set and we need to update it
-      if (!it.second)
-        it.first->second = value;
-
-      return it.second;
+      dolfin_error("MeshValueCollection.h",
+                   "set values",
+                   "A mesh has not been associated with this MeshValueCollection");
     }
 
-    // Get mesh connectivity d --> D
-    _mesh->init(_dim, D);
-    const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
-
-    // Find the cell
-    dolfin_assert(!connectivity.empty());
-    dolfin_assert(connectivity.size(entity_index) > 0);
-    const MeshEntity entity(*_mesh, _dim, entity_index);
-    const Cell cell(*_mesh, connectivity(entity_index)[0]); // choose first
-
-    // Find the local entity index
-    const std::size_t local_entity = cell.index(entity);
-
-    // Add value
-    const std::pair<std::size_t, std::size_t> pos(cell.index(), local_entity);
-    std::pair<typename std::map<std::pair<std::size_t,
-      std::size_t>, T>::iterator, bool> it;
-    it = _values.insert({pos, value});
-
-    // If an item with same key already exists the value has not been
-    // set and we need to update it
-    if (!it.second)
-      it.first->second = value;
+    dolfin_assert(cell_indices.size() == values.size());
+    dolfin_assert(local_entities.size() == values.size());
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>
+      entries(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      entries[i].first = {cell_indices[i], local_entities[i]};
+      entries[i].second = values[i];
+    }
+    insert_values(entries);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::set_values(
+    const std::vector<std::size_t>& entity_indices,
+    const std::vector<T>& values)
+  {
+    dolfin_assert(_dim >= 0);
+    if (!_mesh)
+    {
+      dolfin_error("MeshValueCollection.h",
+                   "set values",
+                   "A mesh has not been associated with this MeshValueCollection");
+    }
 
-    return it.second;
+    dolfin_assert(entity_indices.size() == values.size());
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>
+      entries(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      entries[i].first = position(entity_indices[i]);
+      entries[i].second = values[i];
+    }
+    insert_values(entries);
   }
   //---------------------------------------------------------------------------
   template <typename T>
@@ -501,11 +476,10 @@ namespace dolfin
     dolfin_assert(_dim >= 0);
 
     const std::pair<std::size_t, std::size_t> pos(cell_index, local_entity);
-    const typename std::map<std::pair<std::size_t,
-      std::size_t>, T>::const_iterator
-      it = _values.find(pos);
+    const auto it = std::lower_bound(_values.cbegin(), _values.cend(), pos,
+                                     less_position);
 
-    if (it == _values.end())
+    if (it == _values.end() || it->first != pos)
     {
       dolfin_error("MeshValueCollection.h",
                    "extract value",
@@ -517,14 +491,7 @@ namespace dolfin
   }
   //---------------------------------------------------------------------------
   template <typename T>
-  std::map<std::pair<std::size_t, std::size_t>, T>&
-    MeshValueCollection<T>::values()
-  {
-    return _values;
-  }
-  //---------------------------------------------------------------------------
-  template <typename T>
-  const std::map<std::pair<std::size_t, std::size_t>, T>&
+  const std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>&
   MeshValueCollection<T>::values() const
   {
     return _values;
@@ -554,6 +521,135 @@ namespace dolfin
     return s.str();
   }
   //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::add_mesh_function_values(
+    const MeshFunction<T>& mesh_function)
+  {
+    dolfin_assert(_mesh);
+    const std::size_t D = _mesh->topology().dim();
+
+    // Handle cells as a special case (positions are sorted)
+    if ((int) D == _dim)
+    {
+      std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>> entries;
+      entries.reserve(mesh_function.size());
+      for (std::size_t cell_index = 0; cell_index < mesh_function.size();
+           ++cell_index)
+      {
+        const std::pair<std::size_t, std::size_t> key(cell_index, 0);
+        entries.push_back({key, mesh_function[cell_index]});
+      }
+      insert_values(entries);
+      return;
+    }
+
+    // Add value for each cell that is incident to an entity
+    _mesh->init(_dim, D);
+    const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
+    dolfin_assert(!connectivity.empty());
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>> entries;
+    entries.reserve(2*mesh_function.size());
+    for (std::size_t entity_index = 0; entity_index < mesh_function.size();
+         ++entity_index)
+    {
+      // Find the cell
+      dolfin_assert(connectivity.size(entity_index) > 0);
+      const MeshEntity entity(*_mesh, _dim, entity_index);
+      for (std::size_t i = 0; i < entity.num_entities(D) ; ++i)
+      {
+        // Create cell
+        const Cell cell(*_mesh, connectivity(entity_index)[i]);
+
+        // Find the local entity index
+        const std::size_t local_entity = cell.index(entity);
+
+        const std::pair<std::size_t, std::size_t> key(cell.index(),
+                                                      local_entity);
+        entries.push_back({key, mesh_function[entity_index]});
+      }
+    }
+    insert_values(entries);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  std::pair<std::size_t, std::size_t>
+  MeshValueCollection<T>::position(std::size_t entity_index)
+  {
+    // Special case when d = D: set local entity index to zero when we
+    // mark a cell
+    dolfin_assert(_mesh);
+    const std::size_t D = _mesh->topology().dim();
+    if (_dim == (int) D)
+      return std::pair<std::size_t, std::size_t>(entity_index, 0);
+
+    // Get mesh connectivity d --> D
+    _mesh->init(_dim, D);
+    const MeshConnectivity& connectivity = _mesh->topology()(_dim, D);
+
+    // Find the cell
+    dolfin_assert(!connectivity.empty());
+    dolfin_assert(connectivity.size(entity_index) > 0);
+    const MeshEntity entity(*_mesh, _dim, entity_index);
+    const Cell cell(*_mesh, connectivity(entity_index)[0]); // choose first
+
+    // Find the local entity index
+    const std::size_t local_entity = cell.index(entity);
+
+    return std::pair<std::size_t, std::size_t>(cell.index(), local_entity);
+  }
+  //---------------------------------------------------------------------------
+  template <typename T>
+  void MeshValueCollection<T>::insert_values(
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>>& entries)
+  {
+    // Sort entries by position, keeping the last value for repeated
+    // positions
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const std::pair<std::pair<std::size_t,
+                        std::size_t>, T>& a,
+                        const std::pair<std::pair<std::size_t,
+                        std::size_t>, T>& b)
+                     { return a.first < b.first; });
+    std::size_t num_entries = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      if (i + 1 < entries.size() && entries[i + 1].first == entries[i].first)
+        continue;
+      entries[num_entries++] = entries[i];
+    }
+    entries.resize(num_entries);
+
+    if (entries.empty())
+      return;
+
+    // Append if all entries follow existing values
+    if (_values.empty() || _values.back().first < entries.front().first)
+    {
+      _values.insert(_values.end(), entries.begin(), entries.end());
+      return;
+    }
+
+    // Merge with existing values, new values replacing existing values
+    std::vector<std::pair<std::pair<std::size_t, std::size_t>, T>> merged;
+    merged.reserve(_values.size() + entries.size());
+    auto it0 = _values.begin();
+    auto it1 = entries.begin();
+    while (it0 != _values.end() && it1 != entries.end())
+    {
+      if (it0->first < it1->first)
+        merged.push_back(*it0++);
+      else
+      {
+        if (it0->first == it1->first)
+          ++it0;
+        merged.push_back(*it1++);
+      }
+    }
+    merged.insert(merged.end(), it0, _values.end());
+    merged.insert(merged.end(), it1, entries.end());
+    _values.swap(merged);
+  }
+  //---------------------------------------------------------------------------
 
 }
 
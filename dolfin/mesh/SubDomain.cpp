@@ -36,6 +36,28 @@
 
 using namespace dolfin;
 
+namespace
+{
+  // Set value of marked entities of a mesh function
+  template<typename T>
+  void set_markers(MeshFunction<T>& sub_domains,
+                   const std::vector<std::size_t>& entities, T sub_domain)
+  {
+    for (auto entity : entities)
+      sub_domains.set_value(entity, sub_domain);
+  }
+
+  // Set value of marked entities of a mesh value collection (bulk
+  // insert)
+  template<typename T>
+  void set_markers(MeshValueCollection<T>& sub_domains,
+                   const std::vector<std::size_t>& entities, T sub_domain)
+  {
+    sub_domains.set_values(entities,
+                           std::vector<T>(entities.size(), sub_domain));
+  }
+}
+
 //-----------------------------------------------------------------------------
 SubDomain::SubDomain(const double map_tol) : map_tolerance(map_tol),
                                              _geometric_dimension(0)
@@ -210,6 +232,7 @@ void SubDomain::apply_markers(S& sub_domains,
   bool on_boundary = false;
 
   // Compute sub domain markers
+  std::vector<std::size_t> marked_entities;
   Progress p("Computing sub domain markers", mesh.num_entities(dim));
   for (MeshEntityIterator entity(mesh, dim); !entity.end(); ++entity)
   {
@@ -270,10 +293,13 @@ void SubDomain::apply_markers(S& sub_domains,
 
     // Mark entity with all vertices inside
     if (all_points_inside)
-      sub_domains.set_value(entity->index(), sub_domain);
+      marked_entities.push_back(entity->index());
 
     p++;
   }
+
+  // Set values of marked entities
+  set_markers(sub_domains, marked_entities, sub_domain);
 }
 //-----------------------------------------------------------------------------
 template<typename T>
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -25,9 +26,14 @@
 #include <boost/unordered_map.hpp>
 #include <boost/version.hpp>
 
+#ifdef HAS_OPENMP
+#include <omp.h>
+#endif
+
 #include <dolfin/common/Timer.h>
 #include <dolfin/common/utils.h>
 #include <dolfin/log/log.h>
+#include <dolfin/parameter/GlobalParameters.h>
 #include "Cell.h"
 #include "CellType.h"
 #include "Mesh.h"
@@ -38,6 +44,253 @@
 
 using namespace dolfin;
 
+#ifdef HAS_OPENMP
+namespace
+{
+  // Entity of a cell, keyed by its sorted vertices. The id is
+  // cell_index*num_cell_entities + local entity index.
+  template<int N>
+  struct KeyedEntity
+  {
+    std::array<std::int32_t, N> key;
+    std::int64_t id;
+  };
+
+  // Sort entities by key (lexicographically) using a stable parallel
+  // LSD radix sort. Each key value has at most key_bits significant
+  // bits, and is sorted in digits of radix_bits bits. Passes where
+  // all entities have the same digit are skipped.
+  template<int N>
+  void radix_sort(std::vector<KeyedEntity<N>>& entities, int key_bits,
+                  int num_threads)
+  {
+    const int radix_bits = 11;
+    const std::size_t num_buckets = 1 << radix_bits;
+    const std::int64_t num_entities = entities.size();
+
+    std::vector<KeyedEntity<N>> buffer(entities.size());
+    std::vector<std::size_t> offsets(num_threads*num_buckets);
+    for (int w = N - 1; w >= 0; --w)
+    {
+      for (int shift = 0; shift < key_bits; shift += radix_bits)
+      {
+        bool skip = false;
+        #pragma omp parallel num_threads(num_threads)
+        {
+          const int nt = omp_get_num_threads();
+          const int t = omp_get_thread_num();
+          const std::int64_t i0 = num_entities*t/nt;
+          const std::int64_t i1 = num_entities*(t + 1)/nt;
+
+          // Count digits in range of this thread
+          std::size_t* offset = offsets.data() + t*num_buckets;
+          std::fill(offset, offset + num_buckets, 0);
+          for (std::int64_t i = i0; i < i1; ++i)
+            ++offset[(entities[i].key[w] >> shift) & (num_buckets - 1)];
+
+          #pragma omp barrier
+          #pragma omp single
+          {
+            // Compute position of first entity of each (bucket,
+            // thread), and skip pass if all entities are in one
+            // bucket
+            std::size_t pos = 0;
+            for (std::size_t b = 0; b < num_buckets; ++b)
+            {
+              const std::size_t bucket_begin = pos;
+              for (int k = 0; k < nt; ++k)
+              {
+                const std::size_t count = offsets[k*num_buckets + b];
+                offsets[k*num_buckets + b] = pos;
+                pos += count;
+              }
+              if (pos - bucket_begin == (std::size_t) num_entities)
+                skip = true;
+            }
+          }
+
+          // Scatter entities
+          if (!skip)
+          {
+            for (std::int64_t i = i0; i < i1; ++i)
+            {
+              const std::size_t b
+                = (entities[i].key[w] >> shift) & (num_buckets - 1);
+              buffer[offset[b]++] = entities[i];
+            }
+          }
+        }
+
+        if (!skip)
+          entities.swap(buffer);
+      }
+    }
+  }
+
+  // Compute entities as TopologyComputation::compute_entities_by_key_matching,
+  // using multiple threads. Keys are generated in parallel over
+  // cells and sorted with a parallel radix sort. The entity numbering
+  // is the same as for the serial algorithm.
+  template<int N>
+  std::int32_t
+  compute_entities_by_radix_sort(Mesh& mesh, int dim,
+                                 const boost::multi_array<unsigned int, 2>& e_vertices,
+                                 int num_threads)
+  {
+    MeshTopology& topology = mesh.topology();
+    const std::size_t tdim = topology.dim();
+    const MeshConnectivity& cv = topology(tdim, 0);
+    const std::int64_t num_cells = topology.size(tdim);
+    const std::int64_t ghost_offset = topology.ghost_offset(tdim);
+    const int num_entities = e_vertices.shape()[0];
+
+    // Build list of keyed entities
+    std::vector<KeyedEntity<N>> keyed_entities(num_cells*num_entities);
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t c = 0; c < num_cells; ++c)
+    {
+      const unsigned int* vertices = cv(c);
+      for (int i = 0; i < num_entities; ++i)
+      {
+        KeyedEntity<N>& e = keyed_entities[c*num_entities + i];
+        for (int j = 0; j < N; ++j)
+          e.key[j] = vertices[e_vertices[i][j]];
+        std::sort(e.key.begin(), e.key.end());
+        e.id = c*num_entities + i;
+      }
+    }
+
+    // Sort by key
+    int key_bits = 1;
+    while (key_bits < 31 && (std::size_t(1) << key_bits) < topology.size(0))
+      ++key_bits;
+    radix_sort<N>(keyed_entities, key_bits, num_threads);
+
+    // Find first position of each entity in sorted list
+    const std::int64_t num_keyed = keyed_entities.size();
+    std::vector<std::int64_t> starts;
+    std::vector<std::int64_t> num_starts(num_threads + 1, 0);
+    #pragma omp parallel num_threads(num_threads)
+    {
+      const int nt = omp_get_num_threads();
+      const int t = omp_get_thread_num();
+      const std::int64_t i0 = num_keyed*t/nt;
+      const std::int64_t i1 = num_keyed*(t + 1)/nt;
+      std::int64_t count = 0;
+      for (std::int64_t i = i0; i < i1; ++i)
+      {
+        if (i == 0 || keyed_entities[i].key != keyed_entities[i - 1].key)
+          ++count;
+      }
+      num_starts[t + 1] = count;
+
+      #pragma omp barrier
+      #pragma omp single
+      {
+        for (int k = 0; k < nt; ++k)
+          num_starts[k + 1] += num_starts[k];
+        starts.resize(num_starts[nt] + 1);
+        starts.back() = num_keyed;
+      }
+
+      std::int64_t pos = num_starts[t];
+      for (std::int64_t i = i0; i < i1; ++i)
+      {
+        if (i == 0 || keyed_entities[i].key != keyed_entities[i - 1].key)
+          starts[pos++] = i;
+      }
+    }
+    const std::int64_t num_mesh_entities = starts.size() - 1;
+
+    // Pick the generating cell entity of each mesh entity as in the
+    // serial algorithm: non-ghost cells first, then highest local
+    // index for non-ghosts and lowest for ghosts, then lowest cell
+    // index. An entity is a ghost if it is only in ghost cells.
+    std::vector<std::int64_t> generator(num_mesh_entities);
+    std::vector<std::int32_t> entity_index(num_mesh_entities);
+    std::vector<std::int64_t> num_nonghost(num_threads + 1, 0);
+    std::int32_t num_nonghost_entities = 0;
+    #pragma omp parallel num_threads(num_threads)
+    {
+      const int nt = omp_get_num_threads();
+      const int t = omp_get_thread_num();
+      const std::int64_t e0 = num_mesh_entities*t/nt;
+      const std::int64_t e1 = num_mesh_entities*(t + 1)/nt;
+      std::int64_t count = 0;
+      for (std::int64_t e = e0; e < e1; ++e)
+      {
+        std::pair<std::int32_t, std::int64_t> best;
+        for (std::int64_t k = starts[e]; k < starts[e + 1]; ++k)
+        {
+          const std::int64_t id = keyed_entities[k].id;
+          const std::int64_t c = id/num_entities;
+          const std::int32_t i = id % num_entities;
+          const std::pair<std::int32_t, std::int64_t>
+            candidate((c < ghost_offset) ? (-i - 1) : i, c);
+          if (k == starts[e] || candidate < best)
+          {
+            best = candidate;
+            generator[e] = id;
+          }
+        }
+        if (best.first < 0)
+          ++count;
+      }
+      num_nonghost[t + 1] = count;
+
+      #pragma omp barrier
+      #pragma omp single
+      {
+        for (int k = 0; k < nt; ++k)
+          num_nonghost[k + 1] += num_nonghost[k];
+        num_nonghost_entities = num_nonghost[nt];
+      }
+
+      // Number entities, with ghost entities at the end
+      std::int64_t nonghost_index = num_nonghost[t];
+      std::int64_t ghost_index = num_nonghost[nt] + e0 - num_nonghost[t];
+      for (std::int64_t e = e0; e < e1; ++e)
+      {
+        const std::int64_t c = generator[e]/num_entities;
+        entity_index[e] = (c < ghost_offset) ? nonghost_index++ : ghost_index++;
+      }
+    }
+
+    // Build connectivity arrays
+    std::vector<unsigned int> connectivity_ev(num_mesh_entities*N);
+    std::vector<unsigned int> connectivity_ce(num_cells*num_entities);
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t e = 0; e < num_mesh_entities; ++e)
+    {
+      const std::int32_t index = entity_index[e];
+
+      // Entity vertices, ordered as in generating cell
+      const std::int64_t c = generator[e]/num_entities;
+      const std::int32_t i = generator[e] % num_entities;
+      const unsigned int* vertices = cv(c);
+      for (int j = 0; j < N; ++j)
+        connectivity_ev[index*N + j] = vertices[e_vertices[i][j]];
+
+      // Cell-to-entity map
+      for (std::int64_t k = starts[e]; k < starts[e + 1]; ++k)
+        connectivity_ce[keyed_entities[k].id] = index;
+    }
+
+    // Initialise connectivity data structure
+    topology.init(dim, num_mesh_entities, 0);
+
+    // Initialise ghost entity offset
+    topology.init_ghost(dim, num_nonghost_entities);
+
+    // Set cell-entity connectivity
+    topology(tdim, dim).set(std::move(connectivity_ce), num_entities);
+    topology(dim, 0).set(std::move(connectivity_ev), N);
+
+    return num_mesh_entities;
+  }
+}
+#endif
+
 //-----------------------------------------------------------------------------
 std::size_t TopologyComputation::compute_entities(Mesh& mesh, std::size_t dim)
 {
@@ -128,11 +381,9 @@ void TopologyComputation::compute_connectivity(Mesh& mesh,
   // Decide how to compute the connectivity
   if (d0 == d1)
   {
-    std::vector<std::vector<std::size_t>>
-      connectivity_dd(topology.size(d0), std::vector<std::size_t>(1));
-    for (MeshEntityIterator e(mesh, d0, "all"); !e.end(); ++e)
-      connectivity_dd[e->index()][0] = e->index();
-    topology(d0, d0).set(connectivity_dd);
+    std::vector<unsigned int> connectivity_dd(topology.size(d0));
+    std::iota(connectivity_dd.begin(), connectivity_dd.end(), 0);
+    topology(d0, d0).set(std::move(connectivity_dd), 1);
   }
   else if (d0 < d1)
   {
@@ -198,6 +449,16 @@ std::int32_t TopologyComputation::compute_entities_by_key_matching(Mesh& mesh,
 
   dolfin_assert(N == num_vertices);
 
+#ifdef HAS_OPENMP
+  // Compute entities using multiple threads
+  const int num_threads = parameters["num_threads"];
+  if (num_threads > 1)
+  {
+    return compute_entities_by_radix_sort<N>(mesh, dim, e_vertices,
+                                             num_threads);
+  }
+#endif
+
   // Create data structure to hold entities
   // ([vertices key], (cell_local_index, cell index), [entity vertices], entity index)
   std::vector<std::tuple<std::array<std::int32_t, N>,
@@ -337,38 +598,104 @@ void TopologyComputation::compute_from_transpose(Mesh& mesh, std::size_t d0,
   //   1. Iterate over entities of dimension d1 and count the number
   //      of connections for each entity of dimension d0
   //
-  //   2. Allocate memory / prepare data structures
+  //   2. Compute offsets of the connections of each entity of
+  //      dimension d0
   //
   //   3. Iterate again over entities of dimension d1 and add connections
   //      for each entity of dimension d0
+  //
+  // With multiple threads, the counters are shared and updated
+  // atomically, and the connections of each entity are sorted
+  // afterwards so that they are ordered by entity index as in the
+  // serial computation.
 
   log(TRACE, "Computing mesh connectivity %d - %d from transpose.", d0, d1);
 
   // Get mesh topology and connectivity
   MeshTopology& topology = mesh.topology();
-  MeshConnectivity& connectivity = topology(d0, d1);
+  const MeshConnectivity& connectivity_10 = topology(d1, d0);
 
   // Need connectivity d1 - d0
-  dolfin_assert(!topology(d1, d0).empty());
+  dolfin_assert(!connectivity_10.empty());
 
-  // Temporary array
-  std::vector<std::size_t> tmp(topology.size(d0), 0);
+  #ifdef HAS_OPENMP
+  const int num_threads = std::max(1, (int) parameters["num_threads"]);
+  #else
+  const int num_threads = 1;
+  #endif
 
-  // Count the number of connections
-  for (MeshEntityIterator e1(mesh, d1, "all"); !e1.end(); ++e1)
-    for (MeshEntityIterator e0(*e1, d0); !e0.end(); ++e0)
-      tmp[e0->index()]++;
+  const std::int64_t num_entities0 = topology.size(d0);
+  const std::int64_t num_entities1 = topology.size(d1);
 
-  // Initialize the number of connections
-  connectivity.init(tmp);
+  // Count the number of connections
+  std::vector<unsigned int> offsets(num_entities0 + 1, 0);
+  if (num_threads > 1)
+  {
+    #ifdef HAS_OPENMP
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t e1 = 0; e1 < num_entities1; ++e1)
+    {
+      const unsigned int* entities = connectivity_10(e1);
+      for (std::size_t i = 0; i < connectivity_10.size(e1); ++i)
+      {
+        #pragma omp atomic
+        ++offsets[entities[i] + 1];
+      }
+    }
+    #endif
+  }
+  else
+  {
+    for (std::int64_t e1 = 0; e1 < num_entities1; ++e1)
+    {
+      const unsigned int* entities = connectivity_10(e1);
+      for (std::size_t i = 0; i < connectivity_10.size(e1); ++i)
+        ++offsets[entities[i] + 1];
+    }
+  }
 
-  // Reset current position for each entity
-  std::fill(tmp.begin(), tmp.end(), 0);
+  // Compute offsets
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
 
   // Add the connections
-  for (MeshEntityIterator e1(mesh, d1, "all"); !e1.end(); ++e1)
-    for (MeshEntityIterator e0(*e1, d0); !e0.end(); ++e0)
-      connectivity.set(e0->index(), e1->index(), tmp[e0->index()]++);
+  std::vector<unsigned int> pos(offsets.begin(), offsets.end() - 1);
+  std::vector<unsigned int> connections(offsets.back());
+  if (num_threads > 1)
+  {
+    #ifdef HAS_OPENMP
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t e1 = 0; e1 < num_entities1; ++e1)
+    {
+      const unsigned int* entities = connectivity_10(e1);
+      for (std::size_t i = 0; i < connectivity_10.size(e1); ++i)
+      {
+        unsigned int p;
+        #pragma omp atomic capture
+        p = pos[entities[i]]++;
+        connections[p] = e1;
+      }
+    }
+
+    // Sort connections of each entity
+    #pragma omp parallel for num_threads(num_threads) schedule(static)
+    for (std::int64_t e0 = 0; e0 < num_entities0; ++e0)
+    {
+      std::sort(connections.begin() + offsets[e0],
+                connections.begin() + offsets[e0 + 1]);
+    }
+    #endif
+  }
+  else
+  {
+    for (std::int64_t e1 = 0; e1 < num_entities1; ++e1)
+    {
+      const unsigned int* entities = connectivity_10(e1);
+      for (std::size_t i = 0; i < connectivity_10.size(e1); ++i)
+        connections[pos[entities[i]]++] = e1;
+    }
+  }
+
+  topology(d0, d1).set(std::move(connections), std::move(offsets));
 }
 //----------------------------------------------------------------------------
 void TopologyComputation::compute_from_map(Mesh& mesh,
@@ -56,7 +56,11 @@ Parameters NewtonSolver::default_parameters()
   p.add("error_on_nonconvergence", true);
   p.add<double>("relaxation_parameter");
 
-  //p.add("reuse_preconditioner", false);
+  // Reuse of Jacobian and linear solver factorisation
+  p.add("factorisation_reuse", "none",
+        {"none", "symbolic", "interval", "slow_convergence"});
+  p.add("factorisation_interval", 3);
+  p.add("slow_convergence_rate", 0.5);
 
   p.add(LUSolver::default_parameters());
   p.add(KrylovSolver::default_parameters());
@@ -68,7 +72,8 @@ NewtonSolver::NewtonSolver(MPI_Comm comm,
                            std::shared_ptr<GenericLinearSolver> solver,
                            GenericLinearAlgebraFactory& factory)
   : Variable("Newton solver", "unnamed"), _newton_iteration(0),
-    _krylov_iterations(0), _relaxation_parameter(1.0), _residual(0.0),
+    _krylov_iterations(0), _jacobian_updates(0),
+    _relaxation_parameter(1.0), _residual(0.0),
     _residual0(0.0), _solver(solver), _matA(factory.create_matrix(comm)),
     _matP(factory.create_matrix(comm)), _dx(factory.create_vector(comm)),
     _b(factory.create_vector(comm)), _mpi_comm(comm)
@@ -118,12 +123,22 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
   }
   dolfin_assert(_solver);
 
-  // Set parameters for linear solver
-  _solver->update_parameters(parameters(_solver->parameter_type()));
+  // Set parameters for linear solver. Keep the symbolic
+  // factorisation of LU solvers if requested.
+  const std::string reuse = parameters["factorisation_reuse"];
+  Parameters solver_parameters(parameters(_solver->parameter_type()));
+  if (reuse == "symbolic"
+      && solver_parameters.has_parameter("reuse_symbolic_factorisation"))
+  {
+    solver_parameters["reuse_symbolic_factorisation"] = true;
+  }
+  _solver->update_parameters(solver_parameters);
 
   // Reset iteration counts
   _newton_iteration = 0;
   _krylov_iterations = 0;
+  _jacobian_updates = 0;
+  double residual_previous = 0.0;
 
   // Compute F(u)
   nonlinear_problem.form(*_matA, *_matP, *_b, x);
@@ -150,12 +165,16 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
   // Start iterations
   while (!newton_converged && _newton_iteration < maxiter)
   {
-    // Compute Jacobian
-    nonlinear_problem.J(*_matA, x);
-    nonlinear_problem.J_pc(*_matP, x);
-
-    // Setup (linear) solver (including set operators)
-    solver_setup(_matA, _matP, nonlinear_problem, _newton_iteration);
+    // Compute Jacobian and setup (linear) solver (including set
+    // operators), unless the previous Jacobian and factorisation are
+    // reused
+    if (update_jacobian(reuse, residual_previous))
+    {
+      nonlinear_problem.J(*_matA, x);
+      nonlinear_problem.J_pc(*_matP, x);
+      solver_setup(_matA, _matP, nonlinear_problem, _newton_iteration);
+      _jacobian_updates++;
+    }
 
     // Perform linear solve and update total number of Krylov
     // iterations
@@ -178,6 +197,7 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
     nonlinear_problem.F(*_b, x);
 
     // Test for convergence
+    residual_previous = _residual;
     if (convergence_criterion == "residual")
       newton_converged = converged(*_b, nonlinear_problem, _newton_iteration);
     else if (convergence_criterion == "incremental")
@@ -200,8 +220,16 @@ NewtonSolver::solve(NonlinearProblem& nonlinear_problem,
   {
     if (_mpi_comm.rank() == 0)
     {
-      info("Newton solver finished in %d iterations and %d linear solver iterations.",
-           _newton_iteration, _krylov_iterations);
+      if (reuse == "interval" || reuse == "slow_convergence")
+      {
+        info("Newton solver finished in %d iterations and %d linear solver iterations (%d Jacobian updates).",
+             _newton_iteration, _krylov_iterations, _jacobian_updates);
+      }
+      else
+      {
+        info("Newton solver finished in %d iterations and %d linear solver iterations.",
+             _newton_iteration, _krylov_iterations);
+      }
     }
   }
   else
@@ -239,6 +267,11 @@ std::size_t NewtonSolver::krylov_iterations() const
   return _krylov_iterations;
 }
 //-----------------------------------------------------------------------------
+std::size_t NewtonSolver::jacobian_updates() const
+{
+  return _jacobian_updates;
+}
+//-----------------------------------------------------------------------------
 double NewtonSolver::residual() const
 {
   return _residual;
@@ -299,6 +332,29 @@ bool NewtonSolver::converged(const GenericVector& r,
     return false;
 }
 //-----------------------------------------------------------------------------
+bool NewtonSolver::update_jacobian(std::string reuse,
+                                   double residual_previous) const
+{
+  // Always compute Jacobian in first iteration
+  if (_jacobian_updates == 0)
+    return true;
+
+  if (reuse == "interval")
+  {
+    const int interval = parameters["factorisation_interval"];
+    return interval <= 1 || _newton_iteration % interval == 0;
+  }
+  else if (reuse == "slow_convergence")
+  {
+    // Update if the residual was not reduced by the given rate in
+    // the previous iteration
+    const double rate = parameters["slow_convergence_rate"];
+    return !(_residual < rate*residual_previous);
+  }
+
+  return true;
+}
+//-----------------------------------------------------------------------------
 void NewtonSolver::solver_setup(std::shared_ptr<const GenericMatrix> A,
                                 std::shared_ptr<const GenericMatrix> P,
                                 const NonlinearProblem& nonlinear_problem,
@@ -26,6 +26,7 @@
 
 #include <utility>
 #include <memory>
+#include <string>
 #include <dolfin/common/MPI.h>
 #include <dolfin/common/Variable.h>
 
@@ -41,6 +42,21 @@ namespace dolfin
 
   /// This class defines a Newton solver for nonlinear systems of
   /// equations of the form :math:`F(x) = 0`.
+  ///
+  /// By default, the Jacobian is assembled and the linear solver is
+  /// set up in every iteration. The parameter "factorisation_reuse"
+  /// selects a policy for reusing the Jacobian and the factorisation
+  /// (or preconditioner) of the linear solver:
+  ///
+  ///   "none": recompute in every iteration (default)
+  ///   "symbolic": recompute in every iteration, but keep the
+  ///       symbolic factorisation of LU solvers that support it
+  ///       (parameter "reuse_symbolic_factorisation")
+  ///   "interval": recompute every "factorisation_interval" iterations
+  ///   "slow_convergence": recompute when the residual is reduced by
+  ///       less than the factor "slow_convergence_rate"
+  ///
+  /// The number of Jacobian updates is returned by jacobian_updates().
 
   class NewtonSolver : public Variable
   {
@@ -95,6 +111,17 @@ namespace dolfin
     ///         The number of iterations.
     std::size_t krylov_iterations() const;
 
+    /// Return number of Jacobian updates (assembly of the Jacobian
+    /// and setup of the linear solver) since solve started. This is
+    /// smaller than the number of Newton iterations if the Jacobian is
+    /// reused (parameter "factorisation_reuse" set to "interval" or
+    /// "slow_convergence").
+    ///
+    /// *Returns*
+    ///     std::size_t
+    ///         The number of Jacobian updates.
+    std::size_t jacobian_updates() const;
+
     /// Return current residual
     ///
     /// *Returns*
@@ -212,12 +239,20 @@ namespace dolfin
 
   private:
 
+    // Return true if the Jacobian should be recomputed (and the
+    // linear solver set up) in the current iteration, given the
+    // reuse policy and the residual of the previous iteration
+    bool update_jacobian(std::string reuse, double residual_previous) const;
+
     // Current number of Newton iterations
     std::size_t _newton_iteration;
 
     // Accumulated number of Krylov iterations since solve began
     std::size_t _krylov_iterations;
 
+    // Number of Jacobian updates since solve began
+    std::size_t _jacobian_updates;
+
     // Relaxation parameter
     double _relaxation_parameter;
 
@@ -58,6 +58,20 @@ namespace dolfin
       // Allow extrapolation in function interpolation
       p.add("allow_extrapolation", false);
 
+      // Number of threads used in assembly (0 = serial assembly,
+      // requires OpenMP)
+      p.add("num_threads", 0);
+
+      // Assemble cells with off-process rows first and exchange their
+      // contributions with the owning processes while the remaining
+      // cells are assembled (serial assembly, requires MPI 3)
+      p.add("overlap_assembly_communication", false);
+
+      // Method for building the sparsity pattern of cell integrals
+      // ("insert" = insert element blocks, "topology" = derive from
+      // mesh connectivity and dofmap where possible)
+      p.add("sparsity_pattern_method", "insert", {"insert", "topology"});
+
       //-- Input
 
       // Warn if reading large XML files in parallel (MB)
@@ -79,13 +93,30 @@ namespace dolfin
       // DOF reordering when running in serial
       p.add("reorder_dofs_serial", true);
 
-      // Add dof ordering library
+      // Add dof ordering library, used for dofmaps with "default"
+      // dof ordering ("cell_order" numbers dofs in the order of the
+      // mesh cells, e.g. after Hilbert curve ordering)
       std::string default_dof_ordering_library = "Boost";
       #ifdef HAS_SCOTCH
       default_dof_ordering_library = "SCOTCH";
       #endif
       p.add("dof_ordering_library", default_dof_ordering_library,
-            {"Boost", "random", "SCOTCH"});
+            {"Boost", "cell_order", "hilbert", "nested_dissection",
+             "random", "SCOTCH"});
+
+      // Communication used to compute ownership and numbering of
+      // shared dofs for distributed dofmaps: "global" uses all-to-all
+      // exchanges, "neighbourhood" exchanges data with processes that
+      // share mesh vertices only (MPI-3 neighbourhood collectives)
+      p.add("dofmap_communication", "global",
+            {"global", "neighbourhood"});
+
+      // Communication used to update ghost entries of PETSc vectors:
+      // "petsc" uses PETSc vector scatters, "neighbourhood" exchanges
+      // data with neighbouring processes only (MPI-3 neighbourhood
+      // collectives)
+      p.add("ghost_update_communication", "petsc",
+            {"neighbourhood", "petsc"});
 
       //-- Meshes
 
@@ -97,6 +128,10 @@ namespace dolfin
       p.add("reorder_cells_gps", false);
       p.add("reorder_vertices_gps", false);
 
+      // Mesh ordering of cells and vertices along a Hilbert curve
+      // (built-in and distributed meshes)
+      p.add("reorder_mesh_hilbert", false);
+
       // Set default graph/mesh partitioner
       std::string default_mesh_partitioner = "SCOTCH";
       #ifdef HAS_PARMETIS
@@ -153,6 +188,11 @@ namespace dolfin
             default_backend,
             allowed_backends);
 
+      // Storage of matrices for vector-valued spaces ("scalar" = one
+      // entry per dof, "block" = sparsity pattern with one entry per
+      // block of dofs and PETSc BAIJ matrices)
+      p.add("matrix_block_storage", "scalar", {"scalar", "block"});
+
       // Add nested parameter sets
       p.add(KrylovSolver::default_parameters());
       p.add(LUSolver::default_parameters());
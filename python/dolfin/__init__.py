@@ -34,7 +34,7 @@ del sys
 from .cpp import __version__
 
 from .cpp.common import (Variable, has_debug, has_hdf5, has_scotch,
-                         has_hdf5_parallel, has_mpi, has_mpi4py,
+                         has_hdf5_parallel, has_mpi, has_mpi4py, has_openmp,
                          has_petsc, has_petsc4py, has_parmetis, has_sundials,
                          has_slepc, has_slepc4py, git_commit_hash,
                          DOLFIN_EPS, DOLFIN_PI,  DOLFIN_EPS_LARGE,
@@ -61,6 +61,7 @@ from .cpp.fem import (FiniteElement, DofMap, Assembler, MultiMeshAssembler,
                       MultiMeshDirichletBC, adapt)
 
 from .cpp.geometry import (BoundingBoxTree,
+                           WideBoundingBoxTree,
                            Point,
                            MeshPointIntersection,
                            intersect)
@@ -140,7 +141,7 @@ from .common.timer import Timer, timed
 from .common.plotting import plot
 
 from .fem.assembling import (assemble, assemble_system, assemble_multimesh,
-                             SystemAssembler, assemble_local)
+                             SystemAssembler, AssemblyPlan, assemble_local)
 from .fem.form import Form
 from .fem.norms import norm, errornorm
 from .fem.dirichletbc import DirichletBC, AutoSubDomain
@@ -459,3 +459,25 @@ class SystemAssembler(cpp.fem.SystemAssembler):
         # Keep Python counterpart of bcs (and Python object it owns)
         # alive
         self._bcs = bcs
+
+
+class AssemblyPlan(cpp.fem.AssemblyPlan):
+    __doc__ = cpp.fem.AssemblyPlan.__doc__
+
+    def __init__(self, a_form, form_compiler_parameters=None):
+        """
+        Create an AssemblyPlan
+
+        * Arguments *
+           a (ufl.Form, _Form_)
+              Bilinear form
+        """
+        # Create dolfin Form object referencing all data needed by
+        # assembler
+        a_dolfin_form = _create_dolfin_form(a_form, form_compiler_parameters)
+
+        # Call C++ constructor
+        cpp.fem.AssemblyPlan.__init__(self, a_dolfin_form)
+
+        # Keep Python form alive
+        self._a_dolfin_form = a_dolfin_form
@@ -352,6 +352,25 @@ class Function(ufl.Coefficient):
     def eval(self, u, x):
         return self._cpp_object.eval(u, x)
 
+    def eval_points(self, x, cells=None):
+        """Evaluate the function at many points.
+
+        *Arguments*
+            x
+                Point coordinates, a NumPy array of shape (num_points, gdim).
+            cells
+                Optional cell hints for the points, such as the cells
+                returned by a previous call.
+
+        *Returns*
+            The values, a NumPy array of shape (num_points,
+            value_size), and the cell containing each point.
+        """
+        x = np.asarray(x, dtype=np.float64)
+        if cells is None:
+            cells = []
+        return self._cpp_object.eval_points(x, cells)
+
     def extrapolate(self, u):
         if isinstance(u, ufl.Coefficient):
             self._cpp_object.extrapolate(u._cpp_object)
@@ -32,7 +32,8 @@ class FunctionSpace(ufl.FunctionSpace):
             else:
                 self._init_convenience(*args, **kwargs)
 
-    def _init_from_ufl(self, mesh, element, constrained_domain=None):
+    def _init_from_ufl(self, mesh, element, constrained_domain=None,
+                       dof_ordering="default"):
 
         # Initialize the ufl.FunctionSpace first to check for good
         # meaning
@@ -46,11 +47,11 @@ class FunctionSpace(ufl.FunctionSpace):
         # Create DOLFIN element and dofmap
         dolfin_element = cpp.fem.FiniteElement(ufc_element)
         ufc_dofmap = cpp.fem.make_ufc_dofmap(ufc_dofmap)
-        if constrained_domain is None:
+        if constrained_domain is None and dof_ordering == "default":
             dolfin_dofmap = cpp.fem.DofMap(ufc_dofmap, mesh)
         else:
             dolfin_dofmap = cpp.fem.DofMap(ufc_dofmap, mesh,
-                                           constrained_domain)
+                                           constrained_domain, dof_ordering)
 
         # Initialize the cpp.FunctionSpace
         self._cpp_object = cpp.function.FunctionSpace(mesh,
@@ -91,13 +92,15 @@ class FunctionSpace(ufl.FunctionSpace):
         ufl.FunctionSpace.__init__(self, ufl_domain, ufl_element)
 
     def _init_convenience(self, mesh, family, degree, form_degree=None,
-                          constrained_domain=None, restriction=None):
+                          constrained_domain=None, restriction=None,
+                          dof_ordering="default"):
 
         # Create UFL element
         element = ufl.FiniteElement(family, mesh.ufl_cell(), degree,
                                     form_degree=form_degree)
 
-        self._init_from_ufl(mesh, element, constrained_domain=constrained_domain)
+        self._init_from_ufl(mesh, element, constrained_domain=constrained_domain,
+                            dof_ordering=dof_ordering)
 
     def dolfin_element(self):
         "Return the DOLFIN element."
@@ -211,7 +214,8 @@ class FunctionSpace(ufl.FunctionSpace):
 
 
 def VectorFunctionSpace(mesh, family, degree, dim=None, form_degree=None,
-                        constrained_domain=None, restriction=None):
+                        constrained_domain=None, restriction=None,
+                        dof_ordering="default"):
     """Create finite element function space."""
 
     # Create UFL element
@@ -219,11 +223,13 @@ def VectorFunctionSpace(mesh, family, degree, dim=None, form_degree=None,
                                 form_degree=form_degree, dim=dim)
 
     # Return (Py)DOLFIN FunctionSpace
-    return FunctionSpace(mesh, element, constrained_domain=constrained_domain)
+    return FunctionSpace(mesh, element, constrained_domain=constrained_domain,
+                         dof_ordering=dof_ordering)
 
 
 def TensorFunctionSpace(mesh, family, degree, shape=None, symmetry=None,
-                        constrained_domain=None, restriction=None):
+                        constrained_domain=None, restriction=None,
+                        dof_ordering="default"):
     """Create finite element function space."""
 
     # Create UFL element
@@ -231,4 +237,5 @@ def TensorFunctionSpace(mesh, family, degree, shape=None, symmetry=None,
                                 shape, symmetry)
 
     # Return (Py)DOLFIN FunctionSpace
-    return FunctionSpace(mesh, element, constrained_domain=constrained_domain)
+    return FunctionSpace(mesh, element, constrained_domain=constrained_domain,
+                         dof_ordering=dof_ordering)
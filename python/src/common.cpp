@@ -55,6 +55,8 @@ namespace dolfin_wrappers
     m.def("has_hdf5", &dolfin::has_hdf5);
     m.def("has_hdf5_parallel", &dolfin::has_hdf5_parallel);
     m.def("has_mpi", &dolfin::has_mpi);
+    m.def("has_openmp", &dolfin::has_openmp,
+          "Return `True` if DOLFIN is configured with OpenMP");
     m.def("has_mpi4py", []()
           {
             #ifdef HAS_PYBIND11_MPI4PY
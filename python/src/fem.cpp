@@ -34,6 +34,7 @@
 #include <dolfin/fem/assemble.h>
 #include <dolfin/fem/assemble_local.h>
 #include <dolfin/fem/Assembler.h>
+#include <dolfin/fem/AssemblyPlan.h>
 #include <dolfin/fem/MultiMeshAssembler.h>
 #include <dolfin/fem/DirichletBC.h>
 #include <dolfin/fem/DiscreteOperators.h>
@@ -45,6 +46,7 @@
 #include <dolfin/fem/LinearVariationalProblem.h>
 #include <dolfin/fem/LinearVariationalSolver.h>
 #include <dolfin/fem/LocalSolver.h>
+#include <dolfin/fem/MatrixFreeOperator.h>
 #include <dolfin/fem/NonlinearVariationalProblem.h>
 #include <dolfin/fem/NonlinearVariationalSolver.h>
 #include <dolfin/fem/PETScDMCollection.h>
@@ -59,6 +61,7 @@
 #include <dolfin/la/GenericMatrix.h>
 #include <dolfin/la/GenericVector.h>
 #include <dolfin/la/GenericTensor.h>
+#include <dolfin/la/LinearOperator.h>
 #include <dolfin/la/SparsityPattern.h>
 #include <dolfin/mesh/Mesh.h>
 #include <dolfin/mesh/MeshFunction.h>
@@ -225,6 +228,7 @@ namespace dolfin_wrappers
            "The dimension of the global finite element function space")
       .def("index_map", &dolfin::GenericDofMap::index_map)
       .def("neighbours", &dolfin::GenericDofMap::neighbours)
+      .def("cells_with_unowned_dofs", &dolfin::GenericDofMap::cells_with_unowned_dofs)
       .def("off_process_owner", &dolfin::GenericDofMap::off_process_owner)
       .def("shared_nodes", &dolfin::GenericDofMap::shared_nodes)
       .def("cell_dofs", &dolfin::GenericDofMap::cell_dofs)
@@ -276,8 +280,12 @@ namespace dolfin_wrappers
     py::class_<dolfin::DofMap, std::shared_ptr<dolfin::DofMap>, dolfin::GenericDofMap>
       (m, "DofMap", "DOLFIN DofMap object")
       .def(py::init<std::shared_ptr<const ufc::dofmap>, const dolfin::Mesh&>())
-      .def(py::init<std::shared_ptr<const ufc::dofmap>, const dolfin::Mesh&, std::shared_ptr<const dolfin::SubDomain>>())
+      .def(py::init<std::shared_ptr<const ufc::dofmap>, const dolfin::Mesh&, std::shared_ptr<const dolfin::SubDomain>, std::string>(),
+           py::arg("ufc_dofmap"), py::arg("mesh"), py::arg("constrained_domain"),
+           py::arg("dof_ordering")="default")
       .def("ownership_range", &dolfin::DofMap::ownership_range)
+      .def("dof_ordering", &dolfin::DofMap::dof_ordering)
+      .def("compute_bandwidth_and_profile", &dolfin::DofMap::compute_bandwidth_and_profile)
       .def("cell_dofs", &dolfin::DofMap::cell_dofs);
 
     // dolfin::MultiMeshDofMap
@@ -412,6 +420,26 @@ namespace dolfin_wrappers
       .def(py::init<>())
       .def("assemble", &dolfin::Assembler::assemble);
 
+    // dolfin::AssemblyPlan
+    py::class_<dolfin::AssemblyPlan, std::shared_ptr<dolfin::AssemblyPlan>, dolfin::AssemblerBase>
+      (m, "AssemblyPlan", "Plan for repeated assembly of a bilinear form into a matrix with fixed sparsity")
+      .def(py::init<std::shared_ptr<const dolfin::Form>>())
+      .def("assemble", &dolfin::AssemblyPlan::assemble)
+      .def("valid", &dolfin::AssemblyPlan::valid)
+      .def("direct", &dolfin::AssemblyPlan::direct)
+      .def("clear", &dolfin::AssemblyPlan::clear);
+
+    // dolfin::MatrixFreeOperator
+    py::class_<dolfin::MatrixFreeOperator, std::shared_ptr<dolfin::MatrixFreeOperator>,
+               dolfin::LinearOperator>
+      (m, "MatrixFreeOperator", "Linear operator defined by assembling the action of a form")
+      .def(py::init<std::shared_ptr<const dolfin::Form>, std::shared_ptr<dolfin::Function>,
+           std::shared_ptr<const dolfin::Form>>(),
+           py::arg("a_action"), py::arg("u"), py::arg("a")=nullptr)
+      .def("size", &dolfin::MatrixFreeOperator::size)
+      .def("mult", &dolfin::MatrixFreeOperator::mult)
+      .def("get_diagonal", &dolfin::MatrixFreeOperator::get_diagonal);
+
     // dolfin::SystemAssembler
     py::class_<dolfin::SystemAssembler, std::shared_ptr<dolfin::SystemAssembler>, dolfin::AssemblerBase>
       (m, "SystemAssembler", "DOLFIN SystemAssembler object")
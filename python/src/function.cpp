@@ -270,6 +270,20 @@ namespace dolfin_wrappers
             self.eval(_values, x);
             return values;
           })
+      .def("eval_points", [](const dolfin::Function& self,
+                             py::array_t<double, py::array::c_style | py::array::forcecast> x,
+                             std::vector<unsigned int> cells)
+           {
+             std::vector<double> _x(x.data(), x.data() + x.size());
+             std::vector<double> values;
+             self.eval(values, _x, cells);
+             const std::size_t num_points = cells.size();
+             py::array_t<double> _values({num_points, values.size()/std::max(num_points, (std::size_t) 1)},
+                                         values.data());
+             return py::make_tuple(_values,
+                                   py::array_t<unsigned int>(cells.size(), cells.data()));
+           }, py::arg("x"), py::arg("cells"),
+           "Evaluate function at points (rows of x), with optional cell hints")
       .def("extrapolate", &dolfin::Function::extrapolate)
       .def("extrapolate", [](dolfin::Function& instance, const py::object v)
            {
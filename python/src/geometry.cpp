@@ -29,6 +29,7 @@
 #include <dolfin/geometry/CollisionPredicates.h>
 #include <dolfin/geometry/IntersectionConstruction.h>
 #include <dolfin/geometry/Point.h>
+#include <dolfin/geometry/WideBoundingBoxTree.h>
 #include <dolfin/mesh/Mesh.h>
 
 namespace py = pybind11;
@@ -60,7 +61,48 @@ namespace dolfin_wrappers
 	   &dolfin::BoundingBoxTree::compute_entity_collisions)
       .def("compute_first_collision", &dolfin::BoundingBoxTree::compute_first_collision)
       .def("compute_first_entity_collision", &dolfin::BoundingBoxTree::compute_first_entity_collision)
-      .def("compute_closest_entity", &dolfin::BoundingBoxTree::compute_closest_entity);
+      .def("compute_closest_entity", &dolfin::BoundingBoxTree::compute_closest_entity)
+      .def("compute_first_entity_collisions",
+           [](const dolfin::BoundingBoxTree& self,
+              py::array_t<double, py::array::c_style | py::array::forcecast> x)
+           {
+             if (x.ndim() != 2 or (std::size_t) x.shape(1) != self.gdim())
+               throw py::value_error("Points must be a 2D array with one row per point and gdim columns");
+             std::vector<double> _x(x.data(), x.data() + x.size());
+             std::vector<unsigned int> entities
+               = self.compute_first_entity_collisions(_x);
+             return py::array_t<unsigned int>(entities.size(), entities.data());
+           }, py::arg("x"),
+           "Compute first entity collision for each point (row) in x")
+      .def("compute_closest_entities",
+           [](const dolfin::BoundingBoxTree& self,
+              py::array_t<double, py::array::c_style | py::array::forcecast> x)
+           {
+             if (x.ndim() != 2 or (std::size_t) x.shape(1) != self.gdim())
+               throw py::value_error("Points must be a 2D array with one row per point and gdim columns");
+             std::vector<double> _x(x.data(), x.data() + x.size());
+             auto closest = self.compute_closest_entities(_x);
+             return py::make_tuple(
+               py::array_t<unsigned int>(closest.first.size(), closest.first.data()),
+               py::array_t<double>(closest.second.size(), closest.second.data()));
+           }, py::arg("x"),
+           "Compute closest entity and distance for each point (row) in x");
+
+    // dolfin::WideBoundingBoxTree
+    py::class_<dolfin::WideBoundingBoxTree, std::shared_ptr<dolfin::WideBoundingBoxTree>>
+      (m, "WideBoundingBoxTree")
+      .def(py::init<>())
+      .def("build", (void (dolfin::WideBoundingBoxTree::*)(const dolfin::Mesh&))
+           &dolfin::WideBoundingBoxTree::build)
+      .def("build", (void (dolfin::WideBoundingBoxTree::*)(const dolfin::Mesh&, std::size_t))
+           &dolfin::WideBoundingBoxTree::build)
+      .def("compute_collisions", &dolfin::WideBoundingBoxTree::compute_collisions)
+      .def("compute_entity_collisions", &dolfin::WideBoundingBoxTree::compute_entity_collisions)
+      .def("compute_first_collision", &dolfin::WideBoundingBoxTree::compute_first_collision)
+      .def("compute_first_entity_collision", &dolfin::WideBoundingBoxTree::compute_first_entity_collision)
+      .def("collides", &dolfin::WideBoundingBoxTree::collides)
+      .def("collides_entity", &dolfin::WideBoundingBoxTree::collides_entity)
+      .def("num_nodes", &dolfin::WideBoundingBoxTree::num_nodes);
 
     // dolfin::Point
     py::class_<dolfin::Point>(m, "Point")
@@ -236,6 +236,9 @@ namespace dolfin_wrappers
       .def("__exit__", [](dolfin::HDF5File& self, py::args args, py::kwargs kwargs){ self.close(); })
       .def("close", &dolfin::HDF5File::close)
       .def("flush", &dolfin::HDF5File::flush)
+      .def("set_compression", &dolfin::HDF5File::set_compression,
+           py::arg("name"), py::arg("compression"),
+           py::arg("compression_level")=4)
       // read
       .def("read", (void (dolfin::HDF5File::*)(dolfin::Mesh&, std::string, bool) const) &dolfin::HDF5File::read)
       .def("read", (void (dolfin::HDF5File::*)(dolfin::MeshValueCollection<bool>&, std::string) const)
@@ -312,7 +315,8 @@ namespace dolfin_wrappers
       .def(py::init<std::string>())
       .def("__enter__", [](dolfin::XDMFFile& self){ return &self; })
       .def("__exit__", [](dolfin::XDMFFile& self, py::args args, py::kwargs kwargs){ self.close(); })
-      .def("close", &dolfin::XDMFFile::close);
+      .def("close", &dolfin::XDMFFile::close)
+      .def("wait", &dolfin::XDMFFile::wait);
 
     // dolfin::XDMFFile::Encoding enums
     py::enum_<dolfin::XDMFFile::Encoding>(xdmf_file, "Encoding")
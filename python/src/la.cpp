@@ -118,6 +118,12 @@ namespace
       PYBIND11_OVERLOAD_INT(void, LinearOperatorBase, "mult", &x, &y);
       py::pybind11_fail("Tried to call pure virtual function \'mult\'");
     }
+
+    void get_diagonal(dolfin::GenericVector& x) const
+    {
+      PYBIND11_OVERLOAD_INT(void, LinearOperatorBase, "get_diagonal", &x);
+      LinearOperatorBase::get_diagonal(x);
+    }
   };
 
 }
@@ -139,7 +145,9 @@ namespace dolfin_wrappers
                self.local_to_global_unowned().data(),
                self.local_to_global_unowned().size()); },
            py::return_value_policy::reference_internal,
-           "Return view into unowned part of local-to-global map");
+           "Return view into unowned part of local-to-global map")
+      .def("off_process_owner", &dolfin::IndexMap::off_process_owner)
+      .def("neighbours", &dolfin::IndexMap::neighbours);
 
     // dolfin::IndexMap enums
     py::enum_<dolfin::IndexMap::MapSize>(index_map, "MapSize")
@@ -150,10 +158,13 @@ namespace dolfin_wrappers
 
     // dolfin::SparsityPattern
     py::class_<dolfin::SparsityPattern, std::shared_ptr<dolfin::SparsityPattern>>(m, "SparsityPattern")
-      .def("init", &dolfin::SparsityPattern::init)
+      .def("init", &dolfin::SparsityPattern::init, py::arg("index_maps"),
+           py::arg("block_size")=1)
+      .def("block_size", &dolfin::SparsityPattern::block_size)
       .def("apply", &dolfin::SparsityPattern::apply)
       .def("str", &dolfin::SparsityPattern::str)
       .def("num_nonzeros", &dolfin::SparsityPattern::num_nonzeros)
+      .def("peak_memory_usage", &dolfin::SparsityPattern::peak_memory_usage)
       .def("num_nonzeros_diagonal", [](const dolfin::SparsityPattern& instance)
            {
              std::vector<std::size_t> num_nonzeros;
@@ -831,6 +842,10 @@ namespace dolfin_wrappers
       .def("get_options_prefix", &dolfin::PETScVector::get_options_prefix)
       .def("set_options_prefix", &dolfin::PETScVector::set_options_prefix)
       .def("update_ghost_values", &dolfin::PETScVector::update_ghost_values)
+      .def("update_ghost_values_begin",
+           &dolfin::PETScVector::update_ghost_values_begin)
+      .def("update_ghost_values_end",
+           &dolfin::PETScVector::update_ghost_values_end)
       .def("vec", &dolfin::PETScVector::vec, "Return underlying PETSc Vec object");
 
     // dolfin::PETScBaseMatrix
@@ -94,7 +94,18 @@ namespace dolfin_wrappers
       .def("dim", &dolfin::MeshGeometry::dim, "Geometrical dimension")
       .def("degree", &dolfin::MeshGeometry::degree, "Degree")
       .def("get_entity_index", &dolfin::MeshGeometry::get_entity_index)
-      .def("num_entity_coordinates", &dolfin::MeshGeometry::num_entity_coordinates);
+      .def("num_entity_coordinates", &dolfin::MeshGeometry::num_entity_coordinates)
+      .def("init_packed_coordinate_dofs", &dolfin::MeshGeometry::init_packed_coordinate_dofs)
+      .def("clear_packed_coordinate_dofs", &dolfin::MeshGeometry::clear_packed_coordinate_dofs)
+      .def("has_packed_coordinate_dofs", &dolfin::MeshGeometry::has_packed_coordinate_dofs)
+      .def("packed_coordinate_dofs", [](const dolfin::MeshGeometry& self, std::size_t cell_index)
+           {
+             auto x = self.packed_coordinate_dofs(cell_index);
+             return py::array_t<double>(x.size(), x.data());
+           })
+      .def("packed_coordinate_dofs_memory", &dolfin::MeshGeometry::packed_coordinate_dofs_memory)
+      .def("modification_count", &dolfin::MeshGeometry::modification_count)
+      .def("mark_modified", &dolfin::MeshGeometry::mark_modified);
 
     // dolfin::MeshTopology class
     py::class_<dolfin::MeshTopology, std::shared_ptr<dolfin::MeshTopology>, dolfin::Variable>
@@ -110,6 +121,8 @@ namespace dolfin_wrappers
            &dolfin::MeshTopology::operator(), py::return_value_policy::reference_internal)
       .def("size", &dolfin::MeshTopology::size)
       .def("hash", &dolfin::MeshTopology::hash)
+      .def("modification_count", &dolfin::MeshTopology::modification_count)
+      .def("mark_modified", &dolfin::MeshTopology::mark_modified)
       .def("init_global_indices", &dolfin::MeshTopology::init_global_indices)
       .def("have_global_indices", &dolfin::MeshTopology::have_global_indices)
       .def("ghost_offset", &dolfin::MeshTopology::ghost_offset)
@@ -147,6 +160,9 @@ namespace dolfin_wrappers
            &dolfin::Mesh::color)
       .def("coordinates", [](dolfin::Mesh& self)
            {
+             // The returned array may be used to modify the
+             // coordinates, which cannot be detected
+             self.geometry().mark_modified();
              return Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
                (self.geometry().x().data(),
                 self.geometry().num_points(),
@@ -184,6 +200,7 @@ namespace dolfin_wrappers
       .def("num_cells", &dolfin::Mesh::num_cells, "Number of cells")
       .def("order", &dolfin::Mesh::order)
       .def("ordered", &dolfin::Mesh::ordered)
+      .def("renumber_by_hilbert_curve", &dolfin::Mesh::renumber_by_hilbert_curve)
       .def("rmax", &dolfin::Mesh::rmax)
       .def("rmin", &dolfin::Mesh::rmin)
       .def("rotate", (void (dolfin::Mesh::*)(double, std::size_t, const dolfin::Point&))
@@ -442,8 +459,12 @@ namespace dolfin_wrappers
            &dolfin::MeshValueCollection<SCALAR>::set_value) \
       .def("set_value", (bool (dolfin::MeshValueCollection<SCALAR>::*)(std::size_t, std::size_t, const SCALAR&)) \
            &dolfin::MeshValueCollection<SCALAR>::set_value) \
-      .def("values", (std::map<std::pair<std::size_t, std::size_t>, SCALAR>& (dolfin::MeshValueCollection<SCALAR>::*)()) \
-           &dolfin::MeshValueCollection<SCALAR>::values, py::return_value_policy::reference) \
+      .def("set_values", (void (dolfin::MeshValueCollection<SCALAR>::*)(const std::vector<std::size_t>&, const std::vector<SCALAR>&)) \
+           &dolfin::MeshValueCollection<SCALAR>::set_values) \
+      .def("set_values", (void (dolfin::MeshValueCollection<SCALAR>::*)(const std::vector<std::size_t>&, const std::vector<std::size_t>&, const std::vector<SCALAR>&)) \
+           &dolfin::MeshValueCollection<SCALAR>::set_values) \
+      .def("values", [](const dolfin::MeshValueCollection<SCALAR>& self) \
+           { return std::map<std::pair<std::size_t, std::size_t>, SCALAR>(self.values().begin(), self.values().end()); }) \
       .def("assign", [](dolfin::MeshValueCollection<SCALAR>& self, const dolfin::MeshFunction<SCALAR>& mf) { self = mf; }) \
       .def("assign", [](dolfin::MeshValueCollection<SCALAR>& self, const dolfin::MeshValueCollection<SCALAR>& other) \
          { self = other; })
@@ -106,6 +106,9 @@ namespace dolfin_wrappers
       .def("converged", &PyPublicNewtonSolver::converged)
       .def("solver_setup", &PyPublicNewtonSolver::solver_setup)
       .def("update_solution", &PyPublicNewtonSolver::update_solution)
+      .def("iteration", &dolfin::NewtonSolver::iteration)
+      .def("krylov_iterations", &dolfin::NewtonSolver::krylov_iterations)
+      .def("jacobian_updates", &dolfin::NewtonSolver::jacobian_updates)
       .def("linear_solver", &dolfin::NewtonSolver::linear_solver, py::return_value_policy::reference);
 
 #ifdef HAS_PETSC
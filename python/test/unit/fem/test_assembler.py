@@ -26,7 +26,8 @@ import os
 import numpy
 from dolfin import *
 
-from dolfin_utils.test import skip_in_parallel, filedir, pushpop_parameters
+from dolfin_utils.test import skip_in_parallel, skip_if_not_PETSc, filedir, \
+    pushpop_parameters
 
 
 def test_cell_size_assembly_1D():
@@ -77,6 +78,155 @@ def test_cell_assembly():
     assert round(assemble(L).norm("l2") - b_l2_norm, 10) == 0
 
 
+@pytest.mark.parametrize("mode", [
+    pytest.param(("num_threads", 4),
+                 marks=pytest.mark.skipif(not has_openmp(),
+                                          reason="DOLFIN not built with OpenMP")),
+    ("overlap_assembly_communication", True)])
+@pytest.mark.parametrize("ghost_mode", ["none", "shared_facet"])
+def test_cell_assembly_modes(mode, ghost_mode, pushpop_parameters):
+    parameters["ghost_mode"] = ghost_mode
+    mesh = UnitCubeMesh(6, 5, 4)
+    V = VectorFunctionSpace(mesh, "CG", 2)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    c = Constant((10, 20, 30))
+    f = Expression("1.0 + x[0]*x[1]", degree=2)
+
+    # Mark cells so that the integral changes between cells and some
+    # cells have no integral
+    domains = MeshFunction("size_t", mesh, mesh.topology().dim(), 0)
+    AutoSubDomain(lambda x: x[0] < 0.3).mark(domains, 1)
+    AutoSubDomain(lambda x: x[0] > 0.7).mark(domains, 2)
+    dx = Measure("dx", domain=mesh, subdomain_data=domains)
+
+    a = f*inner(grad(v), grad(u))*dx(0) + 2.0*inner(v, u)*dx(1)
+    L = f*inner(v, c)*dx(0) + v[0]*dx(1) + v[0]*ds
+    M = f*f*dx(0) + inner(c, c)*dx(1)
+
+    # Lagrange multiplier form, where all cells share the global dof
+    W = FunctionSpace(mesh, MixedElement([FiniteElement("CG", mesh.ufl_cell(), 1),
+                                          FiniteElement("R", mesh.ufl_cell(), 0)]))
+    (w, r), (z, s) = TrialFunctions(W), TestFunctions(W)
+    a_r = inner(grad(w), grad(z))*dx + r*z*dx + w*s*dx
+
+    # Reference with the default assembly mode
+    A0, b0, m0, R0 = assemble(a), assemble(L), assemble(M), assemble(a_r)
+
+    parameters[mode[0]] = mode[1]
+    A1, b1, m1, R1 = assemble(a), assemble(L), assemble(M), assemble(a_r)
+
+    A1.axpy(-1.0, A0, True)
+    b1.axpy(-1.0, b0)
+    R1.axpy(-1.0, R0, True)
+    errors = [A1.norm("frobenius"), b1.norm("l2"), abs(m1 - m0),
+              R1.norm("frobenius")]
+
+    # Threaded assembly inserts in serial cell order, so the result is
+    # identical; the other modes change the order of summation
+    if mode[0] == "num_threads":
+        assert errors == [0.0]*4
+    else:
+        assert [round(e, 10) for e in errors] == [0.0]*4
+
+
+@skip_if_not_PETSc
+@pytest.mark.parametrize("form, storage", [("vector", "block"),
+                                           ("vector", "symmetric_block"),
+                                           ("vector_nonsymmetric", "block"),
+                                           ("scalar_nonsymmetric", "block")])
+def test_block_matrix_assembly(form, storage, pushpop_parameters):
+    parameters["linear_algebra_backend"] = "PETSc"
+    mesh = UnitCubeMesh(4, 3, 5)
+    if form == "scalar_nonsymmetric":
+        V = FunctionSpace(mesh, "CG", 2)
+        f, zero = Constant(10), Constant(0)
+    else:
+        V = VectorFunctionSpace(mesh, "CG", 2)
+        f, zero = Constant((10, 20, 30)), Constant((0, 0, 0))
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    w = Constant((1, 2, 3))
+    bc = DirichletBC(V, zero, "on_boundary && x[0] < DOLFIN_EPS")
+
+    if form == "vector":
+        a = inner(sym(grad(v)), sym(grad(u)))*dx + 2.0*inner(v, u)*ds
+    else:
+        a = inner(grad(v), grad(u))*dx + inner(v, dot(grad(u), w))*dx
+    L = inner(v, f)*dx
+
+    # Reference with scalar storage
+    A0, b0 = assemble_system(a, L, bc)
+    x = Vector()
+    A0.init_vector(x, 1)
+    x.set_local(numpy.arange(*x.local_range(), dtype=numpy.float_))
+    x.apply("insert")
+    y0 = A0*x
+
+    # Symmetric block storage is requested for the matrix through the
+    # options database
+    parameters["matrix_block_storage"] = "block"
+    A1, b1 = PETScMatrix(), PETScVector()
+    if storage == "symmetric_block":
+        A1.set_options_prefix("test_symmetric_")
+        PETScOptions.set("test_symmetric_mat_type", "sbaij")
+    assemble_system(a, L, bc, A_tensor=A1, b_tensor=b1)
+    if storage == "symmetric_block":
+        PETScOptions.clear("test_symmetric_mat_type")
+    y1 = A1*x
+
+    y1.axpy(-1.0, y0)
+    b1.axpy(-1.0, b0)
+    assert round(y1.norm("l2")/y0.norm("l2"), 10) == 0
+    assert round(b1.norm("l2"), 10) == 0
+
+
+def test_assembly_plan():
+    mesh = UnitSquareMesh(12, 12)
+    V = FunctionSpace(mesh, "CG", 2)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+    f = Function(V)
+    f.vector()[:] = 1.0
+
+    a = f*inner(grad(v), grad(u))*dx + f*v*u*ds
+    plan = AssemblyPlan(a)
+
+    A = Matrix()
+    for k in range(3):
+        f.vector()[:] = 1.0 + k
+        plan.assemble(A)
+        assert plan.valid(A)
+
+        # Sequential AIJ storage is filled directly
+        if MPI.size(mesh.mpi_comm()) == 1:
+            assert plan.direct()
+
+        # Compare with standard assembler
+        A0 = assemble(a)
+        A0.axpy(-1.0, A, True)
+        assert round(A0.norm("frobenius"), 10) == 0
+
+    # Plan must be rebuilt for a new matrix
+    B = Matrix()
+    assert not plan.valid(B)
+    plan.assemble(B)
+    assert plan.valid(B)
+    assert not plan.valid(A)
+
+    # Plan must be rebuilt when the mesh is reordered
+    mesh.order()
+    assert not plan.valid(B)
+
+    # Interior facet integrals fall back to standard assembler
+    plan = AssemblyPlan(avg(v)*avg(u)*dS)
+    plan.assemble(Matrix())
+    assert not plan.direct()
+
+
 def test_facet_assembly(pushpop_parameters):
     parameters["ghost_mode"] = "shared_facet"
     mesh = UnitSquareMesh(24, 24)
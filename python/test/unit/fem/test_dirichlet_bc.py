@@ -251,6 +251,42 @@ def test_nocaching_values():
         assert numpy.allclose(x.get_local(), 2.0)
 
 
+def test_cached_dofs():
+    """Cached dofs must give the same boundary values as the
+    uncached computation, for time-dependent values and after mesh
+    motion"""
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "P", 2)
+    g = Expression("t*(1.0 + x[1])", t=0.0, degree=2)
+
+    for method in ["topological", "geometric", "pointwise"]:
+        bc0 = DirichletBC(V, g, "near(x[0], 1.0)", method=method)
+        bc1 = DirichletBC(V, g, "near(x[0], 1.0)", method=method)
+        bc1.parameters["cache_dofs"] = True
+
+        for step in range(3):
+            # Move mesh for geometric methods (for the topological
+            # method, the facets are marked on the first application)
+            if step == 2 and method != "topological":
+                mesh.translate(Point(1.0, 0.0))
+
+            g.t = step + 1.0
+            bv0 = bc0.get_boundary_values()
+            bv1 = bc1.get_boundary_values()
+            assert sorted(bv0.keys()) == sorted(bv1.keys())
+            for dof in bv0:
+                assert numpy.isclose(bv0[dof], bv1[dof])
+
+            x0 = Function(V).vector()
+            x1 = Function(V).vector()
+            bc0.apply(x0)
+            bc1.apply(x1)
+            assert numpy.allclose(x0.get_local(), x1.get_local())
+
+        if method != "topological":
+            mesh.translate(Point(-1.0, 0.0))
+
+
 def test_get_value():
     mesh = UnitSquareMesh(4, 4)
 
@@ -27,6 +27,8 @@ from dolfin_utils.test import *
 
 
 xfail = pytest.mark.xfail(strict=True)
+skip_if_not_SCOTCH = pytest.mark.skipif(not has_scotch(),
+                                        reason="Skipping unit test(s) depending on SCOTCH.")
 
 @fixture
 def mesh():
@@ -562,3 +564,120 @@ def test_readonly_view_local_to_global_unwoned(mesh):
     assert all(l2gu < V.dofmap().global_dimension())
     del l2gu
     assert sys.getrefcount(index_map) == rc
+
+
+
+def test_cells_with_unowned_dofs(mesh):
+    V = FunctionSpace(mesh, "P", 2)
+    dofmap = V.dofmap()
+    num_owned = dofmap.index_map().size(IndexMap.MapSize.OWNED)
+    expected = [c for c in range(mesh.num_cells())
+                if np.any(dofmap.cell_dofs(c) >= num_owned)]
+    assert dofmap.cells_with_unowned_dofs() == expected
+    if MPI.size(mesh.mpi_comm()) == 1:
+        assert expected == []
+
+    # Cells are computed once and stored with the dofmap
+    assert dofmap.cells_with_unowned_dofs() == expected
+
+@skip_in_parallel
+def test_cell_order_dof_ordering(pushpop_parameters):
+    "Dofs numbered in cell order are visited in order by the cell loop"
+    parameters["dof_ordering_library"] = "cell_order"
+    mesh = UnitSquareMesh(5, 7).renumber_by_hilbert_curve()
+    V = FunctionSpace(mesh, "P", 2)
+    dofmap = V.dofmap()
+
+    num_visited = 0
+    for c in range(mesh.num_cells()):
+        dofs = dofmap.cell_dofs(c)
+        assert max(dofs) < num_visited + len(dofs)
+        num_visited = max(num_visited, max(dofs) + 1)
+    assert num_visited == V.dim()
+
+
+@pytest.mark.parametrize("dof_ordering", ["none", "rcm", "cell_order",
+                                          "hilbert", "random",
+                                          pytest.param("gps", marks=skip_if_not_SCOTCH),
+                                          pytest.param("nested_dissection",
+                                                       marks=skip_if_not_SCOTCH)])
+def test_dof_ordering(dof_ordering):
+    mesh = UnitSquareMesh(8, 9)
+    V = FunctionSpace(mesh, "P", 2, dof_ordering=dof_ordering)
+    dofmap = V.dofmap()
+    assert dofmap.dof_ordering() == dof_ordering
+
+    # Owned dofs are a permutation of the local range
+    num_owned = dofmap.index_map().size(IndexMap.MapSize.OWNED)
+    dofs = np.unique(np.concatenate([dofmap.cell_dofs(c)
+                                     for c in range(mesh.num_cells())]))
+    assert np.array_equal(dofs[dofs < num_owned], np.arange(num_owned))
+
+    # Functions do not depend on the ordering
+    u = interpolate(Expression("x[0]*x[1]", degree=2), V)
+    assert round(assemble(u*dx) - 0.25, 10) == 0
+
+    bandwidth, profile = dofmap.compute_bandwidth_and_profile()
+    assert bandwidth < num_owned
+    assert profile <= bandwidth*num_owned
+
+
+@skip_in_parallel
+def test_bandwidth_and_profile():
+    mesh = UnitSquareMesh(16, 16)
+    V0 = FunctionSpace(mesh, "P", 1, dof_ordering="rcm")
+    V1 = FunctionSpace(mesh, "P", 1, dof_ordering="random")
+    b0, p0 = V0.dofmap().compute_bandwidth_and_profile()
+    b1, p1 = V1.dofmap().compute_bandwidth_and_profile()
+    assert b0 < b1
+    assert p0 < p1
+
+    # P1 on a 1 x 1 mesh (two cells) with UFC ordering: dofs 0, 1, 3 and 0, 2, 3
+    mesh = UnitSquareMesh(1, 1)
+    V = FunctionSpace(mesh, "P", 1, dof_ordering="none")
+    assert V.dofmap().compute_bandwidth_and_profile() == (3, 0 + 1 + 2 + 3)
+
+
+@pytest.mark.parametrize("ghost_mode", ["none", "shared_facet",
+                                        "shared_vertex"])
+def test_dofmap_communication(ghost_mode, pushpop_parameters):
+    parameters["ghost_mode"] = ghost_mode
+    mesh = UnitCubeMesh(5, 4, 3)
+    dofmaps = []
+    norms = []
+    for comm in ["global", "neighbourhood"]:
+        parameters["dofmap_communication"] = comm
+        V = FunctionSpace(mesh, "P", 2)
+        dofmap = V.dofmap()
+        dofmaps.append(dofmap)
+
+        # Owned dofs add up to the global dimension
+        num_owned = dofmap.index_map().size(IndexMap.MapSize.OWNED)
+        N = dofmap.global_dimension()
+        assert MPI.sum(mesh.mpi_comm(), num_owned) == N
+
+        # Owned dofs are numbered by the local range, and each global
+        # index is owned by exactly one process
+        local_to_global = dofmap.tabulate_local_to_global_dofs()
+        r0, r1 = dofmap.ownership_range()
+        assert np.array_equal(local_to_global[:num_owned], np.arange(r0, r1))
+        owned_sum = float(np.sum(local_to_global[:num_owned]))
+        assert MPI.sum(mesh.mpi_comm(), owned_sum) == N*(N - 1)/2
+        ghosts = local_to_global[num_owned:]
+        assert np.all((ghosts < r0) | (ghosts >= r1))
+        assert np.all(ghosts < N)
+
+        # Global indices of shared dofs are consistent across processes
+        u = interpolate(Expression("x[0] + 2*x[1] + 3*x[2]", degree=1), V)
+        assert round(assemble(u*dx) - 3.0, 10) == 0
+        v, w = TestFunction(V), TrialFunction(V)
+        norms.append((assemble(inner(grad(v), grad(w))*dx + v*w*dx).norm("frobenius"),
+                      assemble(u*v*dx).norm("l2")))
+
+    # Same number of dofs are shared, with the same processes
+    assert sorted(dofmaps[0].neighbours()) == sorted(dofmaps[1].neighbours())
+    assert len(dofmaps[0].shared_nodes()) == len(dofmaps[1].shared_nodes())
+
+    # Assembled tensors are the same
+    for n0, n1 in zip(*norms):
+        assert round(n0 - n1, 10) == 0
@@ -123,3 +123,143 @@ def test_nonlinear_variational_solver_custom_comm():
         solve(F == 0, u, solver_parameters={"nonlinear_solver": "newton"})
         if has_petsc():
             solve(F == 0, u, solver_parameters={"nonlinear_solver": "snes"})
+
+
+@pytest.mark.parametrize("reuse", ["symbolic", "interval",
+                                   "slow_convergence"])
+def test_newton_factorisation_reuse(reuse):
+    "Check that the Newton solver converges when reusing the Jacobian"
+
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    v = TestFunction(V)
+    bc = DirichletBC(V, 0.0, "on_boundary")
+
+    def solve_problem(reuse):
+        u = Function(V)
+        F = (1.0 + u**2)*inner(grad(u), grad(v))*dx - Constant(5.0)*v*dx
+
+        class Problem(NonlinearProblem):
+            def __init__(self):
+                NonlinearProblem.__init__(self)
+                self.num_jacobians = 0
+            def F(self, b, x):
+                assemble(F, tensor=b)
+                bc.apply(b, x)
+            def J(self, A, x):
+                assemble(derivative(F, u), tensor=A)
+                bc.apply(A)
+                self.num_jacobians += 1
+
+        solver = NewtonSolver()
+        solver.parameters["linear_solver"] = "lu"
+        solver.parameters["factorisation_reuse"] = reuse
+        solver.parameters["relative_tolerance"] = 1.0e-10
+        solver.parameters["maximum_iterations"] = 50
+        problem = Problem()
+        num_iterations, converged = solver.solve(problem, u.vector())
+        assert converged
+        assert solver.jacobian_updates() == problem.num_jacobians
+        return u, num_iterations, problem.num_jacobians
+
+    u0, num_iterations0, num_jacobians0 = solve_problem("none")
+    u1, num_iterations1, num_jacobians1 = solve_problem(reuse)
+    assert num_jacobians0 == num_iterations0
+    assert num_jacobians1 <= num_iterations1
+    if reuse == "interval":
+        assert num_jacobians1 < num_iterations1
+
+    u1.vector().axpy(-1.0, u0.vector())
+    assert u1.vector().norm("l2") < 1.0e-6*u0.vector().norm("l2")
+
+    # Check that the parameters are passed on by the nonlinear
+    # variational solver
+    u = Function(V)
+    F = (1.0 + u**2)*inner(grad(u), grad(v))*dx - Constant(5.0)*v*dx
+    solve(F == 0, u, bc,
+          solver_parameters={"newton_solver":
+                             {"linear_solver": "lu",
+                              "factorisation_reuse": reuse,
+                              "relative_tolerance": 1.0e-10,
+                              "maximum_iterations": 50}})
+    u.vector().axpy(-1.0, u0.vector())
+    assert u.vector().norm("l2") < 1.0e-6*u0.vector().norm("l2")
+
+
+@skip_in_parallel
+def test_newton_symbolic_factorisation_reuse_eigen(pushpop_parameters):
+    "Check that the Eigen LU solver reuses the symbolic factorisation"
+
+    if not has_linear_algebra_backend("Eigen"):
+        pytest.skip("Need Eigen as backend to run this test")
+    parameters["linear_algebra_backend"] = "Eigen"
+
+    symbolic = "Eigen LU symbolic factorisation"
+    numeric = "Eigen LU numeric factorisation"
+
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    v = TestFunction(V)
+    bc = DirichletBC(V, 0.0, "on_boundary")
+
+    def solve_problem(reuse):
+        u = Function(V)
+        F = (1.0 + u**2)*inner(grad(u), grad(v))*dx - Constant(5.0)*v*dx
+
+        class Problem(NonlinearProblem):
+            def F(self, b, x):
+                assemble(F, tensor=b)
+                bc.apply(b, x)
+            def J(self, A, x):
+                assemble(derivative(F, u), tensor=A)
+                bc.apply(A)
+
+        solver = NewtonSolver()
+        solver.parameters["linear_solver"] = "lu"
+        solver.parameters["factorisation_reuse"] = reuse
+        solver.parameters["relative_tolerance"] = 1.0e-10
+        timings(TimingClear.clear, [TimingType.wall])
+        num_iterations, converged = solver.solve(Problem(), u.vector())
+        assert converged
+        num_updates = solver.jacobian_updates()
+        assert num_updates > 1
+        return (u, num_updates, timing(symbolic, TimingClear.clear)[0],
+                timing(numeric, TimingClear.clear)[0])
+
+    # Without reuse, each Jacobian update is factorised from scratch
+    u0, num_updates, num_symbolic, num_numeric = solve_problem("none")
+    assert num_symbolic == num_updates
+    assert num_numeric == num_updates
+
+    # With reuse, the factorisation object is kept and only the numeric
+    # factorisation is recomputed
+    u1, num_updates, num_symbolic, num_numeric = solve_problem("symbolic")
+    assert num_symbolic == 1
+    assert num_numeric == num_updates
+
+    u1.vector().axpy(-1.0, u0.vector())
+    assert u1.vector().norm("l2") < 1.0e-10*u0.vector().norm("l2")
+
+    # A changed sparsity pattern falls back to a full factorisation
+    W = FunctionSpace(mesh, "DG", 0)
+    p, q = TrialFunction(W), TestFunction(W)
+    A0 = assemble(p*q*dx)
+    A1 = assemble(p*q*dx + jump(p)*jump(q)*dS)
+    A2 = assemble(2.0*p*q*dx + jump(p)*jump(q)*dS)
+    b = assemble(q*dx)
+
+    timings(TimingClear.clear, [TimingType.wall])
+    solver = LUSolver()
+    solver.parameters["reuse_symbolic_factorisation"] = True
+    x = Vector()
+    for A in (A0, A1, A2):
+        solver.set_operator(A)
+        solver.solve(x, b)
+    assert timing(symbolic, TimingClear.clear)[0] == 2
+    assert timing(numeric, TimingClear.clear)[0] == 3
+
+    # Check solution for the last operator
+    x_ref = Vector()
+    LUSolver(A2).solve(x_ref, b)
+    x.axpy(-1.0, x_ref)
+    assert x.norm("l2") < 1.0e-12*x_ref.norm("l2")
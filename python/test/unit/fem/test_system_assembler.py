@@ -181,6 +181,42 @@ def test_facet_assembly():
     parameters["ghost_mode"] = "none"
 
 
+@pytest.mark.skipif(not has_openmp(), reason="DOLFIN not built with OpenMP")
+def test_threaded_facet_assembly(pushpop_parameters):
+    parameters["ghost_mode"] = "shared_facet"
+    mesh = UnitSquareMesh(24, 24)
+    V = FunctionSpace(mesh, "DG", 1)
+
+    v = TestFunction(V)
+    u = TrialFunction(V)
+
+    n = FacetNormal(mesh)
+    h = CellDiameter(mesh)
+    h_avg = (h('+') + h('-'))/2
+    f = Constant(1.0)
+
+    a = dot(grad(v), grad(u))*dx \
+        - dot(avg(grad(v)), jump(u, n))*dS \
+        - dot(jump(v, n), avg(grad(u)))*dS \
+        + 4.0/h_avg*dot(jump(v, n), jump(u, n))*dS
+    L = v*f*dx
+    bc = DirichletBC(V, Constant(1.0), "on_boundary", "pointwise")
+
+    def assemble_system(num_threads):
+        parameters["num_threads"] = num_threads
+        A, b = Matrix(), Vector()
+        SystemAssembler(a, L, bc).assemble(A, b)
+        return A, b
+
+    # Threaded assembly adds element tensors in serial facet order, so
+    # the result is identical to serial assembly
+    A0, b0 = assemble_system(0)
+    for num_threads in (1, 4):
+        A, b = assemble_system(num_threads)
+        assert numpy.array_equal(A.array(), A0.array())
+        assert numpy.array_equal(b.get_local(), b0.get_local())
+
+
 def test_vertex_assembly():
 
     # Create mesh and define function space
@@ -269,6 +269,43 @@ def test_call(R, V, W, mesh):
     with pytest.raises(TypeError):
         u0([0, 0])
 
+@skip_in_parallel
+def test_eval_points(V, W, mesh):
+    import numpy
+    u1 = Function(V)
+    u2 = Function(W)
+    u1.interpolate(Expression("x[0] + x[1] + x[2]", degree=1))
+    u2.interpolate(Expression(("x[0] + x[1] + x[2]",
+                               "x[0] - x[1] - x[2]",
+                               "x[0] + x[1] + x[2]"), degree=1))
+
+    numpy.random.seed(1)
+    x = numpy.random.uniform(0.0, 1.0, (40, 3))
+
+    values, cells = u1.eval_points(x)
+    assert values.shape == (40, 1)
+    assert len(cells) == 40
+    for p, v in zip(x, values):
+        assert round(v[0] - u1(p), 7) == 0
+
+    values, cells = u2.eval_points(x)
+    assert values.shape == (40, 3)
+    for p, v in zip(x, values):
+        assert numpy.allclose(v, u2(p))
+
+    # Move points slightly and reuse cells as hints
+    x += 0.01*(0.5 - x)
+    values, cells = u2.eval_points(x, cells)
+    for p, v, c in zip(x, values, cells):
+        assert numpy.allclose(v, u2(p))
+        assert Cell(mesh, int(c)).collides(Point(*p))
+
+    # Invalid hints are ignored
+    values, cells = u2.eval_points(x, numpy.zeros(40, dtype=numpy.uint32))
+    for p, v in zip(x, values):
+        assert numpy.allclose(v, u2(p))
+
+
 def test_constant_float_conversion():
     c = Constant(3.45)
     assert float(c) == 3.45
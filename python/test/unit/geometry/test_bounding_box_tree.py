@@ -20,12 +20,15 @@
 import pytest
 import numpy
 
-from dolfin import BoundingBoxTree
+from dolfin import BoundingBoxTree, WideBoundingBoxTree
 from dolfin import UnitIntervalMesh, UnitSquareMesh, UnitCubeMesh
 from dolfin import Point
 from dolfin import MeshEntity
 from dolfin import MPI
-from dolfin_utils.test import skip_in_parallel
+from dolfin_utils.test import skip_in_parallel, set_parameters_fixture
+
+
+num_threads = set_parameters_fixture("num_threads", [0, 3])
 
 
 #--- compute_collisions with point ---
@@ -481,3 +484,85 @@ def test_compute_closest_entity_3d():
     entity, distance = tree.compute_closest_entity(p)
     assert entity == reference[0]
     assert round(distance - reference[1], 7) == 0
+
+#--- batch queries with points ---
+
+@skip_in_parallel
+@pytest.mark.parametrize("mesh", [UnitIntervalMesh(16),
+                                  UnitSquareMesh(16, 16),
+                                  UnitCubeMesh(8, 8, 8)])
+def test_compute_first_entity_collisions(mesh, num_threads):
+
+    tree = BoundingBoxTree()
+    tree.build(mesh)
+
+    gdim = mesh.geometry().dim()
+    numpy.random.seed(1)
+    x = numpy.random.uniform(-0.1, 1.1, (100, gdim))
+    reference = [tree.compute_entity_collisions(Point(*p)) for p in x]
+
+    entities = tree.compute_first_entity_collisions(x)
+    assert len(entities) == len(x)
+    for e, ref in zip(entities, reference):
+        if ref:
+            assert e in ref
+        else:
+            assert e == numpy.iinfo(numpy.uint32).max
+
+    # Points must be given as rows of gdim coordinates
+    with pytest.raises(ValueError):
+        tree.compute_first_entity_collisions(x.flatten())
+
+
+@skip_in_parallel
+@pytest.mark.parametrize("mesh", [UnitSquareMesh(16, 16),
+                                  UnitCubeMesh(8, 8, 8)])
+def test_compute_closest_entities(mesh, num_threads):
+
+    tree = BoundingBoxTree()
+    tree.build(mesh)
+
+    gdim = mesh.geometry().dim()
+    numpy.random.seed(1)
+    x = numpy.random.uniform(-0.5, 1.5, (50, gdim))
+
+    entities, distances = tree.compute_closest_entities(x)
+    for p, e, r in zip(x, entities, distances):
+        entity, distance = tree.compute_closest_entity(Point(*p))
+        assert e == entity
+        assert round(r - distance, 7) == 0
+
+    # Points must be given as rows of gdim coordinates
+    with pytest.raises(ValueError):
+        tree.compute_closest_entities(x.flatten())
+    with pytest.raises(ValueError):
+        tree.compute_closest_entities(numpy.zeros((4, gdim + 1)))
+
+#--- WideBoundingBoxTree ---
+
+@skip_in_parallel
+@pytest.mark.parametrize("mesh", [UnitIntervalMesh(16),
+                                  UnitSquareMesh(16, 16),
+                                  UnitCubeMesh(8, 8, 8)])
+def test_wide_bounding_box_tree(mesh):
+
+    tree = BoundingBoxTree()
+    tree.build(mesh)
+    wide_tree = WideBoundingBoxTree()
+    wide_tree.build(mesh)
+    assert wide_tree.num_nodes() > 0
+
+    gdim = mesh.geometry().dim()
+    numpy.random.seed(1)
+    points = [Point(*x) for x in numpy.random.uniform(-0.1, 1.1, (50, gdim))]
+    points += [Point(*x) for x in mesh.coordinates()[::7]]
+    for p in points:
+        assert sorted(wide_tree.compute_collisions(p)) \
+            == sorted(tree.compute_collisions(p))
+        entities = tree.compute_entity_collisions(p)
+        assert sorted(wide_tree.compute_entity_collisions(p)) == sorted(entities)
+        if entities:
+            assert wide_tree.compute_first_entity_collision(p) in entities
+            assert wide_tree.collides_entity(p)
+        else:
+            assert not wide_tree.collides_entity(p)
@@ -195,6 +195,41 @@ def test_save_and_read_function(tempdir):
     assert len(result.get_local().nonzero()[0]) == 0
     hdf5_file.close()
 
+@skip_if_not_HDF5
+@xfail_with_serial_hdf5_in_parallel
+@pytest.mark.parametrize("compression", ["deflate", "shuffle_deflate"])
+def test_save_and_read_compressed(tempdir, compression):
+    mesh0 = UnitCubeMesh(8, 8, 8)
+    Q = FunctionSpace(mesh0, "CG", 2)
+    F0 = Function(Q)
+    F0.interpolate(Expression("x[0]", degree=1))
+
+    # Write uncompressed and compressed files. Compression of the
+    # function is set per group.
+    sizes = []
+    for i in range(2):
+        filename = os.path.join(tempdir, "compressed_%d.h5" % i)
+        with HDF5File(mesh0.mpi_comm(), filename, "w") as hdf5_file:
+            if i == 1:
+                hdf5_file.parameters["compression"] = compression
+                hdf5_file.set_compression("/function", compression, 9)
+            hdf5_file.write(mesh0, "/mesh")
+            hdf5_file.write(F0, "/function")
+        sizes.append(os.path.getsize(filename))
+    assert sizes[1] < sizes[0]
+
+    # Read back from compressed file
+    mesh1 = Mesh()
+    with HDF5File(mesh0.mpi_comm(), filename, "r") as hdf5_file:
+        hdf5_file.read(mesh1, "/mesh", False)
+        F1 = Function(Q)
+        hdf5_file.read(F1, "/function")
+
+    assert mesh0.num_entities_global(0) == mesh1.num_entities_global(0)
+    assert mesh0.num_entities_global(3) == mesh1.num_entities_global(3)
+    assert (F0.vector() - F1.vector()).norm("l1") == 0.0
+
+
 @skip_if_not_HDF5
 @xfail_with_serial_hdf5_in_parallel
 def test_save_and_read_mesh_2D(tempdir):
@@ -337,6 +337,60 @@ def test_save_3d_vector_series(tempdir, encoding):
         file.write(u, 0.3, encoding)
 
 
+def test_save_3d_vector_series_asynchronous(tempdir):
+    encoding = XDMFFile.Encoding.HDF5
+    if invalid_config(encoding):
+        pytest.skip("XDMF unsupported in current configuration")
+    mesh = UnitCubeMesh(4, 4, 4)
+    u = Function(VectorFunctionSpace(mesh, "Lagrange", 2))
+
+    xml = []
+    for asynchronous in (False, True):
+        filename = os.path.join(tempdir, "u_3D_async_%d.xdmf" % asynchronous)
+        with XDMFFile(mesh.mpi_comm(), filename) as file:
+            file.parameters["asynchronous_output"] = asynchronous
+            file.parameters["flush_output"] = True
+            for t in (0.1, 0.2, 0.3):
+                u.vector()[:] = t
+                file.write(u, t, encoding)
+            file.wait()
+
+        if MPI.rank(mesh.mpi_comm()) == 0:
+            with open(filename) as f:
+                xml.append(f.read().replace("u_3D_async_%d" % asynchronous,
+                                            "u_3D_async"))
+
+    if MPI.rank(mesh.mpi_comm()) == 0:
+        assert xml[0] == xml[1]
+
+
+def test_save_scalar_series_asynchronous_data(tempdir):
+    """Check that an asynchronous write stores the values at the time
+    of the call to write, not values set afterwards"""
+    encoding = XDMFFile.Encoding.HDF5
+    if invalid_config(encoding):
+        pytest.skip("XDMF unsupported in current configuration")
+    mesh = UnitSquareMesh(8, 8)
+    u = Function(FunctionSpace(mesh, "Lagrange", 1))
+
+    filename = os.path.join(tempdir, "u_async_data.xdmf")
+    times = (0.1, 0.2, 0.3)
+    with XDMFFile(mesh.mpi_comm(), filename) as file:
+        file.parameters["asynchronous_output"] = True
+        for t in times:
+            u.vector()[:] = t
+            file.write(u, t, encoding)
+            u.vector()[:] = -1.0
+
+    with HDF5File(mesh.mpi_comm(), filename.replace(".xdmf", ".h5"), "r") as h5file:
+        for i, t in enumerate(times):
+            x = Vector()
+            h5file.read(x, "/VisualisationVector/%d" % i, False)
+            assert x.size() == mesh.num_entities_global(0)
+            assert round(x.min() - t, 12) == 0
+            assert round(x.max() - t, 12) == 0
+
+
 @pytest.mark.parametrize("encoding", encodings)
 def test_save_2d_tensor(tempdir, encoding):
     if invalid_config(encoding):
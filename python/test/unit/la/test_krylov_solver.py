@@ -250,3 +250,42 @@ def test_krylov_tpetra():
 
     # Number of iterations should be around 15
     assert n_iter < 50
+
+
+@skip_in_parallel
+def test_krylov_mixed_precision(pushpop_parameters):
+    "Test mixed precision iterative refinement with the Eigen backend"
+    parameters["linear_algebra_backend"] = "Eigen"
+
+    mesh = UnitSquareMesh(32, 32)
+    V = FunctionSpace(mesh, "Lagrange", 1)
+    bc = DirichletBC(V, Constant(0.0), lambda x, on_boundary: on_boundary)
+    u, v = TrialFunction(V), TestFunction(V)
+    A, b = assemble_system(inner(grad(u), grad(v))*dx, Constant(1.0)*v*dx, bc)
+
+    # Reference solution in double precision
+    solver = KrylovSolver("cg", "jacobi")
+    solver.parameters["relative_tolerance"] = 1.0e-12
+    solver.set_operator(A)
+    x_ref = Vector()
+    solver.solve(x_ref, b)
+
+    # Mixed precision solve reaches the same (double precision)
+    # tolerance
+    solver.parameters["precision"] = "mixed"
+    x = Vector()
+    num_iter = solver.solve(x, b)
+    assert num_iter > 0
+
+    r = b - A*x
+    assert r.norm("l2") < 1.0e-10*b.norm("l2")
+    x -= x_ref
+    assert x.norm("l2") < 1.0e-8*x_ref.norm("l2")
+
+    # In-place changes to the operator are used by the next solve
+    A *= 2.0
+    x = Vector()
+    solver.solve(x, b)
+    x *= 2.0
+    x -= x_ref
+    assert x.norm("l2") < 1.0e-8*x_ref.norm("l2")
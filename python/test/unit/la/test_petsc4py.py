@@ -18,6 +18,8 @@
 # along with DOLFIN. If not, see <http://www.gnu.org/licenses/>.
 
 import gc
+import numpy
+import pytest
 from dolfin import (UnitSquareMesh, TrialFunction, TestFunction,
                     FunctionSpace, Function, assemble, dx,
                     parameters, as_backend_type, has_petsc)
@@ -99,3 +101,39 @@ def test_ref_count(pushpop_parameters):
     # Check incref
     vec = PETScVector(x)
     assert x.refcount == 2
+
+
+@skip_if_not_petsc4py
+@pytest.mark.parametrize("communication", ["neighbourhood", "petsc"])
+def test_ghost_update(communication, pushpop_parameters):
+    "Test update of ghost entries with split begin/end calls"
+    parameters["linear_algebra_backend"] = "PETSc"
+    parameters["ghost_update_communication"] = communication
+
+    mesh = UnitSquareMesh(8, 8)
+    V = FunctionSpace(mesh, "P", 2)
+    u = Function(V)
+    x = as_backend_type(u.vector())
+
+    # Set owned entries to their global index
+    r0, r1 = x.local_range()
+    x.set_local(numpy.arange(r0, r1, dtype=numpy.float64))
+    x.apply("insert")
+
+    # Ghost entries should hold the global index after update
+    local_to_global = V.dofmap().tabulate_local_to_global_dofs()
+    with x.vec().localForm() as lf:
+        assert (lf.array == local_to_global).all()
+
+    # Split update, modifying a copy in between
+    y = as_backend_type(x.copy())
+    y.vec().scale(2.0)
+    y.update_ghost_values_begin()
+    y.update_ghost_values_end()
+    with y.vec().localForm() as lf:
+        assert (lf.array == 2.0*local_to_global).all()
+
+    # Owners of ghost entries are neighbours of the index map
+    index_map = V.dofmap().index_map()
+    neighbours = set(index_map.neighbours())
+    assert set(index_map.off_process_owner()) <= neighbours
@@ -164,3 +164,88 @@ def test_insert_local_global(mesh, V):
             assert nnz_d[local_row] == (nnz_on_diagonal if local_row in primary_dim_local_entries else 0)
         else:
             assert nnz_od[local_row] == (nnz_off_diagonal if local_row in primary_dim_local_entries else 0)
+
+
+def test_build_threaded(mesh, pushpop_parameters):
+    V = VectorFunctionSpace(mesh, "CG", 3)
+    dm = V.dofmap()
+    index_map = dm.index_map()
+
+    def build():
+        tl = TensorLayout(mesh.mpi_comm(), 0, TensorLayout.Sparsity.SPARSE)
+        tl.init([index_map, index_map], TensorLayout.Ghosts.UNGHOSTED)
+        sp = tl.sparsity_pattern()
+        sp.init([index_map, index_map])
+        SparsityPatternBuilder.build(sp, mesh, [dm, dm],
+                                     True, False, False, False,
+                                     False, init=False, finalize=True)
+        return sp
+
+    sp0 = build()
+    assert sp0.peak_memory_usage() > 0
+    assert sp0.num_nonzeros() > 0
+
+    if has_openmp():
+        parameters["num_threads"] = 3
+        sp1 = build()
+        assert sp1.num_nonzeros() == sp0.num_nonzeros()
+        assert (sp1.num_nonzeros_diagonal() == sp0.num_nonzeros_diagonal()).all()
+        assert (sp1.num_nonzeros_off_diagonal() == sp0.num_nonzeros_off_diagonal()).all()
+        assert sp1.str(False) == sp0.str(False)
+
+
+@pytest.mark.parametrize("family, degree", [("CG", 1), ("CG", 3),
+                                            ("DG", 1), ("N1curl", 2)])
+def test_build_from_topology(mesh, family, degree, pushpop_parameters):
+    V = FunctionSpace(mesh, family, degree)
+    dm = V.dofmap()
+    index_map = dm.index_map()
+
+    def build():
+        tl = TensorLayout(mesh.mpi_comm(), 0, TensorLayout.Sparsity.SPARSE)
+        tl.init([index_map, index_map], TensorLayout.Ghosts.UNGHOSTED)
+        sp = tl.sparsity_pattern()
+        sp.init([index_map, index_map])
+        SparsityPatternBuilder.build(sp, mesh, [dm, dm],
+                                     True, False, False, False,
+                                     False, init=False, finalize=True)
+        return sp
+
+    parameters["sparsity_pattern_method"] = "insert"
+    sp0 = build()
+    parameters["sparsity_pattern_method"] = "topology"
+    sp1 = build()
+
+    assert sp1.num_nonzeros() == sp0.num_nonzeros()
+    assert (sp1.num_nonzeros_diagonal() == sp0.num_nonzeros_diagonal()).all()
+    assert (sp1.num_nonzeros_off_diagonal() == sp0.num_nonzeros_off_diagonal()).all()
+    assert sp1.str(False) == sp0.str(False)
+
+
+@pytest.mark.parametrize("method", ["insert", "topology"])
+def test_build_blocked(mesh, method, pushpop_parameters):
+    V = VectorFunctionSpace(mesh, "CG", 2)
+    dm = V.dofmap()
+    index_map = dm.index_map()
+    parameters["sparsity_pattern_method"] = method
+
+    def build():
+        tl = TensorLayout(mesh.mpi_comm(), 0, TensorLayout.Sparsity.SPARSE)
+        tl.init([index_map, index_map], TensorLayout.Ghosts.UNGHOSTED)
+        sp = tl.sparsity_pattern()
+        SparsityPatternBuilder.build(sp, mesh, [dm, dm],
+                                     True, False, False, False,
+                                     False, init=True, finalize=True)
+        return sp
+
+    sp0 = build()
+    assert sp0.block_size() == 1
+    parameters["matrix_block_storage"] = "block"
+    sp1 = build()
+    assert sp1.block_size() == 2
+
+    # Blocked pattern expands to the scalar pattern, with less memory
+    assert sp1.num_nonzeros() == sp0.num_nonzeros()
+    assert (sp1.num_nonzeros_diagonal() == sp0.num_nonzeros_diagonal()).all()
+    assert (sp1.num_nonzeros_off_diagonal() == sp0.num_nonzeros_off_diagonal()).all()
+    assert sp1.peak_memory_usage() < sp0.peak_memory_usage()
@@ -27,7 +27,7 @@ import FIAT
 from dolfin import *
 from dolfin_utils.test import fixture, set_parameters_fixture
 from dolfin_utils.test import skip_in_parallel, xfail_in_parallel
-from dolfin_utils.test import cd_tempdir
+from dolfin_utils.test import cd_tempdir, pushpop_parameters
 
 
 @fixture
@@ -268,6 +268,132 @@ def test_P_RefineUnitCubeMesh():
     assert all(mesh.coordinates()[e_idx,:] == coord)
 
 
+def test_packed_coordinate_dofs():
+    mesh = UnitCubeMesh(3, 4, 5)
+    tdim = mesh.topology().dim()
+    geometry = mesh.geometry()
+    assert not geometry.has_packed_coordinate_dofs()
+
+    geometry.init_packed_coordinate_dofs(mesh.topology())
+    assert geometry.has_packed_coordinate_dofs()
+    assert geometry.packed_coordinate_dofs_memory() \
+        >= mesh.num_cells()*(tdim + 1)*geometry.dim()*8
+    for cell in cells(mesh):
+        x = geometry.packed_coordinate_dofs(cell.index())
+        assert numpy.array_equal(x, cell.get_vertex_coordinates())
+
+    # Packed coordinate dofs are invalid once the coordinates have
+    # been modified
+    count = geometry.modification_count()
+    mesh.translate(Point(1.0, 0.0, 0.0))
+    assert geometry.modification_count() != count
+    assert not geometry.has_packed_coordinate_dofs()
+
+    geometry.init_packed_coordinate_dofs(mesh.topology())
+    assert geometry.has_packed_coordinate_dofs()
+    x = mesh.coordinates()
+    assert not geometry.has_packed_coordinate_dofs()
+    x[:] *= 2.0
+    geometry.init_packed_coordinate_dofs(mesh.topology())
+    for cell in cells(mesh):
+        x = geometry.packed_coordinate_dofs(cell.index())
+        assert numpy.array_equal(x, cell.get_vertex_coordinates())
+
+    # Packed coordinates are not supported for higher-order geometry
+    mesh = p_refine(UnitSquareMesh(2, 2))
+    with pytest.raises(RuntimeError):
+        mesh.geometry().init_packed_coordinate_dofs(mesh.topology())
+
+
+num_threads = set_parameters_fixture("num_threads", [0, 3])
+
+
+def entity_connectivity(mesh):
+    "Return cell-entity and entity-vertex connectivity and ghost offsets"
+    tdim = mesh.topology().dim()
+    connectivity = []
+    for d in range(1, tdim):
+        mesh.init(d)
+        connectivity += [numpy.array(mesh.topology()(tdim, d)()),
+                         numpy.array(mesh.topology()(d, 0)()),
+                         mesh.topology().ghost_offset(d)]
+    return connectivity
+
+
+def transpose_connectivity(mesh):
+    "Return entity-cell connectivity, computed from the transpose"
+    tdim = mesh.topology().dim()
+    connectivity = []
+    for d in range(tdim):
+        mesh.init(d, tdim)
+        c = mesh.topology()(d, tdim)
+        connectivity += [numpy.array(c(e)) for e in range(mesh.num_entities(d))]
+    return connectivity
+
+
+@pytest.mark.parametrize("create_mesh", [lambda: UnitSquareMesh(7, 5),
+                                         lambda: UnitCubeMesh(4, 3, 5)])
+@pytest.mark.parametrize("compute_connectivity", [entity_connectivity,
+                                                  transpose_connectivity])
+def test_compute_connectivity_threaded(create_mesh, compute_connectivity,
+                                       num_threads):
+    "Connectivity computed with threads matches the serial computation"
+    connectivity = compute_connectivity(create_mesh())
+
+    parameters["num_threads"] = 0
+    reference = compute_connectivity(create_mesh())
+
+    assert len(connectivity) == len(reference)
+    for a, b in zip(connectivity, reference):
+        assert numpy.array_equal(a, b)
+
+
+@skip_in_parallel
+def test_renumber_by_hilbert_curve():
+    mesh = UnitCubeMesh(6, 5, 4)
+    new_mesh = mesh.renumber_by_hilbert_curve()
+    assert new_mesh.num_cells() == mesh.num_cells()
+    assert new_mesh.num_vertices() == mesh.num_vertices()
+    assert round(sum(c.volume() for c in cells(new_mesh)) - 1.0, 10) == 0
+    assert numpy.array_equal(numpy.sort(new_mesh.coordinates(), axis=0),
+                             numpy.sort(mesh.coordinates(), axis=0))
+
+    # Vertices are numbered in the order they are visited by the cells
+    num_visited = 0
+    for cell in cells(new_mesh):
+        v = cell.entities(0)
+        assert max(v) < num_visited + len(v)
+        num_visited = max(num_visited, max(v) + 1)
+
+    # Consecutive cells are neighbours along the curve
+    midpoints = numpy.array([c.midpoint().array() for c in cells(new_mesh)])
+    steps = numpy.linalg.norm(numpy.diff(midpoints, axis=0), axis=1)
+    assert numpy.max(steps) < 0.5
+
+
+def test_reorder_mesh_hilbert(pushpop_parameters):
+    def mean_midpoint_step(mesh):
+        midpoints = numpy.array([c.midpoint().array() for c in cells(mesh)])
+        return numpy.mean(numpy.linalg.norm(numpy.diff(midpoints, axis=0),
+                                            axis=1))
+
+    for ghost_mode in ("none", "shared_facet", "shared_vertex"):
+        parameters["ghost_mode"] = ghost_mode
+        parameters["reorder_mesh_hilbert"] = False
+        step = mean_midpoint_step(UnitCubeMesh(6, 5, 4))
+
+        parameters["reorder_mesh_hilbert"] = True
+        mesh = UnitCubeMesh(6, 5, 4)
+        assert mesh.num_entities_global(3) == 6*5*4*6
+        assert mesh.num_entities_global(0) == 7*6*5
+        volume = sum(c.volume() for c in cells(mesh))
+        assert round(MPI.sum(mesh.mpi_comm(), volume) - 1.0, 10) == 0
+
+        # Consecutive cells are closer on average than in the default
+        # ordering
+        assert mean_midpoint_step(mesh) < step
+
+
 def test_BoundaryComputation():
     """Compute boundary of mesh."""
     mesh = UnitCubeMesh(2, 2, 2)
@@ -711,6 +837,23 @@ def test_mesh_topology_reference():
     assert mesh.topology().id() == mesh.topology().id()
 
 
+def test_mesh_topology_modification_count():
+    """Check that the topology modification count changes when the
+    topology is reordered or copied, but not when entities are
+    computed"""
+    mesh = UnitSquareMesh(4, 4)
+    count = mesh.topology().modification_count()
+    mesh.init(1)
+    assert mesh.topology().modification_count() == count
+
+    mesh.order()
+    assert mesh.topology().modification_count() != count
+
+    count = mesh.topology().modification_count()
+    assert Mesh(mesh).topology().modification_count() != count
+    assert mesh.topology().modification_count() == count
+
+
 def test_mesh_topology_lifetime():
     """Check that lifetime of Mesh.topology() is bound to
     underlying mesh object"""
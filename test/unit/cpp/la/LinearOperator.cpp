@@ -111,5 +111,60 @@ TEST_CASE("Testing LinearOperator", "[linear_operator]")
       CHECK(norm_ref == Approx(norm_action));
     }
   }
+
+  SECTION("using matrix-free operator")
+  {
+    // Check whether backend is available
+    if (!has_linear_algebra_backend("PETSc"))
+      return;
+    parameters["linear_algebra_backend"] = "PETSc";
+
+    // Assemble matrix and right-hand side
+    auto mesh = std::make_shared<UnitSquareMesh>(8, 8);
+    auto V = std::make_shared<ReactionDiffusion::FunctionSpace>(mesh);
+    auto a = std::make_shared<ReactionDiffusion::BilinearForm>(V, V);
+    ReactionDiffusion::LinearForm L(V);
+    auto f = std::make_shared<Constant>(1.0);
+    L.f = f;
+    Matrix A;
+    Vector b;
+    assemble(A, *a);
+    assemble(b, L);
+
+    // Create matrix-free operator
+    auto a_action = std::make_shared<ReactionDiffusionAction::LinearForm>(V);
+    auto u = std::make_shared<Function>(V);
+    a_action->u = u;
+    MatrixFreeOperator O(a_action, u, a);
+    CHECK(O.size(0) == A.size(0));
+    CHECK(O.size(1) == A.size(1));
+
+    // Compare products
+    Vector x(b), y, z;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      x *= 2.0;
+      A.mult(x, y);
+      O.mult(x, z);
+      z -= y;
+      CHECK(z.norm("linf") < 1.0e-12*y.norm("linf"));
+    }
+
+    // Compare diagonals
+    Vector d_ref, d;
+    A.init_vector(d_ref, 0);
+    A.get_diagonal(d_ref);
+    O.get_diagonal(d);
+    d -= d_ref;
+    CHECK(d.norm("linf") < 1.0e-12*d_ref.norm("linf"));
+
+    // Solve with Jacobi preconditioned CG
+    Vector x_ref, x_mf;
+    solve(A, x_ref, b, "cg", "jacobi");
+    PETScKrylovSolver solver("cg", "jacobi");
+    solver.parameters["relative_tolerance"] = 1.0e-12;
+    solver.solve(O, x_mf, b);
+    CHECK(norm(x_ref, "l2") == Approx(norm(x_mf, "l2")));
+  }
 }
 //-----------------------------------------------------------------------------
@@ -162,4 +162,47 @@ TEST_CASE("MeshValueCollections")
         CHECK(25 == g.get_value(cell->index(), i));
     }
   }
+
+  SECTION("Test bulk set values 2D facets")
+  {
+    auto mesh = std::make_shared<UnitSquareMesh>(3, 3);
+    mesh->init(2, 1);
+    const std::size_t ncells = mesh->num_cells();
+
+    // Insert values in reverse order, with repeated entities
+    std::vector<std::size_t> cells, local_entities;
+    std::vector<int> values;
+    for (std::size_t c = ncells; c-- > 0;)
+    {
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        cells.insert(cells.end(), {c, c});
+        local_entities.insert(local_entities.end(), {i, i});
+        values.insert(values.end(), {-1, (int) (c + i)});
+      }
+    }
+    MeshValueCollection<int> f(mesh, 1);
+    f.set_value(0, 0, -2);
+    f.set_values(cells, local_entities, values);
+    CHECK(ncells*3 == f.size());
+    for (std::size_t c = 0; c < ncells; ++c)
+    {
+      for (std::size_t i = 0; i < 3; ++i)
+        CHECK((int) (c + i) == f.get_value(c, i));
+    }
+
+    // Values are sorted by position
+    const auto& f_values = f.values();
+    CHECK(std::is_sorted(f_values.begin(), f_values.end()));
+
+    // Convert to MeshFunction and back
+    MeshFunction<int> g(mesh, f);
+    MeshValueCollection<int> h(g);
+    for (std::size_t c = 0; c < ncells; ++c)
+    {
+      const Cell cell(*mesh, c);
+      for (std::size_t i = 0; i < 3; ++i)
+        CHECK(g[cell.entities(1)[i]] == h.get_value(c, i));
+    }
+  }
 }